@@ -10,6 +10,13 @@ if(NOT "${CMAKE_PROJECT_NAME}" STREQUAL "${PROJECT_NAME}")
 endif()
 
 option(IMATH_HALF_USE_LOOKUP_TABLE "Convert half-to-float using a lookup table (on by default)" ON)
+option(IMATH_HALF_USE_COMPACT_LOOKUP_TABLE "Convert half-to-float using a compact 8KB lookup table instead of the full 256KB one" OFF)
+
+# Host executable of src/Imath/toFloat.cpp, which generates the
+# half-to-float lookup tables at build time. Only needed when
+# cross-compiling without CMAKE_CROSSCOMPILING_EMULATOR; by default the
+# generator is built along with the library.
+set(IMATH_TOFLOAT_GENERATOR "" CACHE FILEPATH "Host toFloat executable to generate the half-to-float lookup tables")
 
 option(IMATH_USE_DEFAULT_VISIBILITY "Makes the compile use default visibility (by default compiles tidy, hidden-by-default)"     OFF)
 
@@ -20,6 +27,11 @@ option(IMATH_ENABLE_LARGE_STACK "Enables code to take advantage of large stack s
 # Option to make it possible to build without the noexcept specifier
 option(IMATH_USE_NOEXCEPT "Compile with noexcept specifier" ON)
 
+# Lets the IMATH_SIMD_LEVEL environment variable cap the instruction
+# sets used by the kernels selected at run time, so the tests can run
+# the kernels for older processors. Not for production builds.
+option(IMATH_ENABLE_SIMD_LEVEL_OVERRIDE "Let the IMATH_SIMD_LEVEL environment variable cap the run-time SIMD level (for testing)" OFF)
+
 # What C++ standard to compile for.  VFX Platform 18 is c++14, so
 # that's the default.
 set(tmp 14)
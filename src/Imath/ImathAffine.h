@@ -0,0 +1,736 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+//
+// 3D affine transformation class template
+//
+
+#ifndef INCLUDED_IMATHAFFINE_H
+#define INCLUDED_IMATHAFFINE_H
+
+#include "ImathExport.h"
+#include "ImathNamespace.h"
+
+#include "ImathFun.h"
+#include "ImathMatrix.h"
+#include "ImathVec.h"
+
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+///
+/// The `Affine3` class template represents a 3D affine transformation:
+/// a Matrix44 whose last column is `(0 0 0 1)`, stored without that
+/// column. Its four rows of three elements are the rows of a
+/// 3x3 linear transformation followed by a translation:
+///
+///     x[0][0] x[0][1] x[0][2] (0)
+///     x[1][0] x[1][1] x[1][2] (0)
+///     x[2][0] x[2][1] x[2][2] (0)
+///     x[3][0] x[3][1] x[3][2] (1)
+///
+/// As with Matrix44, vectors are row vectors and multiply the matrix
+/// from the left, and `a * b` applies `a` first, then `b`.
+///
+/// An Affine3 takes three quarters of the memory of a Matrix44, and
+/// its products, inverses and transformations skip the work of the
+/// constant column. Their results are the same as those of the
+/// corresponding Matrix44 operations on affine matrices.
+///
+
+template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Affine3
+{
+public:
+    using value_type = T;
+
+    /// @{
+    /// @name Direct access to elements
+
+    /// Matrix elements
+    T x[4][3];
+
+    /// @}
+
+    /// Row access
+    IMATH_HOSTDEVICE T* operator[] (int i) IMATH_NOEXCEPT;
+
+    /// Row access
+    IMATH_HOSTDEVICE const T* operator[] (int i) const IMATH_NOEXCEPT;
+
+    /// @{
+    ///	@name Constructors and Assignment
+
+    /// Uninitialized
+    IMATH_HOSTDEVICE constexpr Affine3 (Uninitialized) IMATH_NOEXCEPT {}
+
+    /// Default constructor: initialize to identity
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Affine3 () IMATH_NOEXCEPT;
+
+    /// Construct from a 3x3 linear transformation and a translation
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14
+    Affine3 (const Matrix33<T>& l, const Vec3<T>& t) IMATH_NOEXCEPT;
+
+    /// Construct from the first three columns of a Matrix44. The last
+    /// column is ignored.
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 explicit Affine3 (const Matrix44<T>& m)
+        IMATH_NOEXCEPT;
+
+    /// Construct from Affine3 of another base type
+    template <class S>
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 explicit Affine3 (const Affine3<S>& a)
+        IMATH_NOEXCEPT;
+
+    /// @}
+
+    /// @{
+    /// @name Conversion
+
+    /// Return the equivalent Matrix44
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Matrix44<T>
+    toMatrix44 () const IMATH_NOEXCEPT;
+
+    /// Return the 3x3 linear part
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Matrix33<T>
+    linear () const IMATH_NOEXCEPT;
+
+    /// Set the 3x3 linear part
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 const Affine3&
+    setLinear (const Matrix33<T>& l) IMATH_NOEXCEPT;
+
+    /// Return the translation
+    IMATH_HOSTDEVICE constexpr Vec3<T> translation () const IMATH_NOEXCEPT;
+
+    /// Set the translation, leaving the linear part unchanged
+    template <class S>
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 const Affine3&
+    setTranslation (const Vec3<S>& t) IMATH_NOEXCEPT;
+
+    /// @}
+
+    /// @{
+    /// @name Compatibility with Sb
+
+    /// Return a raw pointer to the array of values
+    IMATH_HOSTDEVICE T* getValue () IMATH_NOEXCEPT;
+
+    /// Return a raw pointer to the array of values
+    IMATH_HOSTDEVICE const T* getValue () const IMATH_NOEXCEPT;
+
+    /// @}
+
+    /// @{
+    /// @name Arithmetic and Comparison
+
+    /// Equality
+    IMATH_HOSTDEVICE constexpr bool
+    operator== (const Affine3& v) const IMATH_NOEXCEPT;
+
+    /// Inequality
+    IMATH_HOSTDEVICE constexpr bool
+    operator!= (const Affine3& v) const IMATH_NOEXCEPT;
+
+    /// Compare two matrices and test if they are "approximately equal":
+    /// @return True if the coefficients of this and `m` are the same
+    /// with an absolute error of no more than e, i.e., for all i, j:
+    ///
+    ///     abs (this[i][j] - m[i][j]) <= e
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 bool
+    equalWithAbsError (const Affine3& v, T e) const IMATH_NOEXCEPT;
+
+    /// Compare two matrices and test if they are "approximately equal":
+    /// @return True if the coefficients of this and m are the same with
+    /// a relative error of no more than e, i.e., for all i, j:
+    ///
+    ///     abs (this[i][j] - v[i][j]) <= e * abs (this[i][j])
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 bool
+    equalWithRelError (const Affine3& v, T e) const IMATH_NOEXCEPT;
+
+    /// Matrix multiplication: a *= b
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 const Affine3&
+    operator*= (const Affine3& v) IMATH_NOEXCEPT;
+
+    /// Matrix multiplication: c = a * b
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Affine3
+    operator* (const Affine3& v) const IMATH_NOEXCEPT;
+
+    /// Transform a point, as by Matrix44::multVecMatrix(): multiply
+    /// `src` by the linear part and add the translation.
+    /// @param[in] src The input point
+    /// @param[out] dst The output point
+    template <class S>
+    IMATH_HOSTDEVICE void
+    multVecMatrix (const Vec3<S>& src, Vec3<S>& dst) const IMATH_NOEXCEPT;
+
+    /// Transform a direction, as by Matrix44::multDirMatrix(): multiply
+    /// `src` by the linear part, ignoring the translation.
+    /// @param[in] src The input direction
+    /// @param[out] dst The output direction
+    template <class S>
+    IMATH_HOSTDEVICE void
+    multDirMatrix (const Vec3<S>& src, Vec3<S>& dst) const IMATH_NOEXCEPT;
+
+    /// @}
+
+    /// @{
+    /// @name Manipulation
+
+    /// Set to the identity
+    IMATH_HOSTDEVICE void makeIdentity () IMATH_NOEXCEPT;
+
+    /// Invert in place, as by Matrix44::invert().
+    /// @param singExc If true, throw an exception if the matrix cannot be inverted.
+    /// @return const reference to this
+    IMATH_CONSTEXPR14 const Affine3& invert (bool singExc);
+
+    /// Invert in place, as by Matrix44::invert().
+    /// @return const reference to this
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 const Affine3& invert () IMATH_NOEXCEPT;
+
+    /// Return the inverse, leaving this unmodified. The result is the
+    /// same as that of Matrix44::inverse() for the equivalent Matrix44.
+    /// @param singExc If true, throw an exception if the matrix cannot be inverted.
+    IMATH_CONSTEXPR14 Affine3 inverse (bool singExc) const;
+
+    /// Return the inverse, leaving this unmodified. The result is the
+    /// same as that of Matrix44::inverse() for the equivalent Matrix44.
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Affine3 inverse () const IMATH_NOEXCEPT;
+
+    /// Return the determinant of the linear part, which is also the
+    /// determinant of the equivalent Matrix44
+    IMATH_HOSTDEVICE constexpr T determinant () const IMATH_NOEXCEPT;
+
+    /// Scale the matrix by s, as by Matrix44::scale()
+    /// @return const reference to this
+    template <class S>
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 const Affine3&
+    scale (const Vec3<S>& s) IMATH_NOEXCEPT;
+
+    /// Translate the matrix by t, as by Matrix44::translate()
+    /// @return const reference to this
+    template <class S>
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 const Affine3&
+    translate (const Vec3<S>& t) IMATH_NOEXCEPT;
+
+    /// @}
+
+    /// The base type: In templates that accept a parameter `V` (could
+    /// be a Color4), you can refer to `T` as `V::BaseType`
+    typedef T BaseType;
+
+    /// The base vector type
+    typedef Vec3<T> BaseVecType;
+};
+
+/// Stream output, as a Matrix44 without its last column
+template <class T>
+std::ostream& operator<< (std::ostream& s, const Affine3<T>& m);
+
+/// Point transformation: v *= m
+template <class S, class T>
+IMATH_HOSTDEVICE inline const Vec3<S>&
+operator*= (Vec3<S>& v, const Affine3<T>& m) IMATH_NOEXCEPT;
+
+/// Point transformation: r = v * m
+template <class S, class T>
+IMATH_HOSTDEVICE inline Vec3<S>
+operator* (const Vec3<S>& v, const Affine3<T>& m) IMATH_NOEXCEPT;
+
+/// Affine transformation of type float
+typedef Affine3<float> Affine3f;
+
+/// Affine transformation of type double
+typedef Affine3<double> Affine3d;
+
+//---------------------------
+// Implementation of Affine3
+//---------------------------
+
+template <class T>
+IMATH_HOSTDEVICE inline T*
+Affine3<T>::operator[] (int i) IMATH_NOEXCEPT
+{
+    return x[i];
+}
+
+template <class T>
+IMATH_HOSTDEVICE inline const T*
+Affine3<T>::operator[] (int i) const IMATH_NOEXCEPT
+{
+    return x[i];
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline Affine3<T>::Affine3 () IMATH_NOEXCEPT
+    : x{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}, {0, 0, 0}}
+{}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline Affine3<T>::Affine3 (
+    const Matrix33<T>& l, const Vec3<T>& t) IMATH_NOEXCEPT
+    : x{{l.x[0][0], l.x[0][1], l.x[0][2]},
+        {l.x[1][0], l.x[1][1], l.x[1][2]},
+        {l.x[2][0], l.x[2][1], l.x[2][2]},
+        {t.x, t.y, t.z}}
+{}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline Affine3<T>::Affine3 (
+    const Matrix44<T>& m) IMATH_NOEXCEPT
+    : x{{m.x[0][0], m.x[0][1], m.x[0][2]},
+        {m.x[1][0], m.x[1][1], m.x[1][2]},
+        {m.x[2][0], m.x[2][1], m.x[2][2]},
+        {m.x[3][0], m.x[3][1], m.x[3][2]}}
+{}
+
+template <class T>
+template <class S>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline Affine3<T>::Affine3 (
+    const Affine3<S>& a) IMATH_NOEXCEPT
+    : x{{T (a.x[0][0]), T (a.x[0][1]), T (a.x[0][2])},
+        {T (a.x[1][0]), T (a.x[1][1]), T (a.x[1][2])},
+        {T (a.x[2][0]), T (a.x[2][1]), T (a.x[2][2])},
+        {T (a.x[3][0]), T (a.x[3][1]), T (a.x[3][2])}}
+{}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline Matrix44<T>
+Affine3<T>::toMatrix44 () const IMATH_NOEXCEPT
+{
+    return Matrix44<T> (
+        x[0][0],
+        x[0][1],
+        x[0][2],
+        0,
+        x[1][0],
+        x[1][1],
+        x[1][2],
+        0,
+        x[2][0],
+        x[2][1],
+        x[2][2],
+        0,
+        x[3][0],
+        x[3][1],
+        x[3][2],
+        1);
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline Matrix33<T>
+Affine3<T>::linear () const IMATH_NOEXCEPT
+{
+    return Matrix33<T> (
+        x[0][0],
+        x[0][1],
+        x[0][2],
+        x[1][0],
+        x[1][1],
+        x[1][2],
+        x[2][0],
+        x[2][1],
+        x[2][2]);
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline const Affine3<T>&
+Affine3<T>::setLinear (const Matrix33<T>& l) IMATH_NOEXCEPT
+{
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            x[i][j] = l.x[i][j];
+
+    return *this;
+}
+
+template <class T>
+IMATH_HOSTDEVICE constexpr inline Vec3<T>
+Affine3<T>::translation () const IMATH_NOEXCEPT
+{
+    return Vec3<T> (x[3][0], x[3][1], x[3][2]);
+}
+
+template <class T>
+template <class S>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline const Affine3<T>&
+Affine3<T>::setTranslation (const Vec3<S>& t) IMATH_NOEXCEPT
+{
+    x[3][0] = t.x;
+    x[3][1] = t.y;
+    x[3][2] = t.z;
+
+    return *this;
+}
+
+template <class T>
+IMATH_HOSTDEVICE inline T*
+Affine3<T>::getValue () IMATH_NOEXCEPT
+{
+    return (T*) &x[0][0];
+}
+
+template <class T>
+IMATH_HOSTDEVICE inline const T*
+Affine3<T>::getValue () const IMATH_NOEXCEPT
+{
+    return (const T*) &x[0][0];
+}
+
+template <class T>
+IMATH_HOSTDEVICE constexpr inline bool
+Affine3<T>::operator== (const Affine3& v) const IMATH_NOEXCEPT
+{
+    return x[0][0] == v.x[0][0] && x[0][1] == v.x[0][1] &&
+           x[0][2] == v.x[0][2] && x[1][0] == v.x[1][0] &&
+           x[1][1] == v.x[1][1] && x[1][2] == v.x[1][2] &&
+           x[2][0] == v.x[2][0] && x[2][1] == v.x[2][1] &&
+           x[2][2] == v.x[2][2] && x[3][0] == v.x[3][0] &&
+           x[3][1] == v.x[3][1] && x[3][2] == v.x[3][2];
+}
+
+template <class T>
+IMATH_HOSTDEVICE constexpr inline bool
+Affine3<T>::operator!= (const Affine3& v) const IMATH_NOEXCEPT
+{
+    return !(*this == v);
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline bool
+Affine3<T>::equalWithAbsError (const Affine3<T>& m, T e) const IMATH_NOEXCEPT
+{
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 3; j++)
+            if (!IMATH_INTERNAL_NAMESPACE::equalWithAbsError (
+                    (*this).x[i][j], m.x[i][j], e))
+                return false;
+
+    return true;
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline bool
+Affine3<T>::equalWithRelError (const Affine3<T>& m, T e) const IMATH_NOEXCEPT
+{
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 3; j++)
+            if (!IMATH_INTERNAL_NAMESPACE::equalWithRelError (
+                    (*this).x[i][j], m.x[i][j], e))
+                return false;
+
+    return true;
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline const Affine3<T>&
+Affine3<T>::operator*= (const Affine3<T>& v) IMATH_NOEXCEPT
+{
+    *this = *this * v;
+    return *this;
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline Affine3<T>
+Affine3<T>::operator* (const Affine3<T>& v) const IMATH_NOEXCEPT
+{
+    //
+    // The rows of the linear part combine the rows of the linear part
+    // of v; the translation does the same and adds the translation of
+    // v. These are the terms of Matrix44::multiply() that do not
+    // vanish for affine matrices.
+    //
+
+    Affine3 c (UNINITIALIZED);
+
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            c.x[i][j] = x[i][0] * v.x[0][j] + x[i][1] * v.x[1][j] +
+                        x[i][2] * v.x[2][j];
+
+    for (int j = 0; j < 3; j++)
+        c.x[3][j] = x[3][0] * v.x[0][j] + x[3][1] * v.x[1][j] +
+                    x[3][2] * v.x[2][j] + v.x[3][j];
+
+    return c;
+}
+
+template <class T>
+template <class S>
+IMATH_HOSTDEVICE inline void
+Affine3<T>::multVecMatrix (const Vec3<S>& src, Vec3<S>& dst) const
+    IMATH_NOEXCEPT
+{
+    S a, b, c;
+
+    a = src.x * x[0][0] + src.y * x[1][0] + src.z * x[2][0] + x[3][0];
+    b = src.x * x[0][1] + src.y * x[1][1] + src.z * x[2][1] + x[3][1];
+    c = src.x * x[0][2] + src.y * x[1][2] + src.z * x[2][2] + x[3][2];
+
+    dst.x = a;
+    dst.y = b;
+    dst.z = c;
+}
+
+template <class T>
+template <class S>
+IMATH_HOSTDEVICE inline void
+Affine3<T>::multDirMatrix (const Vec3<S>& src, Vec3<S>& dst) const
+    IMATH_NOEXCEPT
+{
+    S a, b, c;
+
+    a = src.x * x[0][0] + src.y * x[1][0] + src.z * x[2][0];
+    b = src.x * x[0][1] + src.y * x[1][1] + src.z * x[2][1];
+    c = src.x * x[0][2] + src.y * x[1][2] + src.z * x[2][2];
+
+    dst.x = a;
+    dst.y = b;
+    dst.z = c;
+}
+
+template <class T>
+IMATH_HOSTDEVICE inline void
+Affine3<T>::makeIdentity () IMATH_NOEXCEPT
+{
+    *this = Affine3 ();
+}
+
+template <class T>
+IMATH_CONSTEXPR14 inline const Affine3<T>&
+Affine3<T>::invert (bool singExc)
+{
+    *this = inverse (singExc);
+    return *this;
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline const Affine3<T>&
+Affine3<T>::invert () IMATH_NOEXCEPT
+{
+    *this = inverse ();
+    return *this;
+}
+
+template <class T>
+IMATH_CONSTEXPR14 inline Affine3<T>
+Affine3<T>::inverse (bool singExc) const
+{
+    Affine3 s (UNINITIALIZED);
+
+    //
+    // This follows the affine case of Matrix44::inverse(), so that
+    // the results are identical.
+    //
+
+    s.x[0][0] = x[1][1] * x[2][2] - x[2][1] * x[1][2];
+    s.x[0][1] = x[2][1] * x[0][2] - x[0][1] * x[2][2];
+    s.x[0][2] = x[0][1] * x[1][2] - x[1][1] * x[0][2];
+
+    s.x[1][0] = x[2][0] * x[1][2] - x[1][0] * x[2][2];
+    s.x[1][1] = x[0][0] * x[2][2] - x[2][0] * x[0][2];
+    s.x[1][2] = x[1][0] * x[0][2] - x[0][0] * x[1][2];
+
+    s.x[2][0] = x[1][0] * x[2][1] - x[2][0] * x[1][1];
+    s.x[2][1] = x[2][0] * x[0][1] - x[0][0] * x[2][1];
+    s.x[2][2] = x[0][0] * x[1][1] - x[1][0] * x[0][1];
+
+    T r = x[0][0] * s.x[0][0] + x[0][1] * s.x[1][0] + x[0][2] * s.x[2][0];
+
+    if (IMATH_INTERNAL_NAMESPACE::abs (r) >= 1)
+    {
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+                s.x[i][j] /= r;
+    }
+    else
+    {
+        T mr =
+            IMATH_INTERNAL_NAMESPACE::abs (r) / std::numeric_limits<T>::min ();
+
+        for (int i = 0; i < 3; ++i)
+        {
+            for (int j = 0; j < 3; ++j)
+            {
+                if (mr > IMATH_INTERNAL_NAMESPACE::abs (s.x[i][j]))
+                {
+                    s.x[i][j] /= r;
+                }
+                else
+                {
+                    if (singExc)
+                        throw std::invalid_argument (
+                            "Cannot invert singular matrix.");
+
+                    return Affine3 ();
+                }
+            }
+        }
+    }
+
+    s.x[3][0] =
+        -x[3][0] * s.x[0][0] - x[3][1] * s.x[1][0] - x[3][2] * s.x[2][0];
+    s.x[3][1] =
+        -x[3][0] * s.x[0][1] - x[3][1] * s.x[1][1] - x[3][2] * s.x[2][1];
+    s.x[3][2] =
+        -x[3][0] * s.x[0][2] - x[3][1] * s.x[1][2] - x[3][2] * s.x[2][2];
+
+    return s;
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline Affine3<T>
+Affine3<T>::inverse () const IMATH_NOEXCEPT
+{
+    Affine3 s (UNINITIALIZED);
+
+    s.x[0][0] = x[1][1] * x[2][2] - x[2][1] * x[1][2];
+    s.x[0][1] = x[2][1] * x[0][2] - x[0][1] * x[2][2];
+    s.x[0][2] = x[0][1] * x[1][2] - x[1][1] * x[0][2];
+
+    s.x[1][0] = x[2][0] * x[1][2] - x[1][0] * x[2][2];
+    s.x[1][1] = x[0][0] * x[2][2] - x[2][0] * x[0][2];
+    s.x[1][2] = x[1][0] * x[0][2] - x[0][0] * x[1][2];
+
+    s.x[2][0] = x[1][0] * x[2][1] - x[2][0] * x[1][1];
+    s.x[2][1] = x[2][0] * x[0][1] - x[0][0] * x[2][1];
+    s.x[2][2] = x[0][0] * x[1][1] - x[1][0] * x[0][1];
+
+    T r = x[0][0] * s.x[0][0] + x[0][1] * s.x[1][0] + x[0][2] * s.x[2][0];
+
+    if (IMATH_INTERNAL_NAMESPACE::abs (r) >= 1)
+    {
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+                s.x[i][j] /= r;
+    }
+    else
+    {
+        T mr =
+            IMATH_INTERNAL_NAMESPACE::abs (r) / std::numeric_limits<T>::min ();
+
+        for (int i = 0; i < 3; ++i)
+        {
+            for (int j = 0; j < 3; ++j)
+            {
+                if (mr > IMATH_INTERNAL_NAMESPACE::abs (s.x[i][j]))
+                    s.x[i][j] /= r;
+                else
+                    return Affine3 ();
+            }
+        }
+    }
+
+    s.x[3][0] =
+        -x[3][0] * s.x[0][0] - x[3][1] * s.x[1][0] - x[3][2] * s.x[2][0];
+    s.x[3][1] =
+        -x[3][0] * s.x[0][1] - x[3][1] * s.x[1][1] - x[3][2] * s.x[2][1];
+    s.x[3][2] =
+        -x[3][0] * s.x[0][2] - x[3][1] * s.x[1][2] - x[3][2] * s.x[2][2];
+
+    return s;
+}
+
+template <class T>
+IMATH_HOSTDEVICE constexpr inline T
+Affine3<T>::determinant () const IMATH_NOEXCEPT
+{
+    return x[0][0] * (x[1][1] * x[2][2] - x[1][2] * x[2][1]) +
+           x[0][1] * (x[1][2] * x[2][0] - x[1][0] * x[2][2]) +
+           x[0][2] * (x[1][0] * x[2][1] - x[1][1] * x[2][0]);
+}
+
+template <class T>
+template <class S>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline const Affine3<T>&
+Affine3<T>::scale (const Vec3<S>& s) IMATH_NOEXCEPT
+{
+    x[0][0] *= s.x;
+    x[0][1] *= s.x;
+    x[0][2] *= s.x;
+
+    x[1][0] *= s.y;
+    x[1][1] *= s.y;
+    x[1][2] *= s.y;
+
+    x[2][0] *= s.z;
+    x[2][1] *= s.z;
+    x[2][2] *= s.z;
+
+    return *this;
+}
+
+template <class T>
+template <class S>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline const Affine3<T>&
+Affine3<T>::translate (const Vec3<S>& t) IMATH_NOEXCEPT
+{
+    x[3][0] += t.x * x[0][0] + t.y * x[1][0] + t.z * x[2][0];
+    x[3][1] += t.x * x[0][1] + t.y * x[1][1] + t.z * x[2][1];
+    x[3][2] += t.x * x[0][2] + t.y * x[1][2] + t.z * x[2][2];
+
+    return *this;
+}
+
+//--------------------------------
+// Implementation of stream output
+//--------------------------------
+
+template <class T>
+std::ostream&
+operator<< (std::ostream& s, const Affine3<T>& m)
+{
+    std::ios_base::fmtflags oldFlags = s.flags ();
+    int                     width;
+
+    if (s.flags () & std::ios_base::fixed)
+    {
+        s.setf (std::ios_base::showpoint);
+        width = static_cast<int> (s.precision ()) + 5;
+    }
+    else
+    {
+        s.setf (std::ios_base::scientific);
+        s.setf (std::ios_base::showpoint);
+        width = static_cast<int> (s.precision ()) + 8;
+    }
+
+    for (int i = 0; i < 4; i++)
+    {
+        s << (i == 0 ? "(" : " ") << std::setw (width) << m[i][0] << " "
+          << std::setw (width) << m[i][1] << " " << std::setw (width)
+          << m[i][2] << (i == 3 ? ")\n" : "\n");
+    }
+
+    s.flags (oldFlags);
+    return s;
+}
+
+//-----------------------------------------------------------
+// Implementation of vector-times-transformation operators
+//-----------------------------------------------------------
+
+template <class S, class T>
+IMATH_HOSTDEVICE inline const Vec3<S>&
+operator*= (Vec3<S>& v, const Affine3<T>& m) IMATH_NOEXCEPT
+{
+    m.multVecMatrix (v, v);
+    return v;
+}
+
+template <class S, class T>
+IMATH_HOSTDEVICE inline Vec3<S>
+operator* (const Vec3<S>& v, const Affine3<T>& m) IMATH_NOEXCEPT
+{
+    Vec3<S> r;
+    m.multVecMatrix (v, r);
+    return r;
+}
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif // INCLUDED_IMATHAFFINE_H
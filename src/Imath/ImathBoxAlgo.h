@@ -12,6 +12,7 @@
 
 #include "ImathNamespace.h"
 
+#include "ImathAffine.h"
 #include "ImathBox.h"
 #include "ImathLineAlgo.h"
 #include "ImathMatrix.h"
@@ -353,6 +354,78 @@ affineTransform (
     }
 }
 
+///
+/// Transform a 3D box by an affine transformation, and compute a new
+/// box that tightly encloses the transformed box. Return the
+/// transformed box. This uses James Arvo's method, as affineTransform()
+/// does for a Matrix44.
+///
+/// A transformed empty box is still empty, and a transformed infinite box
+/// is still infinite.
+///
+
+template <class S, class T>
+IMATH_HOSTDEVICE Box<Vec3<S>>
+transform (const Box<Vec3<S>>& box, const Affine3<T>& m) IMATH_NOEXCEPT
+{
+    if (box.isEmpty () || box.isInfinite ()) return box;
+
+    Box<Vec3<S>> newBox;
+    transform (box, m, newBox);
+    return newBox;
+}
+
+///
+/// Transform a 3D box by an affine transformation, and compute a new
+/// box that tightly encloses the transformed box. The transformed box
+/// is returned in the `result` argument.
+///
+/// A transformed empty box is still empty, and a transformed infinite
+/// box is still infinite.
+///
+
+template <class S, class T>
+IMATH_HOSTDEVICE void
+transform (const Box<Vec3<S>>& box, const Affine3<T>& m, Box<Vec3<S>>& result)
+    IMATH_NOEXCEPT
+{
+    if (box.isEmpty ())
+    {
+        result.makeEmpty ();
+        return;
+    }
+
+    if (box.isInfinite ())
+    {
+        result.makeInfinite ();
+        return;
+    }
+
+    for (int i = 0; i < 3; i++)
+    {
+        result.min[i] = result.max[i] = (S) m[3][i];
+
+        for (int j = 0; j < 3; j++)
+        {
+            S a, b;
+
+            a = (S) m[j][i] * box.min[j];
+            b = (S) m[j][i] * box.max[j];
+
+            if (a < b)
+            {
+                result.min[i] += a;
+                result.max[i] += b;
+            }
+            else
+            {
+                result.min[i] += b;
+                result.max[i] += a;
+            }
+        }
+    }
+}
+
 ///
 /// Compute the points where a ray, `r`, enters and exits a 3D box, `b`:
 ///
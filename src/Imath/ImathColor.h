@@ -320,12 +320,18 @@ typedef Color3<float> Color3f;
 /// 3 half channels
 typedef Color3<half> Color3h;
 
+/// 3 bfloat16 channels (include bfloat16.h to use it)
+typedef Color3<bfloat16> Color3bf;
+
 /// 3 8-bit integer channels
 typedef Color3<unsigned char> Color3c;
 
 /// 3 half channels
 typedef Color3<half> C3h;
 
+/// 3 bfloat16 channels (include bfloat16.h to use it)
+typedef Color3<bfloat16> C3bf;
+
 /// 3 float channels
 typedef Color3<float> C3f;
 
@@ -338,6 +344,9 @@ typedef Color4<float> Color4f;
 /// 4 half channels
 typedef Color4<half> Color4h;
 
+/// 4 bfloat16 channels (include bfloat16.h to use it)
+typedef Color4<bfloat16> Color4bf;
+
 /// 4 8-bit integer channels
 typedef Color4<unsigned char> Color4c;
 
@@ -347,6 +356,9 @@ typedef Color4<float> C4f;
 /// 4 half channels
 typedef Color4<half> C4h;
 
+/// 4 bfloat16 channels (include bfloat16.h to use it)
+typedef Color4<bfloat16> C4bf;
+
 /// 4 8-bit integer channels
 typedef Color4<unsigned char> C4c;
 
@@ -0,0 +1,220 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+//---------------------------------------------------------------------------
+//
+//	Run-time detection of x86 SIMD instruction sets, shared by the
+//	library sources that select kernels at run time. This header is
+//	private to the library and is not installed.
+//
+//	On x86 with a compiler that supports per-function targets,
+//	IMATH_X86_RUNTIME_DISPATCH is defined, the IMATH_TARGET_* macros
+//	compile a function for an instruction set regardless of the
+//	library's compiler flags, and imathCpuFeatures() reports what the
+//	host supports. Such a function must only be called when the
+//	corresponding feature is present.
+//
+//	For testing, when the library is built with
+//	IMATH_ENABLE_SIMD_LEVEL_OVERRIDE, the environment variable
+//	IMATH_SIMD_LEVEL caps the features that imathCpuFeatures()
+//	reports, so that the kernels for older processors and the scalar
+//	code can be run on any machine:
+//
+//	    scalar	no features
+//	    f16c	at most F16C and FMA
+//	    avx2	at most F16C, FMA and AVX2
+//
+//	Any other value, or none, reports the features detected. The
+//	variable is read once, on first use.
+//
+//---------------------------------------------------------------------------
+
+#ifndef INCLUDED_IMATHCPUFEATURES_H
+#define INCLUDED_IMATHCPUFEATURES_H
+
+#include <stdint.h>
+#ifdef IMATH_ENABLE_SIMD_LEVEL_OVERRIDE
+#    include <stdlib.h>
+#    include <string.h>
+#endif
+
+#if !defined(__CUDA_ARCH__) &&                                                 \
+    (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) ||            \
+     defined(_M_IX86)) &&                                                      \
+    (defined(_MSC_VER) || defined(__clang__) ||                                \
+     (defined(__GNUC__) &&                                                     \
+      (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#    define IMATH_X86_RUNTIME_DISPATCH
+#    if defined(_MSC_VER) && !defined(__clang__)
+#        include <intrin.h>
+#        define IMATH_TARGET_F16C
+#        define IMATH_TARGET_F16C_FMA
+#        define IMATH_TARGET_AVX2
+#        define IMATH_TARGET_AVX512
+#    else
+#        include <cpuid.h>
+#        include <immintrin.h>
+#        define IMATH_TARGET_F16C __attribute__ ((target ("avx,f16c")))
+#        define IMATH_TARGET_F16C_FMA                                          \
+            __attribute__ ((target ("avx,f16c,fma")))
+#        define IMATH_TARGET_AVX2 __attribute__ ((target ("avx2")))
+#        define IMATH_TARGET_AVX512 __attribute__ ((target ("avx512f")))
+#    endif
+#endif
+
+//
+// GCC 12's AVX-512 intrinsics start many results from a
+// _mm*_undefined_*() value, which -Wall reports as maybe used
+// uninitialized wherever they are inlined (GCC bug 105593). The
+// AVX-512 kernels are enclosed in IMATH_AVX512_KERNELS_BEGIN and
+// IMATH_AVX512_KERNELS_END to silence this.
+//
+
+#if defined(IMATH_X86_RUNTIME_DISPATCH) && defined(__GNUC__) &&                \
+    !defined(__clang__)
+#    define IMATH_AVX512_KERNELS_BEGIN                                         \
+        _Pragma ("GCC diagnostic push")                                        \
+        _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")           \
+        _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+#    define IMATH_AVX512_KERNELS_END _Pragma ("GCC diagnostic pop")
+#else
+#    define IMATH_AVX512_KERNELS_BEGIN
+#    define IMATH_AVX512_KERNELS_END
+#endif
+
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+
+namespace
+{
+
+struct ImathCpuFeatures
+{
+    bool f16c;    // with AVX
+    bool fma;     // with AVX
+    bool avx2;
+    bool avx512f;
+};
+
+inline void
+imathCpuid (uint32_t leaf, uint32_t subleaf, uint32_t regs[4])
+{
+#    if defined(_MSC_VER) && !defined(__clang__)
+    int r[4];
+    __cpuidex (r, int (leaf), int (subleaf));
+    for (int i = 0; i < 4; ++i)
+        regs[i] = uint32_t (r[i]);
+#    else
+    regs[0] = regs[1] = regs[2] = regs[3] = 0;
+    if (__get_cpuid_max (0, 0) >= leaf)
+        __cpuid_count (leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#    endif
+}
+
+inline uint64_t
+imathXcr0 ()
+{
+#    if defined(_MSC_VER) && !defined(__clang__)
+    return _xgetbv (0);
+#    else
+    uint32_t eax, edx;
+    __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (uint64_t (edx) << 32) | eax;
+#    endif
+}
+
+//
+// Besides the cpuid feature bits, the operating system must have
+// enabled saving of the AVX (and AVX-512) register state, which is
+// reported by XCR0.
+//
+
+inline ImathCpuFeatures
+imathDetectCpuFeatures ()
+{
+    ImathCpuFeatures f = {false, false, false, false};
+
+    uint32_t leaf1[4], leaf7[4];
+    imathCpuid (1, 0, leaf1);
+    imathCpuid (7, 0, leaf7);
+
+    const bool osxsave = (leaf1[2] & (1u << 27)) != 0;
+    const bool avx     = (leaf1[2] & (1u << 28)) != 0;
+
+    if (!osxsave || !avx) return f;
+
+    const uint64_t xcr = imathXcr0 ();
+
+    if ((xcr & 0x06) != 0x06) // SSE and AVX state
+        return f;
+
+    f.f16c = (leaf1[2] & (1u << 29)) != 0;
+    f.fma  = (leaf1[2] & (1u << 12)) != 0;
+    f.avx2 = (leaf7[1] & (1u << 5)) != 0;
+
+    if ((xcr & 0xe6) == 0xe6) // plus opmask and ZMM state
+        f.avx512f = (leaf7[1] & (1u << 16)) != 0;
+
+    return f;
+}
+
+#    ifdef IMATH_ENABLE_SIMD_LEVEL_OVERRIDE
+
+//
+// Apply the cap set by IMATH_SIMD_LEVEL, if any
+//
+
+inline ImathCpuFeatures
+imathCapCpuFeatures (ImathCpuFeatures f)
+{
+#    if defined(_MSC_VER)
+#        pragma warning(push)
+#        pragma warning(disable : 4996) // getenv
+#    endif
+    const char* level = getenv ("IMATH_SIMD_LEVEL");
+#    if defined(_MSC_VER)
+#        pragma warning(pop)
+#    endif
+
+    if (!level) return f;
+
+    if (strcmp (level, "scalar") == 0)
+    {
+        f.f16c = f.fma = f.avx2 = f.avx512f = false;
+    }
+    else if (strcmp (level, "f16c") == 0)
+    {
+        f.avx2 = f.avx512f = false;
+    }
+    else if (strcmp (level, "avx2") == 0)
+    {
+        f.avx512f = false;
+    }
+
+    return f;
+}
+
+#    endif // IMATH_ENABLE_SIMD_LEVEL_OVERRIDE
+
+//
+// The features are detected once, on first use.
+//
+
+inline const ImathCpuFeatures&
+imathCpuFeatures ()
+{
+#    ifdef IMATH_ENABLE_SIMD_LEVEL_OVERRIDE
+    static const ImathCpuFeatures features =
+        imathCapCpuFeatures (imathDetectCpuFeatures ());
+#    else
+    static const ImathCpuFeatures features = imathDetectCpuFeatures ();
+#    endif
+    return features;
+}
+
+} // namespace
+
+#endif // IMATH_X86_RUNTIME_DISPATCH
+
+#endif // INCLUDED_IMATHCPUFEATURES_H
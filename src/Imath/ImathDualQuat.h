@@ -0,0 +1,573 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+//
+// A dual quaternion, for rigid transformations
+//
+
+#ifndef INCLUDED_IMATHDUALQUAT_H
+#define INCLUDED_IMATHDUALQUAT_H
+
+#include "ImathExport.h"
+#include "ImathNamespace.h"
+
+#include "ImathMatrix.h"
+#include "ImathMatrixAlgo.h"
+#include "ImathQuat.h"
+#include "ImathVec.h"
+
+#include <cmath>
+#include <iostream>
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+#if (defined _WIN32 || defined _WIN64) && defined _MSC_VER
+// Disable MS VC++ warnings about conversion from double to float
+#    pragma warning(push)
+#    pragma warning(disable : 4244)
+#endif
+
+///
+/// The `DualQuat` class template represents a rigid transformation, a
+/// rotation followed by a translation, as a dual quaternion
+///
+///     real + e * dual,  with e * e = 0,
+///
+/// where `real` is the unit quaternion of the rotation and `dual` is
+/// half the translation, as a pure quaternion, times `real`. It takes
+/// 8 values instead of the 16 of a Matrix44, and blends without
+/// introducing scaling or shear.
+///
+/// As with Quat, a point is transformed by `p * dq`, and `a * b` is
+/// the transformation that applies `b` first and then `a`, so that
+///
+///     (a * b).toMatrix44 () == b.toMatrix44 () * a.toMatrix44 ()
+///
+/// The transformations assume a unit dual quaternion: one whose real
+/// part has length 1 and is orthogonal to its dual part. Blending and
+/// arithmetic do not preserve this; normalize() restores it.
+///
+
+template <class T> class IMATH_EXPORT_TEMPLATE_TYPE DualQuat
+{
+public:
+    /// @{
+    /// @name Direct access to elements
+
+    /// The real part, the rotation
+    Quat<T> real;
+
+    /// The dual part, half the translation times the rotation
+    Quat<T> dual;
+
+    /// @}
+
+    /// @{
+    ///	@name Constructors
+
+    /// Default constructor is the identity transformation
+    IMATH_HOSTDEVICE constexpr DualQuat () IMATH_NOEXCEPT;
+
+    /// Initialize with real part `r` and dual part `d`
+    IMATH_HOSTDEVICE constexpr DualQuat (const Quat<T>& r, const Quat<T>& d)
+        IMATH_NOEXCEPT;
+
+    /// The rotation by the unit quaternion `rotation`, followed by
+    /// the translation by `translation`
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14
+    DualQuat (const Quat<T>& rotation, const Vec3<T>& translation)
+        IMATH_NOEXCEPT;
+
+    /// The rotation and translation of a matrix that has no scaling,
+    /// shear or projection, as by extractQuat() and the translation
+    /// row
+    explicit DualQuat (const Matrix44<T>& m);
+
+    /// The identity transformation
+    IMATH_HOSTDEVICE constexpr static DualQuat<T> identity () IMATH_NOEXCEPT;
+
+    /// @}
+
+    /// @{
+    /// @name Basic Algebra
+    ///
+    /// Note that the operator return values are *NOT* normalized
+
+    /// Dual quaternion multiplication: `b` followed by `this`
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 const DualQuat<T>&
+    operator*= (const DualQuat<T>& q) IMATH_NOEXCEPT;
+
+    /// Scalar multiplication of both parts
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 const DualQuat<T>&
+    operator*= (T t) IMATH_NOEXCEPT;
+
+    /// Addition
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 const DualQuat<T>&
+    operator+= (const DualQuat<T>& q) IMATH_NOEXCEPT;
+
+    /// Subtraction
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 const DualQuat<T>&
+    operator-= (const DualQuat<T>& q) IMATH_NOEXCEPT;
+
+    /// Equality
+    template <class S>
+    IMATH_HOSTDEVICE constexpr bool
+    operator== (const DualQuat<S>& q) const IMATH_NOEXCEPT;
+
+    /// Inequality
+    template <class S>
+    IMATH_HOSTDEVICE constexpr bool
+    operator!= (const DualQuat<S>& q) const IMATH_NOEXCEPT;
+
+    /// @}
+
+    /// @{
+    /// @name Query
+
+    /// The rotation
+    IMATH_HOSTDEVICE constexpr Quat<T> rotation () const IMATH_NOEXCEPT;
+
+    /// The translation
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Vec3<T>
+    translation () const IMATH_NOEXCEPT;
+
+    /// Return the equivalent 4x4 matrix
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Matrix44<T>
+    toMatrix44 () const IMATH_NOEXCEPT;
+
+    /// Transform a point: rotate it, then translate it
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Vec3<T>
+    transformPoint (const Vec3<T>& p) const IMATH_NOEXCEPT;
+
+    /// Transform a direction: rotate it only
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Vec3<T>
+    transformDirection (const Vec3<T>& d) const IMATH_NOEXCEPT;
+
+    /// Transform `n` points: `dst[i] = transformPoint (src[i])`. `dst`
+    /// may be the same array as `src`.
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 void transformPoints (
+        const Vec3<T>* src, Vec3<T>* dst, size_t n) const IMATH_NOEXCEPT;
+
+    /// @}
+
+    /// @{
+    /// @name Utility Methods
+
+    /// The conjugate of both parts, which is the inverse of a unit
+    /// dual quaternion
+    IMATH_HOSTDEVICE constexpr DualQuat<T> conjugate () const IMATH_NOEXCEPT;
+
+    /// Invert in place: this = 1 / this. The real part must not be
+    /// zero.
+    /// @return const reference to this.
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 DualQuat<T>& invert () IMATH_NOEXCEPT;
+
+    /// Return 1/this, leaving this unchanged
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 DualQuat<T>
+    inverse () const IMATH_NOEXCEPT;
+
+    /// Normalize in place: scale both parts so that the real part has
+    /// length 1, and remove the component of the dual part along the
+    /// real part. A zero real part is left unchanged.
+    /// @return const reference to this.
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 DualQuat<T>& normalize () IMATH_NOEXCEPT;
+
+    /// Return a normalized dual quaternion, leaving this unmodified
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 DualQuat<T>
+    normalized () const IMATH_NOEXCEPT;
+
+    /// Raise a unit dual quaternion to the power `t`: the screw
+    /// motion along the same axis, by `t` times the angle and the
+    /// distance
+    IMATH_HOSTDEVICE DualQuat<T> pow (T t) const IMATH_NOEXCEPT;
+
+    /// @}
+
+    /// The base type: In templates that accept a parameter `V`, you
+    /// can refer to `T` as `V::BaseType`
+    typedef T BaseType;
+};
+
+/// Dual quaternion of type float
+typedef DualQuat<float> DualQuatf;
+
+/// Dual quaternion of type double
+typedef DualQuat<double> DualQuatd;
+
+//---------------
+// Implementation
+//---------------
+
+template <class T>
+IMATH_HOSTDEVICE constexpr inline DualQuat<T>::DualQuat () IMATH_NOEXCEPT
+    : real (1, 0, 0, 0),
+      dual (0, 0, 0, 0)
+{}
+
+template <class T>
+IMATH_HOSTDEVICE constexpr inline DualQuat<T>::DualQuat (
+    const Quat<T>& r, const Quat<T>& d) IMATH_NOEXCEPT : real (r),
+                                                         dual (d)
+{}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline DualQuat<T>::DualQuat (
+    const Quat<T>& rotation, const Vec3<T>& translation) IMATH_NOEXCEPT
+    : real (rotation),
+      dual (Quat<T> (0, translation * T (0.5)) * rotation)
+{}
+
+template <class T>
+inline DualQuat<T>::DualQuat (const Matrix44<T>& m)
+    : real (extractQuat (m)),
+      dual (Quat<T> (0, Vec3<T> (m[3][0], m[3][1], m[3][2]) * T (0.5)) *
+            real)
+{}
+
+template <class T>
+IMATH_HOSTDEVICE constexpr inline DualQuat<T>
+DualQuat<T>::identity () IMATH_NOEXCEPT
+{
+    return DualQuat<T> ();
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline const DualQuat<T>&
+DualQuat<T>::operator*= (const DualQuat<T>& q) IMATH_NOEXCEPT
+{
+    dual = real * q.dual + dual * q.real;
+    real = real * q.real;
+    return *this;
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline const DualQuat<T>&
+DualQuat<T>::operator*= (T t) IMATH_NOEXCEPT
+{
+    real *= t;
+    dual *= t;
+    return *this;
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline const DualQuat<T>&
+DualQuat<T>::operator+= (const DualQuat<T>& q) IMATH_NOEXCEPT
+{
+    real += q.real;
+    dual += q.dual;
+    return *this;
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline const DualQuat<T>&
+DualQuat<T>::operator-= (const DualQuat<T>& q) IMATH_NOEXCEPT
+{
+    real -= q.real;
+    dual -= q.dual;
+    return *this;
+}
+
+template <class T>
+template <class S>
+IMATH_HOSTDEVICE constexpr inline bool
+DualQuat<T>::operator== (const DualQuat<S>& q) const IMATH_NOEXCEPT
+{
+    return real == q.real && dual == q.dual;
+}
+
+template <class T>
+template <class S>
+IMATH_HOSTDEVICE constexpr inline bool
+DualQuat<T>::operator!= (const DualQuat<S>& q) const IMATH_NOEXCEPT
+{
+    return real != q.real || dual != q.dual;
+}
+
+template <class T>
+IMATH_HOSTDEVICE constexpr inline Quat<T>
+DualQuat<T>::rotation () const IMATH_NOEXCEPT
+{
+    return real;
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline Vec3<T>
+DualQuat<T>::translation () const IMATH_NOEXCEPT
+{
+    //
+    // The vector part of 2 * dual * ~real
+    //
+
+    return T (2) * (real.r * dual.v - dual.r * real.v + real.v % dual.v);
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline Matrix44<T>
+DualQuat<T>::toMatrix44 () const IMATH_NOEXCEPT
+{
+    Matrix44<T> m = real.toMatrix44 ();
+    Vec3<T>     t = translation ();
+
+    m[3][0] = t.x;
+    m[3][1] = t.y;
+    m[3][2] = t.z;
+
+    return m;
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline Vec3<T>
+DualQuat<T>::transformPoint (const Vec3<T>& p) const IMATH_NOEXCEPT
+{
+    return p * real + translation ();
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline Vec3<T>
+DualQuat<T>::transformDirection (const Vec3<T>& d) const IMATH_NOEXCEPT
+{
+    return d * real;
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline void
+DualQuat<T>::transformPoints (
+    const Vec3<T>* src, Vec3<T>* dst, size_t n) const IMATH_NOEXCEPT
+{
+    const Quat<T> r = real;
+    const Vec3<T> t = translation ();
+
+    for (size_t i = 0; i < n; ++i)
+        dst[i] = src[i] * r + t;
+}
+
+template <class T>
+IMATH_HOSTDEVICE constexpr inline DualQuat<T>
+DualQuat<T>::conjugate () const IMATH_NOEXCEPT
+{
+    return DualQuat<T> (~real, ~dual);
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline DualQuat<T>&
+DualQuat<T>::invert () IMATH_NOEXCEPT
+{
+    //
+    // (r + e d)^-1 = r^-1 - e r^-1 d r^-1
+    //
+
+    Quat<T> ri = real.inverse ();
+
+    dual = -(ri * dual * ri);
+    real = ri;
+    return *this;
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline DualQuat<T>
+DualQuat<T>::inverse () const IMATH_NOEXCEPT
+{
+    DualQuat<T> q (*this);
+    return q.invert ();
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline DualQuat<T>&
+DualQuat<T>::normalize () IMATH_NOEXCEPT
+{
+    if (T l = real.length ())
+    {
+        real /= l;
+        dual /= l;
+        dual -= (real ^ dual) * real;
+    }
+
+    return *this;
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline DualQuat<T>
+DualQuat<T>::normalized () const IMATH_NOEXCEPT
+{
+    DualQuat<T> q (*this);
+    return q.normalize ();
+}
+
+template <class T>
+IMATH_HOSTDEVICE inline DualQuat<T>
+DualQuat<T>::pow (T t) const IMATH_NOEXCEPT
+{
+    //
+    // A unit dual quaternion is a screw motion: a rotation by angle a
+    // about a line with direction l and moment m, and a translation
+    // by distance s along it,
+    //
+    //     real = (cos (a/2), sin (a/2) l)
+    //     dual = (-s/2 sin (a/2), s/2 cos (a/2) l + sin (a/2) m),
+    //
+    // and its power t is the screw motion with angle t a and distance
+    // t s about the same line.
+    //
+
+    const T sinHalf = real.v.length ();
+
+    if (sinHalf == 0)
+    {
+        //
+        // A pure translation, or the identity
+        //
+
+        return DualQuat<T> (real, dual * t);
+    }
+
+    const T       cosHalf = real.r;
+    const T       half    = std::atan2 (sinHalf, cosHalf);
+    const Vec3<T> l       = real.v / sinHalf;
+    const T       s       = -2 * dual.r / sinHalf;
+    const Vec3<T> m       = (dual.v - l * (s / 2 * cosHalf)) / sinHalf;
+
+    const T c  = std::cos (t * half);
+    const T sn = std::sin (t * half);
+    const T ts = t * s;
+
+    return DualQuat<T> (
+        Quat<T> (c, l * sn), Quat<T> (-ts / 2 * sn, l * (ts / 2 * c) + m * sn));
+}
+
+/// Dual quaternion multiplication: `b` followed by `a`
+template <class T>
+IMATH_HOSTDEVICE constexpr inline DualQuat<T>
+operator* (const DualQuat<T>& a, const DualQuat<T>& b) IMATH_NOEXCEPT
+{
+    return DualQuat<T> (a.real * b.real, a.real * b.dual + a.dual * b.real);
+}
+
+/// Scalar multiplication
+template <class T>
+IMATH_HOSTDEVICE constexpr inline DualQuat<T>
+operator* (const DualQuat<T>& q, T t) IMATH_NOEXCEPT
+{
+    return DualQuat<T> (q.real * t, q.dual * t);
+}
+
+/// Scalar multiplication
+template <class T>
+IMATH_HOSTDEVICE constexpr inline DualQuat<T>
+operator* (T t, const DualQuat<T>& q) IMATH_NOEXCEPT
+{
+    return DualQuat<T> (t * q.real, t * q.dual);
+}
+
+/// Addition
+template <class T>
+IMATH_HOSTDEVICE constexpr inline DualQuat<T>
+operator+ (const DualQuat<T>& a, const DualQuat<T>& b) IMATH_NOEXCEPT
+{
+    return DualQuat<T> (a.real + b.real, a.dual + b.dual);
+}
+
+/// Subtraction
+template <class T>
+IMATH_HOSTDEVICE constexpr inline DualQuat<T>
+operator- (const DualQuat<T>& a, const DualQuat<T>& b) IMATH_NOEXCEPT
+{
+    return DualQuat<T> (a.real - b.real, a.dual - b.dual);
+}
+
+/// Negation, which represents the same transformation
+template <class T>
+IMATH_HOSTDEVICE constexpr inline DualQuat<T>
+operator- (const DualQuat<T>& q) IMATH_NOEXCEPT
+{
+    return DualQuat<T> (-q.real, -q.dual);
+}
+
+/// Transform a point by a unit dual quaternion
+/// @return dq.transformPoint (p)
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline Vec3<T>
+operator* (const Vec3<T>& p, const DualQuat<T>& dq) IMATH_NOEXCEPT
+{
+    return dq.transformPoint (p);
+}
+
+/// Stream output as "((r x y z) (r x y z))"
+template <class T>
+std::ostream&
+operator<< (std::ostream& o, const DualQuat<T>& q)
+{
+    return o << "(" << q.real << " " << q.dual << ")";
+}
+
+///
+/// Screw linear interpolation (ScLERP) from `a` to `b`, which must be
+/// unit dual quaternions: a rotation at a constant rate about a fixed
+/// axis, combined with a translation at a constant rate along it, the
+/// rigid-body counterpart of slerp(). As slerpShortestArc() does, it
+/// follows the shorter of the two rotations from `a` to `b` and `-b`.
+///
+
+template <class T>
+IMATH_HOSTDEVICE inline DualQuat<T>
+sclerp (const DualQuat<T>& a, const DualQuat<T>& b, T t) IMATH_NOEXCEPT
+{
+    DualQuat<T> d = a.conjugate () * b;
+
+    if (d.real.r < 0) d = -d;
+
+    return a * d.pow (t);
+}
+
+///
+/// Dual quaternion linear blending (DLB) of `n` unit dual quaternions
+/// with the given weights: the normalized weighted sum, with each
+/// term negated if needed to be in the same hemisphere as `dq[0]`.
+/// This is the blend of dual quaternion skinning: unlike blending
+/// matrices, it yields a rigid transformation. An empty blend is the
+/// identity.
+///
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline DualQuat<T>
+dlb (const DualQuat<T>* dq, const T* weights, int n) IMATH_NOEXCEPT
+{
+    if (n <= 0) return DualQuat<T> ();
+
+    DualQuat<T> sum = weights[0] * dq[0];
+
+    for (int i = 1; i < n; ++i)
+    {
+        const T w = (dq[0].real ^ dq[i].real) < 0 ? -weights[i] : weights[i];
+        sum += w * dq[i];
+    }
+
+    return sum.normalize ();
+}
+
+///
+/// Transform `n` points, each by its own unit dual quaternion:
+/// `dst[i] = dq[i].transformPoint (src[i])`. `dst` may be the same
+/// array as `src`.
+///
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline void
+transformPoints (
+    const DualQuat<T>* dq,
+    const Vec3<T>*     src,
+    Vec3<T>*           dst,
+    size_t             n) IMATH_NOEXCEPT
+{
+    for (size_t i = 0; i < n; ++i)
+        dst[i] = dq[i].transformPoint (src[i]);
+}
+
+#if (defined _WIN32 || defined _WIN64) && defined _MSC_VER
+#    pragma warning(pop)
+#endif
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif // INCLUDED_IMATHDUALQUAT_H
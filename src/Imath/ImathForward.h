@@ -24,6 +24,9 @@ IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
 // forward declaration if the header has not yet been included.
 //
 
+#ifndef INCLUDED_IMATHAFFINE_H
+template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Affine3;
+#endif
 #ifndef INCLUDED_IMATHBOX_H
 template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Box;
 #endif
@@ -31,6 +34,9 @@ template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Box;
 template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Color3;
 template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Color4;
 #endif
+#ifndef INCLUDED_IMATHDUALQUAT_H
+template <class T> class IMATH_EXPORT_TEMPLATE_TYPE DualQuat;
+#endif
 #ifndef INCLUDED_IMATHEULER_H
 template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Euler;
 #endif
@@ -56,12 +62,18 @@ template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Plane3;
 #ifndef INCLUDED_IMATHQUAT_H
 template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Quat;
 #endif
+#ifndef INCLUDED_IMATHQUATTRACK_H
+template <class T> class IMATH_EXPORT_TEMPLATE_TYPE QuatTrack;
+#endif
 #ifndef INCLUDED_IMATHSHEAR_H
 template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Shear6;
 #endif
 #ifndef INCLUDED_IMATHSPHERE_H
 template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Sphere3;
 #endif
+#ifndef INCLUDED_IMATHTRANSFORMHIERARCHY_H
+template <class T> class IMATH_EXPORT_TEMPLATE_TYPE TransformHierarchy;
+#endif
 #ifndef INCLUDED_IMATHVEC_H
 template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Vec2;
 template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Vec3;
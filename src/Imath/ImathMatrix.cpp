@@ -0,0 +1,1010 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+//---------------------------------------------------------------------------
+//
+//	SIMD implementations of Matrix44 operations on arrays.
+//
+//	Except for the inverse, every kernel computes each element with
+//	the same operations, in the same order, as the scalar code in
+//	ImathMatrix.h, so that the results are identical. This file is
+//	compiled without floating-point contraction, which would
+//	otherwise fuse some of the multiplies and adds into FMA
+//	instructions.
+//
+//---------------------------------------------------------------------------
+
+#include "ImathMatrix.h"
+#include "ImathCpuFeatures.h"
+#include "ImathSimd.h"
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+IMATH_INTERNAL_NAMESPACE_SOURCE_ENTER
+
+namespace
+{
+
+//
+// Transform kinds: a direction (no translation), an affine point
+// (translation, no divide) and a projective point.
+//
+
+enum TransformKind
+{
+    TRANSFORM_DIR,
+    TRANSFORM_AFFINE,
+    TRANSFORM_PROJECTIVE
+};
+
+template <class T>
+TransformKind
+pointTransformKind (const Matrix44<T>& m)
+{
+    if (m[0][3] == 0 && m[1][3] == 0 && m[2][3] == 0 && m[3][3] == 1)
+        return TRANSFORM_AFFINE;
+
+    return TRANSFORM_PROJECTIVE;
+}
+
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+
+IMATH_AVX512_KERNELS_BEGIN
+
+//
+// AVX-512, float: four points per iteration. The 12 floats of four
+// Vec3s are loaded with one masked load; each point's x, y and z are
+// then broadcast across the four lanes of its 128-bit block, where
+// they multiply the matrix rows, so that each block produces one
+// transformed (x y z w). The w lanes are dropped again before a
+// masked store.
+//
+
+template <TransformKind Kind>
+IMATH_TARGET_AVX512 void
+transformAVX512 (const M44f& m, const V3f* src, V3f* dst, size_t n)
+{
+    const __m512i ix = _mm512_set_epi32 (9, 9, 9, 9, 6, 6, 6, 6, 3, 3, 3, 3, 0, 0, 0, 0);
+    const __m512i one = _mm512_set1_epi32 (1);
+    const __m512i iy  = _mm512_add_epi32 (ix, one);
+    const __m512i iz  = _mm512_add_epi32 (iy, one);
+    const __m512i iw =
+        _mm512_set_epi32 (15, 15, 15, 15, 11, 11, 11, 11, 7, 7, 7, 7, 3, 3, 3, 3);
+    const __m512i pack =
+        _mm512_set_epi32 (0, 0, 0, 0, 14, 13, 12, 10, 9, 8, 6, 5, 4, 2, 1, 0);
+
+    const __m512 r0 = _mm512_broadcast_f32x4 (_mm_loadu_ps (m[0]));
+    const __m512 r1 = _mm512_broadcast_f32x4 (_mm_loadu_ps (m[1]));
+    const __m512 r2 = _mm512_broadcast_f32x4 (_mm_loadu_ps (m[2]));
+    const __m512 r3 = _mm512_broadcast_f32x4 (_mm_loadu_ps (m[3]));
+
+    const float* s = &src[0].x;
+    float*       d = &dst[0].x;
+
+    for (size_t i = 0; i < n; i += 4)
+    {
+        size_t    k    = n - i < 4 ? n - i : 4;
+        __mmask16 mask = __mmask16 ((1u << (3 * k)) - 1);
+
+        __m512 v = _mm512_maskz_loadu_ps (mask, s + 3 * i);
+
+        __m512 r = _mm512_add_ps (
+            _mm512_add_ps (
+                _mm512_mul_ps (_mm512_permutexvar_ps (ix, v), r0),
+                _mm512_mul_ps (_mm512_permutexvar_ps (iy, v), r1)),
+            _mm512_mul_ps (_mm512_permutexvar_ps (iz, v), r2));
+
+        if (Kind != TRANSFORM_DIR) r = _mm512_add_ps (r, r3);
+
+        if (Kind == TRANSFORM_PROJECTIVE)
+            r = _mm512_div_ps (r, _mm512_permutexvar_ps (iw, r));
+
+        _mm512_mask_storeu_ps (d + 3 * i, mask, _mm512_permutexvar_ps (pack, r));
+    }
+}
+
+//
+// AVX-512, double: two points per iteration, in the same way.
+//
+
+template <TransformKind Kind>
+IMATH_TARGET_AVX512 void
+transformAVX512 (const M44d& m, const V3d* src, V3d* dst, size_t n)
+{
+    const __m512i ix   = _mm512_set_epi64 (3, 3, 3, 3, 0, 0, 0, 0);
+    const __m512i iy   = _mm512_set_epi64 (4, 4, 4, 4, 1, 1, 1, 1);
+    const __m512i iz   = _mm512_set_epi64 (5, 5, 5, 5, 2, 2, 2, 2);
+    const __m512i iw   = _mm512_set_epi64 (7, 7, 7, 7, 3, 3, 3, 3);
+    const __m512i pack = _mm512_set_epi64 (0, 0, 6, 5, 4, 2, 1, 0);
+
+    const __m512d r0 = _mm512_broadcast_f64x4 (_mm256_loadu_pd (m[0]));
+    const __m512d r1 = _mm512_broadcast_f64x4 (_mm256_loadu_pd (m[1]));
+    const __m512d r2 = _mm512_broadcast_f64x4 (_mm256_loadu_pd (m[2]));
+    const __m512d r3 = _mm512_broadcast_f64x4 (_mm256_loadu_pd (m[3]));
+
+    const double* s = &src[0].x;
+    double*       d = &dst[0].x;
+
+    for (size_t i = 0; i < n; i += 2)
+    {
+        size_t   k    = n - i < 2 ? n - i : 2;
+        __mmask8 mask = __mmask8 ((1u << (3 * k)) - 1);
+
+        __m512d v = _mm512_maskz_loadu_pd (mask, s + 3 * i);
+
+        __m512d r = _mm512_add_pd (
+            _mm512_add_pd (
+                _mm512_mul_pd (_mm512_permutexvar_pd (ix, v), r0),
+                _mm512_mul_pd (_mm512_permutexvar_pd (iy, v), r1)),
+            _mm512_mul_pd (_mm512_permutexvar_pd (iz, v), r2));
+
+        if (Kind != TRANSFORM_DIR) r = _mm512_add_pd (r, r3);
+
+        if (Kind == TRANSFORM_PROJECTIVE)
+            r = _mm512_div_pd (r, _mm512_permutexvar_pd (iw, r));
+
+        _mm512_mask_storeu_pd (d + 3 * i, mask, _mm512_permutexvar_pd (pack, r));
+    }
+}
+
+IMATH_AVX512_KERNELS_END
+
+//
+// AVX2, float: two points per iteration, in 128-bit halves of a
+// 256-bit register.
+//
+
+template <TransformKind Kind>
+IMATH_TARGET_AVX2 void
+transformAVX2 (const M44f& m, const V3f* src, V3f* dst, size_t n)
+{
+    const __m256i ix   = _mm256_set_epi32 (3, 3, 3, 3, 0, 0, 0, 0);
+    const __m256i iy   = _mm256_set_epi32 (4, 4, 4, 4, 1, 1, 1, 1);
+    const __m256i iz   = _mm256_set_epi32 (5, 5, 5, 5, 2, 2, 2, 2);
+    const __m256i iw   = _mm256_set_epi32 (7, 7, 7, 7, 3, 3, 3, 3);
+    const __m256i pack = _mm256_set_epi32 (0, 0, 6, 5, 4, 2, 1, 0);
+
+    const __m256 r0 = _mm256_broadcast_ps (reinterpret_cast<const __m128*> (m[0]));
+    const __m256 r1 = _mm256_broadcast_ps (reinterpret_cast<const __m128*> (m[1]));
+    const __m256 r2 = _mm256_broadcast_ps (reinterpret_cast<const __m128*> (m[2]));
+    const __m256 r3 = _mm256_broadcast_ps (reinterpret_cast<const __m128*> (m[3]));
+
+    const __m256i lanes = _mm256_set_epi32 (7, 6, 5, 4, 3, 2, 1, 0);
+
+    const float* s = &src[0].x;
+    float*       d = &dst[0].x;
+
+    for (size_t i = 0; i < n; i += 2)
+    {
+        int     k    = n - i < 2 ? int (n - i) : 2;
+        __m256i mask = _mm256_cmpgt_epi32 (_mm256_set1_epi32 (3 * k), lanes);
+
+        __m256 v = _mm256_maskload_ps (s + 3 * i, mask);
+
+        __m256 r = _mm256_add_ps (
+            _mm256_add_ps (
+                _mm256_mul_ps (_mm256_permutevar8x32_ps (v, ix), r0),
+                _mm256_mul_ps (_mm256_permutevar8x32_ps (v, iy), r1)),
+            _mm256_mul_ps (_mm256_permutevar8x32_ps (v, iz), r2));
+
+        if (Kind != TRANSFORM_DIR) r = _mm256_add_ps (r, r3);
+
+        if (Kind == TRANSFORM_PROJECTIVE)
+            r = _mm256_div_ps (r, _mm256_permutevar8x32_ps (r, iw));
+
+        _mm256_maskstore_ps (d + 3 * i, mask, _mm256_permutevar8x32_ps (r, pack));
+    }
+}
+
+//
+// AVX2, double: one point per iteration.
+//
+
+template <TransformKind Kind>
+IMATH_TARGET_AVX2 void
+transformAVX2 (const M44d& m, const V3d* src, V3d* dst, size_t n)
+{
+    const __m256d r0 = _mm256_loadu_pd (m[0]);
+    const __m256d r1 = _mm256_loadu_pd (m[1]);
+    const __m256d r2 = _mm256_loadu_pd (m[2]);
+    const __m256d r3 = _mm256_loadu_pd (m[3]);
+
+    const __m256i mask = _mm256_set_epi64x (0, -1, -1, -1);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const double* s = &src[i].x;
+
+        __m256d r = _mm256_add_pd (
+            _mm256_add_pd (
+                _mm256_mul_pd (_mm256_broadcast_sd (s), r0),
+                _mm256_mul_pd (_mm256_broadcast_sd (s + 1), r1)),
+            _mm256_mul_pd (_mm256_broadcast_sd (s + 2), r2));
+
+        if (Kind != TRANSFORM_DIR) r = _mm256_add_pd (r, r3);
+
+        if (Kind == TRANSFORM_PROJECTIVE)
+            r = _mm256_div_pd (r, _mm256_permute4x64_pd (r, 0xff));
+
+        _mm256_maskstore_pd (&dst[i].x, mask, r);
+    }
+}
+
+#endif // IMATH_X86_RUNTIME_DISPATCH
+
+template <TransformKind Kind, class T>
+void
+transformScalar (const Matrix44<T>& m, const Vec3<T>* src, Vec3<T>* dst, size_t n)
+{
+    if (Kind == TRANSFORM_DIR)
+        multDirMatrixArray<T, T> (m, src, dst, n);
+    else
+        multVecMatrixArray<T, T> (m, src, dst, n);
+}
+
+template <TransformKind Kind, class T>
+void
+transform (const Matrix44<T>& m, const Vec3<T>* src, Vec3<T>* dst, size_t n)
+{
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+    const ImathCpuFeatures& cpu = imathCpuFeatures ();
+
+    if (cpu.avx512f)
+    {
+        transformAVX512<Kind> (m, src, dst, n);
+        return;
+    }
+
+    if (cpu.avx2)
+    {
+        transformAVX2<Kind> (m, src, dst, n);
+        return;
+    }
+#endif
+
+    transformScalar<Kind> (m, src, dst, n);
+}
+
+template <class T>
+void
+transformPoints (const Matrix44<T>& m, const Vec3<T>* src, Vec3<T>* dst, size_t n)
+{
+    if (pointTransformKind (m) == TRANSFORM_AFFINE)
+        transform<TRANSFORM_AFFINE> (m, src, dst, n);
+    else
+        transform<TRANSFORM_PROJECTIVE> (m, src, dst, n);
+}
+
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+
+//
+// Matrix multiplication. Each row of the product is the sum of the
+// rows of b, weighted by the elements of the corresponding row of a,
+// accumulated from left to right as in Matrix44::multiply().
+//
+// AVX-512, float: the whole matrix in one register; permute_ps
+// broadcasts an element of each row of a across that row's 128-bit
+// block.
+//
+
+IMATH_AVX512_KERNELS_BEGIN
+
+IMATH_TARGET_AVX512 void
+multiplyAVX512 (const M44f* a, const M44f* b, M44f* c, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        const __m512 ra = _mm512_loadu_ps (a[i][0]);
+        const __m512 b0 = _mm512_broadcast_f32x4 (_mm_loadu_ps (b[i][0]));
+        const __m512 b1 = _mm512_broadcast_f32x4 (_mm_loadu_ps (b[i][1]));
+        const __m512 b2 = _mm512_broadcast_f32x4 (_mm_loadu_ps (b[i][2]));
+        const __m512 b3 = _mm512_broadcast_f32x4 (_mm_loadu_ps (b[i][3]));
+
+        __m512 r = _mm512_add_ps (
+            _mm512_add_ps (
+                _mm512_add_ps (
+                    _mm512_mul_ps (_mm512_permute_ps (ra, 0x00), b0),
+                    _mm512_mul_ps (_mm512_permute_ps (ra, 0x55), b1)),
+                _mm512_mul_ps (_mm512_permute_ps (ra, 0xaa), b2)),
+            _mm512_mul_ps (_mm512_permute_ps (ra, 0xff), b3));
+
+        _mm512_storeu_ps (c[i][0], r);
+    }
+}
+
+//
+// AVX-512, double: two rows per register.
+//
+
+IMATH_TARGET_AVX512 void
+multiplyAVX512 (const M44d* a, const M44d* b, M44d* c, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        const __m512d a01 = _mm512_loadu_pd (a[i][0]);
+        const __m512d a23 = _mm512_loadu_pd (a[i][2]);
+        const __m512d b0  = _mm512_broadcast_f64x4 (_mm256_loadu_pd (b[i][0]));
+        const __m512d b1  = _mm512_broadcast_f64x4 (_mm256_loadu_pd (b[i][1]));
+        const __m512d b2  = _mm512_broadcast_f64x4 (_mm256_loadu_pd (b[i][2]));
+        const __m512d b3  = _mm512_broadcast_f64x4 (_mm256_loadu_pd (b[i][3]));
+
+        __m512d r01 = _mm512_add_pd (
+            _mm512_add_pd (
+                _mm512_add_pd (
+                    _mm512_mul_pd (_mm512_permutex_pd (a01, 0x00), b0),
+                    _mm512_mul_pd (_mm512_permutex_pd (a01, 0x55), b1)),
+                _mm512_mul_pd (_mm512_permutex_pd (a01, 0xaa), b2)),
+            _mm512_mul_pd (_mm512_permutex_pd (a01, 0xff), b3));
+
+        __m512d r23 = _mm512_add_pd (
+            _mm512_add_pd (
+                _mm512_add_pd (
+                    _mm512_mul_pd (_mm512_permutex_pd (a23, 0x00), b0),
+                    _mm512_mul_pd (_mm512_permutex_pd (a23, 0x55), b1)),
+                _mm512_mul_pd (_mm512_permutex_pd (a23, 0xaa), b2)),
+            _mm512_mul_pd (_mm512_permutex_pd (a23, 0xff), b3));
+
+        _mm512_storeu_pd (c[i][0], r01);
+        _mm512_storeu_pd (c[i][2], r23);
+    }
+}
+
+IMATH_AVX512_KERNELS_END
+
+//
+// AVX2, float: two rows per register.
+//
+
+IMATH_TARGET_AVX2 void
+multiplyAVX2 (const M44f* a, const M44f* b, M44f* c, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        const __m256 a01 = _mm256_loadu_ps (a[i][0]);
+        const __m256 a23 = _mm256_loadu_ps (a[i][2]);
+        const __m256 b0 =
+            _mm256_broadcast_ps (reinterpret_cast<const __m128*> (b[i][0]));
+        const __m256 b1 =
+            _mm256_broadcast_ps (reinterpret_cast<const __m128*> (b[i][1]));
+        const __m256 b2 =
+            _mm256_broadcast_ps (reinterpret_cast<const __m128*> (b[i][2]));
+        const __m256 b3 =
+            _mm256_broadcast_ps (reinterpret_cast<const __m128*> (b[i][3]));
+
+        __m256 r01 = _mm256_add_ps (
+            _mm256_add_ps (
+                _mm256_add_ps (
+                    _mm256_mul_ps (_mm256_permute_ps (a01, 0x00), b0),
+                    _mm256_mul_ps (_mm256_permute_ps (a01, 0x55), b1)),
+                _mm256_mul_ps (_mm256_permute_ps (a01, 0xaa), b2)),
+            _mm256_mul_ps (_mm256_permute_ps (a01, 0xff), b3));
+
+        __m256 r23 = _mm256_add_ps (
+            _mm256_add_ps (
+                _mm256_add_ps (
+                    _mm256_mul_ps (_mm256_permute_ps (a23, 0x00), b0),
+                    _mm256_mul_ps (_mm256_permute_ps (a23, 0x55), b1)),
+                _mm256_mul_ps (_mm256_permute_ps (a23, 0xaa), b2)),
+            _mm256_mul_ps (_mm256_permute_ps (a23, 0xff), b3));
+
+        _mm256_storeu_ps (c[i][0], r01);
+        _mm256_storeu_ps (c[i][2], r23);
+    }
+}
+
+//
+// AVX2, double: one row per register. All rows of a are read before
+// any row of c is written, in case c and a are the same array.
+//
+
+IMATH_TARGET_AVX2 void
+multiplyAVX2 (const M44d* a, const M44d* b, M44d* c, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        const __m256d b0 = _mm256_loadu_pd (b[i][0]);
+        const __m256d b1 = _mm256_loadu_pd (b[i][1]);
+        const __m256d b2 = _mm256_loadu_pd (b[i][2]);
+        const __m256d b3 = _mm256_loadu_pd (b[i][3]);
+
+        __m256d r[4];
+
+        for (int j = 0; j < 4; ++j)
+        {
+            const double* aj = a[i][j];
+
+            r[j] = _mm256_add_pd (
+                _mm256_add_pd (
+                    _mm256_add_pd (
+                        _mm256_mul_pd (_mm256_broadcast_sd (aj), b0),
+                        _mm256_mul_pd (_mm256_broadcast_sd (aj + 1), b1)),
+                    _mm256_mul_pd (_mm256_broadcast_sd (aj + 2), b2)),
+                _mm256_mul_pd (_mm256_broadcast_sd (aj + 3), b3));
+        }
+
+        for (int j = 0; j < 4; ++j)
+            _mm256_storeu_pd (c[i][j], r[j]);
+    }
+}
+
+//
+// Matrix inversion, by Cramer's rule applied to the 2x2 blocks
+//
+//     | A B |
+//     | C D |
+//
+// of the matrix, with each 2x2 block held in one register as
+// (m00 m01 m10 m11). The inverse is the adjugate divided by the
+// determinant; the adjugates of the blocks of the inverse are
+//
+//     X# = |D| A - B (D# C)        Y# = |B| C - D (A# B)#
+//     Z# = |C| B - A (D# C)#       W# = |A| D - C (A# B)
+//
+// and the determinant is |A||D| + |B||C| - tr ((A# B) (D# C)).
+//
+// The same code serves float, with 128-bit registers, and double,
+// with 256-bit registers; the helpers below provide the operations
+// for both.
+//
+
+IMATH_TARGET_AVX2 inline __m128
+load (const float* p)
+{
+    return _mm_loadu_ps (p);
+}
+
+IMATH_TARGET_AVX2 inline __m256d
+load (const double* p)
+{
+    return _mm256_loadu_pd (p);
+}
+
+IMATH_TARGET_AVX2 inline void
+store (float* p, __m128 v)
+{
+    _mm_storeu_ps (p, v);
+}
+
+IMATH_TARGET_AVX2 inline void
+store (double* p, __m256d v)
+{
+    _mm256_storeu_pd (p, v);
+}
+
+IMATH_TARGET_AVX2 inline __m128
+add (__m128 a, __m128 b)
+{
+    return _mm_add_ps (a, b);
+}
+
+IMATH_TARGET_AVX2 inline __m256d
+add (__m256d a, __m256d b)
+{
+    return _mm256_add_pd (a, b);
+}
+
+IMATH_TARGET_AVX2 inline __m128
+sub (__m128 a, __m128 b)
+{
+    return _mm_sub_ps (a, b);
+}
+
+IMATH_TARGET_AVX2 inline __m256d
+sub (__m256d a, __m256d b)
+{
+    return _mm256_sub_pd (a, b);
+}
+
+IMATH_TARGET_AVX2 inline __m128
+mul (__m128 a, __m128 b)
+{
+    return _mm_mul_ps (a, b);
+}
+
+IMATH_TARGET_AVX2 inline __m256d
+mul (__m256d a, __m256d b)
+{
+    return _mm256_mul_pd (a, b);
+}
+
+IMATH_TARGET_AVX2 inline __m128
+div (__m128 a, __m128 b)
+{
+    return _mm_div_ps (a, b);
+}
+
+IMATH_TARGET_AVX2 inline __m256d
+div (__m256d a, __m256d b)
+{
+    return _mm256_div_pd (a, b);
+}
+
+//
+// allFinite (v) is true if no element of v is infinite or NaN, in
+// which case v - v is zero.
+//
+
+IMATH_TARGET_AVX2 inline bool
+allFinite (__m128 v)
+{
+    return _mm_movemask_ps (
+               _mm_cmp_ps (sub (v, v), _mm_setzero_ps (), _CMP_EQ_OQ)) == 0xf;
+}
+
+IMATH_TARGET_AVX2 inline bool
+allFinite (__m256d v)
+{
+    return _mm256_movemask_pd (_mm256_cmp_pd (
+               sub (v, v), _mm256_setzero_pd (), _CMP_EQ_OQ)) == 0xf;
+}
+
+IMATH_TARGET_AVX2 inline float
+first (__m128 v)
+{
+    return _mm_cvtss_f32 (v);
+}
+
+IMATH_TARGET_AVX2 inline double
+first (__m256d v)
+{
+    return _mm256_cvtsd_f64 (v);
+}
+
+IMATH_TARGET_AVX2 inline __m128
+set (float a, float b, float c, float d)
+{
+    return _mm_setr_ps (a, b, c, d);
+}
+
+IMATH_TARGET_AVX2 inline __m256d
+set (double a, double b, double c, double d)
+{
+    return _mm256_setr_pd (a, b, c, d);
+}
+
+//
+// shuffle<X,Y,Z,W> (a, b) is (a[X] a[Y] b[Z] b[W]);
+// swizzle<X,Y,Z,W> (v) is (v[X] v[Y] v[Z] v[W]).
+//
+
+template <int X, int Y, int Z, int W>
+IMATH_TARGET_AVX2 inline __m128
+shuffle (__m128 a, __m128 b)
+{
+    return _mm_shuffle_ps (a, b, _MM_SHUFFLE (W, Z, Y, X));
+}
+
+template <int X, int Y, int Z, int W>
+IMATH_TARGET_AVX2 inline __m128
+swizzle (__m128 v)
+{
+    return _mm_shuffle_ps (v, v, _MM_SHUFFLE (W, Z, Y, X));
+}
+
+template <int X, int Y, int Z, int W>
+IMATH_TARGET_AVX2 inline __m256d
+swizzle (__m256d v)
+{
+    return _mm256_permute4x64_pd (v, _MM_SHUFFLE (W, Z, Y, X));
+}
+
+template <int X, int Y, int Z, int W>
+IMATH_TARGET_AVX2 inline __m256d
+shuffle (__m256d a, __m256d b)
+{
+    return _mm256_blend_pd (
+        swizzle<X, Y, X, Y> (a), swizzle<Z, W, Z, W> (b), 0xc);
+}
+
+//
+// 2x2 products: a b, a# b and a b#
+//
+
+template <class V>
+IMATH_TARGET_AVX2 inline V
+mat2Mul (V a, V b)
+{
+    return add (
+        mul (a, swizzle<0, 3, 0, 3> (b)),
+        mul (swizzle<1, 0, 3, 2> (a), swizzle<2, 1, 2, 1> (b)));
+}
+
+template <class V>
+IMATH_TARGET_AVX2 inline V
+mat2AdjMul (V a, V b)
+{
+    return sub (
+        mul (swizzle<3, 3, 0, 0> (a), b),
+        mul (swizzle<1, 1, 2, 2> (a), swizzle<2, 3, 0, 1> (b)));
+}
+
+template <class V>
+IMATH_TARGET_AVX2 inline V
+mat2MulAdj (V a, V b)
+{
+    return sub (
+        mul (a, swizzle<3, 0, 3, 0> (b)),
+        mul (swizzle<1, 0, 3, 2> (a), swizzle<2, 1, 2, 1> (b)));
+}
+
+template <class V, class T>
+IMATH_TARGET_AVX2 size_t
+inverseAVX2 (const Matrix44<T>* src, Matrix44<T>* dst, size_t n, bool* singular)
+{
+    size_t count = 0;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const V m0 = load (src[i][0]);
+        const V m1 = load (src[i][1]);
+        const V m2 = load (src[i][2]);
+        const V m3 = load (src[i][3]);
+
+        const V A = shuffle<0, 1, 0, 1> (m0, m1);
+        const V B = shuffle<2, 3, 2, 3> (m0, m1);
+        const V C = shuffle<0, 1, 0, 1> (m2, m3);
+        const V D = shuffle<2, 3, 2, 3> (m2, m3);
+
+        // (|A| |B| |C| |D|)
+
+        const V dets = sub (
+            mul (shuffle<0, 2, 0, 2> (m0, m2), shuffle<1, 3, 1, 3> (m1, m3)),
+            mul (shuffle<1, 3, 1, 3> (m0, m2), shuffle<0, 2, 0, 2> (m1, m3)));
+
+        const V detA = swizzle<0, 0, 0, 0> (dets);
+        const V detB = swizzle<1, 1, 1, 1> (dets);
+        const V detC = swizzle<2, 2, 2, 2> (dets);
+        const V detD = swizzle<3, 3, 3, 3> (dets);
+
+        const V DC = mat2AdjMul (D, C);
+        const V AB = mat2AdjMul (A, B);
+
+        V X = sub (mul (detD, A), mat2Mul (B, DC));
+        V Y = sub (mul (detB, C), mat2MulAdj (D, AB));
+        V Z = sub (mul (detC, B), mat2MulAdj (A, DC));
+        V W = sub (mul (detA, D), mat2Mul (C, AB));
+
+        V tr = mul (AB, swizzle<0, 2, 1, 3> (DC));
+        tr   = add (tr, swizzle<1, 0, 3, 2> (tr));
+        tr   = add (tr, swizzle<2, 3, 0, 1> (tr));
+
+        const T det = first (detA) * first (detD) +
+                      first (detB) * first (detC) - first (tr);
+
+        // The signs turn the adjugates of the blocks into the blocks
+        // of the adjugate. Dividing by the determinant, rather than
+        // multiplying by its reciprocal, keeps matrices with a tiny
+        // determinant invertible; the matrix is singular if any
+        // element of the inverse is not finite, as when the
+        // determinant is zero or the inverse overflows.
+
+        const V s = set (det, -det, -det, det);
+
+        X = div (X, s);
+        Y = div (Y, s);
+        Z = div (Z, s);
+        W = div (W, s);
+
+        const bool bad = !(allFinite (X) && allFinite (Y) &&
+                           allFinite (Z) && allFinite (W));
+
+        if (singular) singular[i] = bad;
+
+        if (bad)
+        {
+            dst[i] = Matrix44<T> ();
+            ++count;
+            continue;
+        }
+
+        store (dst[i][0], shuffle<3, 1, 3, 1> (X, Y));
+        store (dst[i][1], shuffle<2, 0, 2, 0> (X, Y));
+        store (dst[i][2], shuffle<3, 1, 3, 1> (Z, W));
+        store (dst[i][3], shuffle<2, 0, 2, 0> (Z, W));
+    }
+
+    return count;
+}
+
+IMATH_AVX512_KERNELS_BEGIN
+
+//
+// Matrix inversion in structure-of-arrays form: 16 float or 8 double
+// matrices at a time, one matrix per lane. Each element of the
+// matrices is gathered into a register of its own, so that every
+// lane computes the cofactor expansion of its matrix as scalar code
+// would, without shuffles or branches. Singular matrices are found
+// with a lane mask and replaced by the identity.
+//
+// The register wrappers of ImathSimd.h let the expansion be written
+// once for both types.
+//
+
+template <class W>
+IMATH_TARGET_AVX512 size_t
+inverseAVX512 (
+    const Matrix44<typename W::BaseType>* src,
+    Matrix44<typename W::BaseType>*       dst,
+    size_t                                n,
+    bool*                                 singular)
+{
+    typedef typename W::BaseType T;
+    typedef typename W::Mask     Mask;
+
+    size_t count = 0;
+
+    for (size_t i = 0; i < n; i += W::lanes)
+    {
+        const size_t k    = laneCount<W> (n, i);
+        const Mask   mask = Mask ((1u << k) - 1);
+
+        //
+        // The unused lanes hold the identity, which is invertible.
+        //
+
+        W a[4][4];
+
+        for (int r = 0; r < 4; ++r)
+            for (int c = 0; c < 4; ++c)
+                a[r][c] = gather (&src[i][r][c], mask, T (r == c));
+
+        //
+        // The 2x2 minors of the top two rows, s, and the bottom two
+        // rows, c, give the determinant and the cofactors.
+        //
+
+        const W s0 = a[0][0] * a[1][1] - a[1][0] * a[0][1];
+        const W s1 = a[0][0] * a[1][2] - a[1][0] * a[0][2];
+        const W s2 = a[0][0] * a[1][3] - a[1][0] * a[0][3];
+        const W s3 = a[0][1] * a[1][2] - a[1][1] * a[0][2];
+        const W s4 = a[0][1] * a[1][3] - a[1][1] * a[0][3];
+        const W s5 = a[0][2] * a[1][3] - a[1][2] * a[0][3];
+
+        const W c5 = a[2][2] * a[3][3] - a[3][2] * a[2][3];
+        const W c4 = a[2][1] * a[3][3] - a[3][1] * a[2][3];
+        const W c3 = a[2][1] * a[3][2] - a[3][1] * a[2][2];
+        const W c2 = a[2][0] * a[3][3] - a[3][0] * a[2][3];
+        const W c1 = a[2][0] * a[3][2] - a[3][0] * a[2][2];
+        const W c0 = a[2][0] * a[3][1] - a[3][0] * a[2][1];
+
+        const W det =
+            s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+
+        W b[4][4];
+
+        b[0][0] = (a[1][1] * c5 - a[1][2] * c4 + a[1][3] * c3) / det;
+        b[0][1] = (a[0][2] * c4 - a[0][1] * c5 - a[0][3] * c3) / det;
+        b[0][2] = (a[3][1] * s5 - a[3][2] * s4 + a[3][3] * s3) / det;
+        b[0][3] = (a[2][2] * s4 - a[2][1] * s5 - a[2][3] * s3) / det;
+
+        b[1][0] = (a[1][2] * c2 - a[1][0] * c5 - a[1][3] * c1) / det;
+        b[1][1] = (a[0][0] * c5 - a[0][2] * c2 + a[0][3] * c1) / det;
+        b[1][2] = (a[3][2] * s2 - a[3][0] * s5 - a[3][3] * s1) / det;
+        b[1][3] = (a[2][0] * s5 - a[2][2] * s2 + a[2][3] * s1) / det;
+
+        b[2][0] = (a[1][0] * c4 - a[1][1] * c2 + a[1][3] * c0) / det;
+        b[2][1] = (a[0][1] * c2 - a[0][0] * c4 - a[0][3] * c0) / det;
+        b[2][2] = (a[3][0] * s4 - a[3][1] * s2 + a[3][3] * s0) / det;
+        b[2][3] = (a[2][1] * s2 - a[2][0] * s4 - a[2][3] * s0) / det;
+
+        b[3][0] = (a[1][1] * c1 - a[1][0] * c3 - a[1][2] * c0) / det;
+        b[3][1] = (a[0][0] * c3 - a[0][1] * c1 + a[0][2] * c0) / det;
+        b[3][2] = (a[3][1] * s1 - a[3][0] * s3 - a[3][2] * s0) / det;
+        b[3][3] = (a[2][0] * s3 - a[2][1] * s1 + a[2][2] * s0) / det;
+
+        //
+        // A matrix is singular if any element of its inverse is not
+        // finite: the determinant is zero, or too small for the
+        // cofactors, or the inverse overflows.
+        //
+
+        Mask ok = mask;
+
+        for (int r = 0; r < 4; ++r)
+            for (int c = 0; c < 4; ++c)
+                ok &= finite (b[r][c]);
+
+        for (int r = 0; r < 4; ++r)
+            for (int c = 0; c < 4; ++c)
+                scatter (
+                    &dst[i][r][c],
+                    mask,
+                    select (ok, b[r][c], splat (T (r == c))));
+
+        for (size_t j = 0; j < k; ++j)
+        {
+            const bool bad = !((ok >> j) & 1);
+
+            if (singular) singular[i + j] = bad;
+
+            count += bad;
+        }
+    }
+
+    return count;
+}
+
+IMATH_AVX512_KERNELS_END
+
+#endif // IMATH_X86_RUNTIME_DISPATCH
+
+template <class T>
+void
+multiplyMatrices (
+    const Matrix44<T>* a, const Matrix44<T>* b, Matrix44<T>* c, size_t n)
+{
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+    const ImathCpuFeatures& cpu = imathCpuFeatures ();
+
+    if (cpu.avx512f)
+    {
+        multiplyAVX512 (a, b, c, n);
+        return;
+    }
+
+    if (cpu.avx2)
+    {
+        multiplyAVX2 (a, b, c, n);
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < n; ++i)
+        c[i] = a[i] * b[i];
+}
+
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+
+//
+// The register types of the inversion kernels for each base type
+//
+
+template <class T> struct InverseKernels;
+
+template <> struct InverseKernels<float>
+{
+    typedef __m128       AVX2;
+    typedef FloatLanes16 AVX512;
+};
+
+template <> struct InverseKernels<double>
+{
+    typedef __m256d      AVX2;
+    typedef DoubleLanes8 AVX512;
+};
+
+#endif
+
+template <class T>
+size_t
+invertMatrices (
+    const Matrix44<T>* src, Matrix44<T>* dst, size_t n, bool* singular)
+{
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+    const ImathCpuFeatures& cpu = imathCpuFeatures ();
+
+    if (cpu.avx512f)
+    {
+        return inverseAVX512<typename InverseKernels<T>::AVX512> (
+            src, dst, n, singular);
+    }
+
+    if (cpu.avx2)
+    {
+        return inverseAVX2<typename InverseKernels<T>::AVX2> (
+            src, dst, n, singular);
+    }
+#endif
+
+    //
+    // Without SIMD kernels, use inverse(), and its exception to find
+    // singular matrices. An inverse that overflows is singular too,
+    // as it is for the kernels.
+    //
+
+    size_t count = 0;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        bool bad = false;
+
+        try
+        {
+            const Matrix44<T> m = src[i].inverse (true);
+
+            for (int r = 0; r < 4; ++r)
+                for (int c = 0; c < 4; ++c)
+                    bad |= !(std::abs (m[r][c]) <=
+                             std::numeric_limits<T>::max ());
+
+            dst[i] = bad ? Matrix44<T> () : m;
+        }
+        catch (std::invalid_argument&)
+        {
+            dst[i] = Matrix44<T> ();
+            bad    = true;
+        }
+
+        if (singular) singular[i] = bad;
+
+        count += bad;
+    }
+
+    return count;
+}
+
+} // namespace
+
+IMATH_EXPORT void
+multVecMatrixArray (const M44f& m, const V3f* src, V3f* dst, size_t n)
+    IMATH_NOEXCEPT
+{
+    transformPoints (m, src, dst, n);
+}
+
+IMATH_EXPORT void
+multVecMatrixArray (const M44d& m, const V3d* src, V3d* dst, size_t n)
+    IMATH_NOEXCEPT
+{
+    transformPoints (m, src, dst, n);
+}
+
+IMATH_EXPORT void
+multDirMatrixArray (const M44f& m, const V3f* src, V3f* dst, size_t n)
+    IMATH_NOEXCEPT
+{
+    transform<TRANSFORM_DIR> (m, src, dst, n);
+}
+
+IMATH_EXPORT void
+multDirMatrixArray (const M44d& m, const V3d* src, V3d* dst, size_t n)
+    IMATH_NOEXCEPT
+{
+    transform<TRANSFORM_DIR> (m, src, dst, n);
+}
+
+IMATH_EXPORT void
+multiplyMatrixArray (const M44f* a, const M44f* b, M44f* c, size_t n)
+    IMATH_NOEXCEPT
+{
+    multiplyMatrices (a, b, c, n);
+}
+
+IMATH_EXPORT void
+multiplyMatrixArray (const M44d* a, const M44d* b, M44d* c, size_t n)
+    IMATH_NOEXCEPT
+{
+    multiplyMatrices (a, b, c, n);
+}
+
+IMATH_EXPORT void
+inverseMatrixArray (const M44f* src, M44f* dst, size_t n) IMATH_NOEXCEPT
+{
+    invertMatrices (src, dst, n, 0);
+}
+
+IMATH_EXPORT void
+inverseMatrixArray (const M44d* src, M44d* dst, size_t n) IMATH_NOEXCEPT
+{
+    invertMatrices (src, dst, n, 0);
+}
+
+IMATH_EXPORT size_t
+inverseMatrixArray (
+    const M44f* src, M44f* dst, size_t n, bool* singular) IMATH_NOEXCEPT
+{
+    return invertMatrices (src, dst, n, singular);
+}
+
+IMATH_EXPORT size_t
+inverseMatrixArray (
+    const M44d* src, M44d* dst, size_t n, bool* singular) IMATH_NOEXCEPT
+{
+    return invertMatrices (src, dst, n, singular);
+}
+
+IMATH_INTERNAL_NAMESPACE_SOURCE_EXIT
@@ -613,6 +613,22 @@ public:
     IMATH_HOSTDEVICE void
     multDirMatrix (const Vec2<S>& src, Vec2<S>& dst) const IMATH_NOEXCEPT;
 
+    /// Vector-matrix multiplication of an array of `n` vectors, as by
+    /// the single-vector multVecMatrix(). If the last column of the
+    /// matrix is (0 0 1), the matrix is affine and the divide is
+    /// skipped, which gives the same results for finite vectors.
+    /// `dst` may be the same as `src`, but must not otherwise overlap
+    /// it.
+    template <class S>
+    void multVecMatrix (const Vec2<S>* src, Vec2<S>* dst, size_t n) const
+        IMATH_NOEXCEPT;
+
+    /// Vector-matrix multiplication of an array of `n` vectors, as by
+    /// the single-vector multDirMatrix().
+    template <class S>
+    void multDirMatrix (const Vec2<S>* src, Vec2<S>* dst, size_t n) const
+        IMATH_NOEXCEPT;
+
     /// @}
 
     /// @{
@@ -1095,6 +1111,23 @@ public:
     IMATH_HOSTDEVICE void
     multDirMatrix (const Vec3<S>& src, Vec3<S>& dst) const IMATH_NOEXCEPT;
 
+    /// Vector-matrix multiplication of an array of `n` vectors, as by
+    /// the single-vector multVecMatrix(). If the last column of the
+    /// matrix is (0 0 0 1), the matrix is affine and the divide is
+    /// skipped, which gives the same results for finite vectors. For
+    /// float and double, the library provides SIMD implementations.
+    /// `dst` may be the same as `src`, but must not otherwise overlap
+    /// it.
+    template <class S>
+    void multVecMatrix (const Vec3<S>* src, Vec3<S>* dst, size_t n) const
+        IMATH_NOEXCEPT;
+
+    /// Vector-matrix multiplication of an array of `n` vectors, as by
+    /// the single-vector multDirMatrix().
+    template <class S>
+    void multDirMatrix (const Vec3<S>* src, Vec3<S>* dst, size_t n) const
+        IMATH_NOEXCEPT;
+
     /// @}
 
     /// @{
@@ -1403,6 +1436,91 @@ typedef Matrix44<float> M44f;
 /// 4x4 matrix of double
 typedef Matrix44<double> M44d;
 
+//-------------------------------------------------
+// Vector-times-matrix multiplication over arrays
+//-------------------------------------------------
+
+/// @cond Doxygen_Suppress
+
+//
+// The implementation of the array forms of Matrix44::multVecMatrix()
+// and multDirMatrix(). The library provides the float and double
+// versions, with SIMD kernels chosen at run time for the host CPU.
+//
+
+template <class T, class S>
+void multVecMatrixArray (
+    const Matrix44<T>& m,
+    const Vec3<S>*     src,
+    Vec3<S>*           dst,
+    size_t             n) IMATH_NOEXCEPT;
+
+template <class T, class S>
+void multDirMatrixArray (
+    const Matrix44<T>& m,
+    const Vec3<S>*     src,
+    Vec3<S>*           dst,
+    size_t             n) IMATH_NOEXCEPT;
+
+IMATH_EXPORT void multVecMatrixArray (
+    const M44f& m, const V3f* src, V3f* dst, size_t n) IMATH_NOEXCEPT;
+
+IMATH_EXPORT void multVecMatrixArray (
+    const M44d& m, const V3d* src, V3d* dst, size_t n) IMATH_NOEXCEPT;
+
+IMATH_EXPORT void multDirMatrixArray (
+    const M44f& m, const V3f* src, V3f* dst, size_t n) IMATH_NOEXCEPT;
+
+IMATH_EXPORT void multDirMatrixArray (
+    const M44d& m, const V3d* src, V3d* dst, size_t n) IMATH_NOEXCEPT;
+
+/// @endcond
+
+//----------------------------------------------
+// Matrix44 multiplication and inversion over arrays
+//----------------------------------------------
+
+/// Compute `c[i] = a[i] * b[i]` for `0 <= i < n`. `c` may be the
+/// same array as `a` or `b`, but must not otherwise overlap them.
+/// The results are identical to those of Matrix44::operator*; SIMD
+/// kernels are chosen at run time for the host CPU.
+IMATH_EXPORT void multiplyMatrixArray (
+    const M44f* a, const M44f* b, M44f* c, size_t n) IMATH_NOEXCEPT;
+
+/// Compute `c[i] = a[i] * b[i]` for `0 <= i < n`.
+IMATH_EXPORT void multiplyMatrixArray (
+    const M44d* a, const M44d* b, M44d* c, size_t n) IMATH_NOEXCEPT;
+
+/// Compute `dst[i] = src[i].inverse()` for `0 <= i < n`. `dst` may
+/// be the same array as `src`. The SIMD kernels use Cramer's rule
+/// rather than Gauss-Jordan elimination, so the results may differ
+/// from those of Matrix44::inverse() in the last bits, and are less
+/// accurate for badly conditioned matrices. A matrix whose
+/// determinant is zero, or whose inverse overflows, yields the
+/// identity matrix. With AVX-512, the matrices are inverted 16
+/// (float) or 8 (double) at a time, in structure-of-arrays form.
+IMATH_EXPORT void
+inverseMatrixArray (const M44f* src, M44f* dst, size_t n) IMATH_NOEXCEPT;
+
+/// Compute `dst[i] = src[i].inverse()` for `0 <= i < n`.
+IMATH_EXPORT void
+inverseMatrixArray (const M44d* src, M44d* dst, size_t n) IMATH_NOEXCEPT;
+
+/// Compute `dst[i] = src[i].inverse()` for `0 <= i < n`, as above,
+/// and report the matrices that cannot be inverted, instead of
+/// throwing an exception: `singular[i]` is set to true for such a
+/// matrix, whose inverse is the identity, and to false otherwise.
+/// `singular` may be null.
+/// @return The number of matrices that cannot be inverted
+IMATH_EXPORT size_t inverseMatrixArray (
+    const M44f* src, M44f* dst, size_t n, bool* singular) IMATH_NOEXCEPT;
+
+/// Compute `dst[i] = src[i].inverse()` for `0 <= i < n`, and report
+/// the matrices that cannot be inverted.
+/// @return The number of matrices that cannot be inverted
+IMATH_EXPORT size_t inverseMatrixArray (
+    const M44d* src, M44d* dst, size_t n, bool* singular) IMATH_NOEXCEPT;
+
 //---------------------------
 // Implementation of Matrix22
 //---------------------------
@@ -2554,6 +2672,40 @@ Matrix33<T>::multDirMatrix (const Vec2<S>& src, Vec2<S>& dst) const
     dst.y = b;
 }
 
+template <class T>
+template <class S>
+inline void
+Matrix33<T>::multVecMatrix (const Vec2<S>* src, Vec2<S>* dst, size_t n) const
+    IMATH_NOEXCEPT
+{
+    if (x[0][2] == 0 && x[1][2] == 0 && x[2][2] == 1)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            S a = src[i].x * x[0][0] + src[i].y * x[1][0] + x[2][0];
+            S b = src[i].x * x[0][1] + src[i].y * x[1][1] + x[2][1];
+
+            dst[i].x = a;
+            dst[i].y = b;
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < n; ++i)
+            multVecMatrix (src[i], dst[i]);
+    }
+}
+
+template <class T>
+template <class S>
+inline void
+Matrix33<T>::multDirMatrix (const Vec2<S>* src, Vec2<S>* dst, size_t n) const
+    IMATH_NOEXCEPT
+{
+    for (size_t i = 0; i < n; ++i)
+        multDirMatrix (src[i], dst[i]);
+}
+
 template <class T>
 IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline const Matrix33<T>&
 Matrix33<T>::operator/= (T a) IMATH_NOEXCEPT
@@ -4092,6 +4244,61 @@ Matrix44<T>::multDirMatrix (const Vec3<S>& src, Vec3<S>& dst) const
     dst.z = c;
 }
 
+template <class T>
+template <class S>
+inline void
+Matrix44<T>::multVecMatrix (const Vec3<S>* src, Vec3<S>* dst, size_t n) const
+    IMATH_NOEXCEPT
+{
+    multVecMatrixArray (*this, src, dst, n);
+}
+
+template <class T>
+template <class S>
+inline void
+Matrix44<T>::multDirMatrix (const Vec3<S>* src, Vec3<S>* dst, size_t n) const
+    IMATH_NOEXCEPT
+{
+    multDirMatrixArray (*this, src, dst, n);
+}
+
+template <class T, class S>
+inline void
+multVecMatrixArray (
+    const Matrix44<T>& m, const Vec3<S>* src, Vec3<S>* dst, size_t n)
+    IMATH_NOEXCEPT
+{
+    if (m[0][3] == 0 && m[1][3] == 0 && m[2][3] == 0 && m[3][3] == 1)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            const Vec3<S>& v = src[i];
+            S a = v.x * m[0][0] + v.y * m[1][0] + v.z * m[2][0] + m[3][0];
+            S b = v.x * m[0][1] + v.y * m[1][1] + v.z * m[2][1] + m[3][1];
+            S c = v.x * m[0][2] + v.y * m[1][2] + v.z * m[2][2] + m[3][2];
+
+            dst[i].x = a;
+            dst[i].y = b;
+            dst[i].z = c;
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < n; ++i)
+            m.multVecMatrix (src[i], dst[i]);
+    }
+}
+
+template <class T, class S>
+inline void
+multDirMatrixArray (
+    const Matrix44<T>& m, const Vec3<S>* src, Vec3<S>* dst, size_t n)
+    IMATH_NOEXCEPT
+{
+    for (size_t i = 0; i < n; ++i)
+        m.multDirMatrix (src[i], dst[i]);
+}
+
 template <class T>
 IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline const Matrix44<T>&
 Matrix44<T>::operator/= (T a) IMATH_NOEXCEPT
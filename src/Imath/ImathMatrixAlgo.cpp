@@ -13,6 +13,8 @@
 /// @cond Doxygen_Suppress
 
 #include "ImathMatrixAlgo.h"
+#include "ImathCpuFeatures.h"
+#include "ImathSimd.h"
 #include <algorithm>
 #include <cmath>
 
@@ -70,28 +72,61 @@ private:
 
 } // namespace
 
+ProcrustesAccumulator::ProcrustesAccumulator ()
+    : _numPoints (0)
+    , _weightsSum (0)
+    , _Aorigin (0.0)
+    , _Borigin (0.0)
+    , _Asum (0.0)
+    , _Bsum (0.0)
+    , _BAsum (0.0)
+    , _AAsum (0)
+{}
+
+void
+ProcrustesAccumulator::clear ()
+{
+    *this = ProcrustesAccumulator ();
+}
+
 template <typename T>
-M44d
-procrustesRotationAndTranslation (
+void
+ProcrustesAccumulator::add (
     const Vec3<T>* A,
     const Vec3<T>* B,
     const T*       weights,
-    const size_t   numPoints,
-    const bool     doScale)
+    const size_t   numPoints)
 {
-    if (numPoints == 0) return M44d ();
+    if (numPoints == 0) return;
+
+    //
+    // The first pair of points added is the origin of the moments
+    // (see result()).
+    //
+
+    if (_numPoints == 0)
+    {
+        _Aorigin = (V3d) A[0];
+        _Borigin = (V3d) B[0];
+    }
 
     // Always do the accumulation in double precision:
-    V3d    Acenter (0.0);
-    V3d    Bcenter (0.0);
-    double weightsSum = 0.0;
+    double   weightsSum = 0.0;
+    V3d      Asum (0.0);
+    V3d      Bsum (0.0);
+    M33d     BAsum (0.0);
+    KahanSum AAsum;
 
     if (weights == 0)
     {
         for (size_t i = 0; i < numPoints; ++i)
         {
-            Acenter += (V3d) A[i];
-            Bcenter += (V3d) B[i];
+            const V3d a = (V3d) A[i] - _Aorigin;
+            const V3d b = (V3d) B[i] - _Borigin;
+            Asum += a;
+            Bsum += b;
+            BAsum += outerProduct (b, a);
+            AAsum += a.length2 ();
         }
         weightsSum = (double) numPoints;
     }
@@ -100,17 +135,77 @@ procrustesRotationAndTranslation (
         for (size_t i = 0; i < numPoints; ++i)
         {
             const double w = weights[i];
+            const V3d    a = (V3d) A[i] - _Aorigin;
+            const V3d    b = (V3d) B[i] - _Borigin;
             weightsSum += w;
-
-            Acenter += w * (V3d) A[i];
-            Bcenter += w * (V3d) B[i];
+            Asum += w * a;
+            Bsum += w * b;
+            BAsum += outerProduct (w * b, a);
+            AAsum += w * a.length2 ();
         }
     }
 
-    if (weightsSum == 0) return M44d ();
+    _numPoints += numPoints;
+    _weightsSum += weightsSum;
+    _Asum += Asum;
+    _Bsum += Bsum;
+    _BAsum += BAsum;
+    _AAsum += AAsum.get ();
+}
+
+void
+ProcrustesAccumulator::merge (const ProcrustesAccumulator& other)
+{
+    if (other._numPoints == 0) return;
+
+    if (_numPoints == 0)
+    {
+        *this = other;
+        return;
+    }
+
+    //
+    // Move the moments of other to this accumulator's origin: with
+    // a = a' + dA and b = b' + dB, where a' and b' are relative to
+    // other's origin,
+    //
+    //     sum w b a^T = sum w b' a'^T + (sum w b') dA^T
+    //                   + dB (sum w a')^T + (sum w) dB dA^T
+    //
+    // and likewise for the others. The moments of a set of points
+    // are kept whatever its weights sum to, so sets whose weights
+    // cancel still merge exactly.
+    //
+
+    const V3d    dA = other._Aorigin - _Aorigin;
+    const V3d    dB = other._Borigin - _Borigin;
+    const double w  = other._weightsSum;
+
+    _BAsum += other._BAsum + outerProduct (other._Bsum, dA) +
+              outerProduct (dB, other._Asum) + outerProduct (w * dB, dA);
+    _AAsum += other._AAsum + 2 * (dA ^ other._Asum) + w * dA.length2 ();
+    _Asum += other._Asum + w * dA;
+    _Bsum += other._Bsum + w * dB;
+    _weightsSum += w;
+    _numPoints += other._numPoints;
+}
+
+M44d
+ProcrustesAccumulator::result (const bool doScale) const
+{
+    if (_weightsSum == 0) return M44d ();
+
+    //
+    // The weighted centers of the points, and the weighted
+    // cross-covariance of the points about them, from the moments
+    // about the origin of the accumulator
+    //
 
-    Acenter /= weightsSum;
-    Bcenter /= weightsSum;
+    const V3d  Ac      = _Asum / _weightsSum;
+    const V3d  Bc      = _Bsum / _weightsSum;
+    const V3d  Acenter = _Aorigin + Ac;
+    const V3d  Bcenter = _Borigin + Bc;
+    const M33d C       = _BAsum - outerProduct (_weightsSum * Bc, Ac);
 
     //
     // Find Q such that |Q*A - B|  (actually A-Acenter and B-Bcenter, weighted)
@@ -121,22 +216,6 @@ procrustesRotationAndTranslation (
     // Let C = B A^T   (where A is 3xn and B^T is nx3, so C is 3x3)
     // Compute the SVD: C = U D V^T  (U,V rotations, D diagonal).
     // Throw away the D part, and return Q = U V^T
-    M33d C (0.0);
-    if (weights == 0)
-    {
-        for (size_t i = 0; i < numPoints; ++i)
-            C += outerProduct ((V3d) B[i] - Bcenter, (V3d) A[i] - Acenter);
-    }
-    else
-    {
-        for (size_t i = 0; i < numPoints; ++i)
-        {
-            const double w = weights[i];
-            C +=
-                outerProduct (w * ((V3d) B[i] - Bcenter), (V3d) A[i] - Acenter);
-        }
-    }
-
     M33d U, V;
     V3d  S;
     jacobiSVD (C, U, S, V, std::numeric_limits<double>::epsilon (), true);
@@ -146,7 +225,7 @@ procrustesRotationAndTranslation (
     const M33d Qt = V * U.transposed ();
 
     double s = 1.0;
-    if (doScale && numPoints > 1)
+    if (doScale && _numPoints > 1)
     {
         // Finding a uniform scale: let us assume the Q is completely fixed
         // at this point (solving for both simultaneously seems much harder).
@@ -167,25 +246,14 @@ procrustesRotationAndTranslation (
         // 2*s*tr(A^T*A) = 2*s*tr(Q^T*A^T*B)
         // s = tr(Q^T*A^T*B) / tr(A^T*A)
 
-        KahanSum traceATA;
-        if (weights == 0)
-        {
-            for (size_t i = 0; i < numPoints; ++i)
-                traceATA += ((V3d) A[i] - Acenter).length2 ();
-        }
-        else
-        {
-            for (size_t i = 0; i < numPoints; ++i)
-                traceATA +=
-                    ((double) weights[i]) * ((V3d) A[i] - Acenter).length2 ();
-        }
-
         KahanSum traceBATQ;
         for (int i = 0; i < 3; ++i)
             for (int j = 0; j < 3; ++j)
                 traceBATQ += Qt[j][i] * C[i][j];
 
-        s = traceBATQ.get () / traceATA.get ();
+        const double traceATA = _AAsum - _weightsSum * Ac.length2 ();
+
+        s = traceBATQ.get () / traceATA;
     }
 
     // Q is the rotation part of what we want to return.
@@ -213,19 +281,33 @@ procrustesRotationAndTranslation (
         s * Qt.x[0][0],
         s * Qt.x[0][1],
         s * Qt.x[0][2],
-        T (0),
+        0.0,
         s * Qt.x[1][0],
         s * Qt.x[1][1],
         s * Qt.x[1][2],
-        T (0),
+        0.0,
         s * Qt.x[2][0],
         s * Qt.x[2][1],
         s * Qt.x[2][2],
-        T (0),
+        0.0,
         translate.x,
         translate.y,
         translate.z,
-        T (1));
+        1.0);
+} // ProcrustesAccumulator::result
+
+template <typename T>
+M44d
+procrustesRotationAndTranslation (
+    const Vec3<T>* A,
+    const Vec3<T>* B,
+    const T*       weights,
+    const size_t   numPoints,
+    const bool     doScale)
+{
+    ProcrustesAccumulator accumulator;
+    accumulator.add (A, B, weights, numPoints);
+    return accumulator.result (doScale);
 } // procrustesRotationAndTranslation
 
 ///
@@ -268,6 +350,17 @@ template IMATH_EXPORT M44d procrustesRotationAndTranslation (
     const size_t numPoints,
     const bool   doScale);
 
+template IMATH_EXPORT void ProcrustesAccumulator::add (
+    const V3d*    from,
+    const V3d*    to,
+    const double* weights,
+    const size_t  numPoints);
+template IMATH_EXPORT void ProcrustesAccumulator::add (
+    const V3f*   from,
+    const V3f*   to,
+    const float* weights,
+    const size_t numPoints);
+
 namespace
 {
 
@@ -1267,6 +1360,1631 @@ minEigenVector (Matrix33<double>& A, Vec3<double>& S);
 template IMATH_EXPORT void
 minEigenVector (Matrix44<double>& A, Vec4<double>& S);
 
+namespace
+{
+
+//
+// Decomposition of matrix arrays. Each matrix is decomposed exactly
+// as extractSHRT() would do it; for the AVX-512 kernel, that means
+// that every lane must perform the same operations as
+// extractAndRemoveScalingAndShear(), in the same order. The kernel
+// only handles the common case: lanes that would take a different
+// path through the scalar code, because a scale factor is zero or
+// tiny, are decomposed again by the scalar code. The rotation is
+// converted to Euler angles one matrix at a time, with the scalar
+// trigonometric functions.
+//
+
+template <class T>
+void
+rotationToEuler (
+    const Matrix44<T>& rot, Vec3<T>& r, typename Euler<T>::Order rOrder)
+{
+    extractEulerXYZ (rot, r);
+
+    if (rOrder != Euler<T>::XYZ)
+    {
+        Euler<T> eXYZ (r, Euler<T>::XYZ);
+        Euler<T> e (eXYZ, rOrder);
+        r = e.toXYZVector ();
+    }
+}
+
+//
+// Decompose one matrix with the scalar code; r may be null. Return
+// false, with zero results, if the matrix is degenerate.
+//
+
+template <class T>
+bool
+decomposeScalar (
+    const Matrix44<T>&       mat,
+    Vec3<T>&                 s,
+    Vec3<T>&                 h,
+    Vec3<T>*                 r,
+    typename Euler<T>::Order rOrder)
+{
+    Matrix44<T> rot (mat);
+
+    if (!extractAndRemoveScalingAndShear (rot, s, h, false))
+    {
+        s = Vec3<T> (0);
+        h = Vec3<T> (0);
+        if (r) *r = Vec3<T> (0);
+        return false;
+    }
+
+    if (r) rotationToEuler (rot, *r, rOrder);
+
+    return true;
+}
+
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+
+IMATH_AVX512_KERNELS_BEGIN
+
+//
+// The lanes where checkForZeroScaleInRow (scl, row) would fail
+//
+
+template <class W>
+IMATH_TARGET_AVX512 inline typename W::Mask
+zeroScaleInRow (W scl, const W row[3])
+{
+    typedef typename W::BaseType T;
+
+    const W a     = abs (scl);
+    const W limit = splat (std::numeric_limits<T>::max ()) * a;
+
+    typename W::Mask m = 0;
+
+    for (int i = 0; i < 3; ++i)
+        m |= greaterEqual (abs (row[i]), limit);
+
+    return less (a, splat (T (1))) & m;
+}
+
+//
+// The lanes whose length() would take the lengthTiny() path, and the
+// length of the others
+//
+
+template <class W>
+IMATH_TARGET_AVX512 inline W
+length (const W v[3], typename W::Mask& tiny)
+{
+    typedef typename W::BaseType T;
+
+    const W length2 = v[0] * v[0] + v[1] * v[1] + v[2] * v[2];
+
+    tiny |= less (length2, splat (T (2) * std::numeric_limits<T>::min ()));
+
+    return sqrt (length2);
+}
+
+template <class W>
+IMATH_TARGET_AVX512 inline W
+dot (const W a[3], const W b[3])
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+//
+// Extract the scaling, shear and rotation of the matrices in mask,
+// as extractAndRemoveScalingAndShear() does, into out[0 to 2],
+// out[3 to 5] and out[6 to 14], row by row. Return the lanes in mask
+// that need no help from the scalar code.
+//
+
+template <class W>
+IMATH_TARGET_AVX512 typename W::Mask
+scalingAndShearAVX512 (
+    const Matrix44<typename W::BaseType>* mat,
+    typename W::Mask                      mask,
+    typename W::BaseType                  out[15][W::lanes])
+{
+    typedef typename W::BaseType T;
+    typedef typename W::Mask     Mask;
+
+    W row[3][3];
+
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            row[i][j] = gather (&mat[0][i][j], mask, T (i == j));
+
+    W maxVal = splat (T (0));
+
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+        {
+            const W a = abs (row[i][j]);
+            maxVal    = select (less (maxVal, a), a, maxVal);
+        }
+
+    //
+    // A matrix whose elements are all zero (or NAN) skips the
+    // normalization in the scalar code.
+    //
+
+    Mask scalar = equal (maxVal, splat (T (0)));
+
+    for (int i = 0; i < 3; ++i)
+    {
+        scalar |= zeroScaleInRow (maxVal, row[i]);
+
+        for (int j = 0; j < 3; ++j)
+            row[i][j] = row[i][j] / maxVal;
+    }
+
+    W scl[3], shr[3];
+
+    scl[0] = length (row[0], scalar);
+    scalar |= zeroScaleInRow (scl[0], row[0]);
+
+    for (int j = 0; j < 3; ++j)
+        row[0][j] = row[0][j] / scl[0];
+
+    shr[0] = dot (row[0], row[1]);
+
+    for (int j = 0; j < 3; ++j)
+        row[1][j] = row[1][j] - shr[0] * row[0][j];
+
+    scl[1] = length (row[1], scalar);
+    scalar |= zeroScaleInRow (scl[1], row[1]);
+
+    for (int j = 0; j < 3; ++j)
+        row[1][j] = row[1][j] / scl[1];
+
+    shr[0] = shr[0] / scl[1];
+
+    shr[1] = dot (row[0], row[2]);
+
+    for (int j = 0; j < 3; ++j)
+        row[2][j] = row[2][j] - shr[1] * row[0][j];
+
+    shr[2] = dot (row[1], row[2]);
+
+    for (int j = 0; j < 3; ++j)
+        row[2][j] = row[2][j] - shr[2] * row[1][j];
+
+    scl[2] = length (row[2], scalar);
+    scalar |= zeroScaleInRow (scl[2], row[2]);
+
+    for (int j = 0; j < 3; ++j)
+        row[2][j] = row[2][j] / scl[2];
+
+    shr[1] = shr[1] / scl[2];
+    shr[2] = shr[2] / scl[2];
+
+    //
+    // Negate the scale and the rows of a coordinate system flip.
+    //
+
+    const W cross[3] = {
+        row[1][1] * row[2][2] - row[1][2] * row[2][1],
+        row[1][2] * row[2][0] - row[1][0] * row[2][2],
+        row[1][0] * row[2][1] - row[1][1] * row[2][0]};
+
+    const Mask flip  = less (dot (row[0], cross), splat (T (0)));
+    const W    minus = splat (T (-1));
+
+    for (int i = 0; i < 3; ++i)
+    {
+        scl[i] = select (flip, scl[i] * minus, scl[i]);
+
+        for (int j = 0; j < 3; ++j)
+            row[i][j] = select (flip, row[i][j] * minus, row[i][j]);
+    }
+
+    for (int i = 0; i < 3; ++i)
+    {
+        store (out[i], scl[i] * maxVal);
+        store (out[3 + i], shr[i]);
+
+        for (int j = 0; j < 3; ++j)
+            store (out[6 + 3 * i + j], row[i][j]);
+    }
+
+    return mask & Mask (~scalar);
+}
+
+template <class W>
+IMATH_TARGET_AVX512 size_t
+decomposeAVX512 (
+    const Matrix44<typename W::BaseType>*       mat,
+    Vec3<typename W::BaseType>*                 s,
+    Vec3<typename W::BaseType>*                 h,
+    Vec3<typename W::BaseType>*                 r,
+    size_t                                      n,
+    bool*                                       degenerate,
+    typename Euler<typename W::BaseType>::Order rOrder)
+{
+    typedef typename W::BaseType T;
+    typedef typename W::Mask     Mask;
+
+    size_t count = 0;
+
+    for (size_t i = 0; i < n; i += W::lanes)
+    {
+        const size_t k    = laneCount<W> (n, i);
+        const Mask   mask = Mask ((1u << k) - 1);
+
+        T          out[15][W::lanes];
+        const Mask done = scalingAndShearAVX512<W> (&mat[i], mask, out);
+
+        for (size_t j = 0; j < k; ++j)
+        {
+            bool bad = false;
+
+            if ((done >> j) & 1)
+            {
+                s[i + j] = Vec3<T> (out[0][j], out[1][j], out[2][j]);
+                h[i + j] = Vec3<T> (out[3][j], out[4][j], out[5][j]);
+
+                if (r)
+                {
+                    Matrix44<T> rot;
+
+                    for (int a = 0; a < 3; ++a)
+                        for (int b = 0; b < 3; ++b)
+                            rot[a][b] = out[6 + 3 * a + b][j];
+
+                    rotationToEuler (rot, r[i + j], rOrder);
+                }
+            }
+            else
+            {
+                bad = !decomposeScalar (
+                    mat[i + j], s[i + j], h[i + j], r ? &r[i + j] : 0, rOrder);
+            }
+
+            if (degenerate) degenerate[i + j] = bad;
+
+            count += bad;
+        }
+    }
+
+    return count;
+}
+
+//
+// The register types of the decomposition kernel for each base type
+//
+
+template <class T> struct DecompositionKernel;
+
+template <> struct DecompositionKernel<float>
+{
+    typedef FloatLanes16 AVX512;
+};
+
+template <> struct DecompositionKernel<double>
+{
+    typedef DoubleLanes8 AVX512;
+};
+
+IMATH_AVX512_KERNELS_END
+
+#endif // IMATH_X86_RUNTIME_DISPATCH
+
+//
+// Decompose n matrices; r and t may be null
+//
+
+template <class T>
+size_t
+decomposeMatrices (
+    const Matrix44<T>*       mat,
+    Vec3<T>*                 s,
+    Vec3<T>*                 h,
+    Vec3<T>*                 r,
+    Vec3<T>*                 t,
+    size_t                   n,
+    bool*                    degenerate,
+    typename Euler<T>::Order rOrder)
+{
+    if (t)
+    {
+        for (size_t i = 0; i < n; ++i)
+            t[i] = Vec3<T> (mat[i][3][0], mat[i][3][1], mat[i][3][2]);
+    }
+
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+    if (imathCpuFeatures ().avx512f)
+    {
+        return decomposeAVX512<typename DecompositionKernel<T>::AVX512> (
+            mat, s, h, r, n, degenerate, rOrder);
+    }
+#endif
+
+    size_t count = 0;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const bool bad =
+            !decomposeScalar (mat[i], s[i], h[i], r ? &r[i] : 0, rOrder);
+
+        if (degenerate) degenerate[i] = bad;
+
+        count += bad;
+    }
+
+    return count;
+}
+
+} // namespace
+
+IMATH_EXPORT size_t
+extractScalingAndShearArray (
+    const M44f* mat, V3f* scl, V3f* shr, size_t n, bool* degenerate)
+    IMATH_NOEXCEPT
+{
+    return decomposeMatrices<float> (
+        mat, scl, shr, 0, 0, n, degenerate, Eulerf::XYZ);
+}
+
+IMATH_EXPORT size_t
+extractScalingAndShearArray (
+    const M44d* mat, V3d* scl, V3d* shr, size_t n, bool* degenerate)
+    IMATH_NOEXCEPT
+{
+    return decomposeMatrices<double> (
+        mat, scl, shr, 0, 0, n, degenerate, Eulerd::XYZ);
+}
+
+IMATH_EXPORT void
+extractEulerXYZArray (const M44f* mat, V3f* rot, size_t n) IMATH_NOEXCEPT
+{
+    for (size_t i = 0; i < n; ++i)
+        extractEulerXYZ (mat[i], rot[i]);
+}
+
+IMATH_EXPORT void
+extractEulerXYZArray (const M44d* mat, V3d* rot, size_t n) IMATH_NOEXCEPT
+{
+    for (size_t i = 0; i < n; ++i)
+        extractEulerXYZ (mat[i], rot[i]);
+}
+
+IMATH_EXPORT size_t
+extractSHRTArray (
+    const M44f*   mat,
+    V3f*          s,
+    V3f*          h,
+    V3f*          r,
+    V3f*          t,
+    size_t        n,
+    bool*         degenerate,
+    Eulerf::Order rOrder) IMATH_NOEXCEPT
+{
+    return decomposeMatrices (mat, s, h, r, t, n, degenerate, rOrder);
+}
+
+IMATH_EXPORT size_t
+extractSHRTArray (
+    const M44d*   mat,
+    V3d*          s,
+    V3d*          h,
+    V3d*          r,
+    V3d*          t,
+    size_t        n,
+    bool*         degenerate,
+    Eulerd::Order rOrder) IMATH_NOEXCEPT
+{
+    return decomposeMatrices (mat, s, h, r, t, n, degenerate, rOrder);
+}
+
+namespace
+{
+
+//
+// Conversion of arrays of rotation matrices to quaternions, exactly as
+// extractQuat() converts them. The kernel evaluates the formulas of
+// all four of extractQuat()'s cases in every lane, and selects the
+// results of the case that extractQuat() would take, so that the
+// matrices are converted without branches.
+//
+
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+
+IMATH_AVX512_KERNELS_BEGIN
+
+template <class W, int N>
+IMATH_TARGET_AVX512 void
+extractQuatAVX512 (
+    const typename W::BaseType* mat, Quat<typename W::BaseType>* q, size_t n)
+{
+    typedef typename W::BaseType T;
+    typedef typename W::Mask     Mask;
+
+    const W zero = splat (T (0));
+    const W one  = splat (T (1));
+    const W half = splat (T (0.5));
+
+    for (size_t i = 0; i < n; i += W::lanes)
+    {
+        const size_t k    = laneCount<W> (n, i);
+        const Mask   mask = Mask ((1u << k) - 1);
+
+        const T* p = mat + i * N * N;
+
+        W m[3][3];
+
+        for (int a = 0; a < 3; ++a)
+        {
+            for (int b = 0; b < 3; ++b)
+                m[a][b] = gather<N * N> (p + a * N + b, mask, T (a == b));
+        }
+
+        //
+        // The case: the trace, if it is positive, or else the largest
+        // diagonal element, the first of equal ones
+        //
+
+        const W tr = m[0][0] + m[1][1] + m[2][2];
+
+        const Mask useR = less (zero, tr);
+        const Mask sel1 = less (m[0][0], m[1][1]);
+        const Mask sel2 = less (select (sel1, m[1][1], m[0][0]), m[2][2]);
+        const Mask useZ = Mask (~useR & sel2);
+        const Mask useY = Mask (~useR & sel1 & ~sel2);
+        const Mask useX = Mask (~useR & ~sel1 & ~sel2);
+
+        W arg = tr + one;
+        arg   = select (useX, (m[0][0] - (m[1][1] + m[2][2])) + one, arg);
+        arg   = select (useY, (m[1][1] - (m[2][2] + m[0][0])) + one, arg);
+        arg   = select (useZ, (m[2][2] - (m[0][0] + m[1][1])) + one, arg);
+
+        const W s     = sqrt (arg);
+        const W large = s * half;
+        const W scale = select (equal (s, zero), zero, half / s);
+
+        //
+        // The differences and sums of the off-diagonal elements that
+        // give the other three components
+        //
+
+        const W d0 = (m[1][2] - m[2][1]) * scale;
+        const W d1 = (m[2][0] - m[0][2]) * scale;
+        const W d2 = (m[0][1] - m[1][0]) * scale;
+        const W s2 = (m[0][1] + m[1][0]) * scale;
+        const W s1 = (m[0][2] + m[2][0]) * scale;
+        const W s0 = (m[1][2] + m[2][1]) * scale;
+
+        W c[4];
+
+        c[0] = select (useR, large, select (useX, d0, select (useY, d1, d2)));
+        c[1] = select (useR, d0, select (useX, large, select (useY, s2, s1)));
+        c[2] = select (useR, d1, select (useX, s2, select (useY, large, s0)));
+        c[3] = select (useR, d2, select (useX, s1, select (useY, s0, large)));
+
+        for (int j = 0; j < 4; ++j)
+            scatter<4> (&q[i].r + j, mask, c[j]);
+    }
+}
+
+//
+// The register types of the conversion kernel for each base type
+//
+
+template <class T> struct ConversionKernel;
+
+template <> struct ConversionKernel<float>
+{
+    typedef FloatLanes16 AVX512;
+};
+
+template <> struct ConversionKernel<double>
+{
+    typedef DoubleLanes8 AVX512;
+};
+
+IMATH_AVX512_KERNELS_END
+
+#endif // IMATH_X86_RUNTIME_DISPATCH
+
+template <class T>
+void
+extractQuats (const Matrix33<T>* mat, Quat<T>* q, size_t n)
+{
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+    if (imathCpuFeatures ().avx512f)
+    {
+        extractQuatAVX512<typename ConversionKernel<T>::AVX512, 3> (
+            &mat->x[0][0], q, n);
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < n; ++i)
+        q[i] = extractQuat (Matrix44<T> (mat[i], Vec3<T> (0)));
+}
+
+template <class T>
+void
+extractQuats (const Matrix44<T>* mat, Quat<T>* q, size_t n)
+{
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+    if (imathCpuFeatures ().avx512f)
+    {
+        extractQuatAVX512<typename ConversionKernel<T>::AVX512, 4> (
+            &mat->x[0][0], q, n);
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < n; ++i)
+        q[i] = extractQuat (mat[i]);
+}
+
+} // namespace
+
+IMATH_EXPORT void
+extractQuatArray (const M33f* mat, Quatf* q, size_t n) IMATH_NOEXCEPT
+{
+    extractQuats (mat, q, n);
+}
+
+IMATH_EXPORT void
+extractQuatArray (const M33d* mat, Quatd* q, size_t n) IMATH_NOEXCEPT
+{
+    extractQuats (mat, q, n);
+}
+
+IMATH_EXPORT void
+extractQuatArray (const M44f* mat, Quatf* q, size_t n) IMATH_NOEXCEPT
+{
+    extractQuats (mat, q, n);
+}
+
+IMATH_EXPORT void
+extractQuatArray (const M44d* mat, Quatd* q, size_t n) IMATH_NOEXCEPT
+{
+    extractQuats (mat, q, n);
+}
+
+namespace
+{
+
+//
+// Eigen decomposition of arrays of symmetric 3x3 matrices. Both
+// solvers sort the eigenvalues in decreasing order, and make the
+// matrix of eigenvectors a rotation, so that their results can be
+// compared and exchanged.
+//
+
+template <class T>
+void
+sortEigen (T S[3], T V[3][3])
+{
+    bool odd = false;
+
+    const int pairs[3][2] = {{0, 1}, {1, 2}, {0, 1}};
+
+    for (const auto& p: pairs)
+    {
+        const int i = p[0];
+        const int j = p[1];
+
+        if (S[i] < S[j])
+        {
+            std::swap (S[i], S[j]);
+
+            for (int k = 0; k < 3; ++k)
+                std::swap (V[k][i], V[k][j]);
+
+            odd = !odd;
+        }
+    }
+
+    if (odd)
+        for (int k = 0; k < 3; ++k)
+            V[k][2] = -V[k][2];
+}
+
+template <class T>
+void
+storeEigen (const T S[3], const T V[3][3], T* s, T* v, size_t i, size_t stride)
+{
+    for (int k = 0; k < 3; ++k)
+        s[k * stride + i] = S[k];
+
+    for (int j = 0; j < 3; ++j)
+        for (int k = 0; k < 3; ++k)
+            v[(3 * j + k) * stride + i] = V[j][k];
+}
+
+template <class T>
+void
+jacobiEigenScalar (const Matrix33<T>& A, T* s, T* v, size_t i, size_t stride)
+{
+    Matrix33<T> AA (A);
+    Vec3<T>     S;
+    Matrix33<T> V;
+
+    for (int j = 0; j < 3; ++j)
+        for (int k = 0; k < j; ++k)
+            AA[j][k] = AA[k][j];
+
+    jacobiEigenSolver (AA, S, V);
+
+    T SS[3] = {S[0], S[1], S[2]};
+    T VV[3][3];
+
+    for (int j = 0; j < 3; ++j)
+        for (int k = 0; k < 3; ++k)
+            VV[j][k] = V[j][k];
+
+    sortEigen (SS, VV);
+    storeEigen (SS, VV, s, v, i, stride);
+}
+
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+
+IMATH_AVX512_KERNELS_BEGIN
+
+//
+// One Jacobi rotation in the (p, q) plane, which zeroes apq, as in
+// Numerical Recipes; r is the third index. The rotation is skipped
+// in lanes where apq is already zero.
+//
+
+template <class W>
+IMATH_TARGET_AVX512 inline void
+jacobiRotate (W& app, W& aqq, W& apq, W& arp, W& arq, W vp[3], W vq[3])
+{
+    typedef typename W::BaseType T;
+
+    const W zero = splat (T (0));
+    const W one  = splat (T (1));
+
+    const W theta = (aqq - app) / (apq + apq);
+
+    W t = one / (abs (theta) + sqrt (theta * theta + one));
+    t   = select (less (theta, zero), zero - t, t);
+    t   = select (equal (apq, zero), zero, t);
+
+    const W c = one / sqrt (t * t + one);
+    const W s = t * c;
+
+    app = app - t * apq;
+    aqq = aqq + t * apq;
+    apq = zero;
+
+    const W rp = arp;
+    const W rq = arq;
+
+    arp = c * rp - s * rq;
+    arq = s * rp + c * rq;
+
+    for (int j = 0; j < 3; ++j)
+    {
+        const W jp = vp[j];
+        const W jq = vq[j];
+
+        vp[j] = c * jp - s * jq;
+        vq[j] = s * jp + c * jq;
+    }
+}
+
+//
+// Cyclic Jacobi with a fixed number of sweeps, 16 (float) or 8
+// (double) matrices at a time. Each sweep at least squares the
+// off-diagonal norm once the rotation angles are small, so a few
+// sweeps converge to the precision of T.
+//
+
+template <class W>
+IMATH_TARGET_AVX512 void
+jacobiEigenAVX512 (
+    const Matrix33<typename W::BaseType>* A,
+    typename W::BaseType*                 s,
+    typename W::BaseType*                 v,
+    size_t                                n,
+    size_t                                stride)
+{
+    typedef typename W::BaseType T;
+    typedef typename W::Mask     Mask;
+
+    const int sweeps = sizeof (T) == sizeof (float) ? 4 : 5;
+
+    for (size_t i = 0; i < n; i += W::lanes)
+    {
+        const size_t k    = laneCount<W> (n, i);
+        const Mask   mask = Mask ((1u << k) - 1);
+
+        W a00 = gather<9> (&A[i][0][0], mask, T (0));
+        W a11 = gather<9> (&A[i][1][1], mask, T (0));
+        W a22 = gather<9> (&A[i][2][2], mask, T (0));
+        W a01 = gather<9> (&A[i][0][1], mask, T (0));
+        W a02 = gather<9> (&A[i][0][2], mask, T (0));
+        W a12 = gather<9> (&A[i][1][2], mask, T (0));
+
+        //
+        // The columns of the matrix of eigenvectors
+        //
+
+        W V[3][3];
+
+        for (int c = 0; c < 3; ++c)
+            for (int j = 0; j < 3; ++j)
+                V[c][j] = splat (T (c == j));
+
+        for (int sweep = 0; sweep < sweeps; ++sweep)
+        {
+            jacobiRotate (a00, a11, a01, a02, a12, V[0], V[1]);
+            jacobiRotate (a00, a22, a02, a01, a12, V[0], V[2]);
+            jacobiRotate (a11, a22, a12, a01, a02, V[1], V[2]);
+        }
+
+        //
+        // Sort, as sortEigen() does
+        //
+
+        W    S[3] = {a00, a11, a22};
+        Mask odd  = 0;
+
+        const int pairs[3][2] = {{0, 1}, {1, 2}, {0, 1}};
+
+        for (const auto& p: pairs)
+        {
+            const W    si   = S[p[0]];
+            const W    sj   = S[p[1]];
+            const Mask swap = less (si, sj);
+
+            S[p[0]] = select (swap, sj, si);
+            S[p[1]] = select (swap, si, sj);
+
+            for (int j = 0; j < 3; ++j)
+            {
+                const W vi = V[p[0]][j];
+                const W vj = V[p[1]][j];
+
+                V[p[0]][j] = select (swap, vj, vi);
+                V[p[1]][j] = select (swap, vi, vj);
+            }
+
+            odd ^= swap;
+        }
+
+        for (int j = 0; j < 3; ++j)
+            V[2][j] = select (odd, splat (T (0)) - V[2][j], V[2][j]);
+
+        for (int c = 0; c < 3; ++c)
+            store (&s[c * stride + i], mask, S[c]);
+
+        for (int j = 0; j < 3; ++j)
+            for (int c = 0; c < 3; ++c)
+                store (&v[(3 * j + c) * stride + i], mask, V[c][j]);
+    }
+}
+
+template <class T> struct EigenKernel;
+
+template <> struct EigenKernel<float>
+{
+    typedef FloatLanes16 AVX512;
+};
+
+template <> struct EigenKernel<double>
+{
+    typedef DoubleLanes8 AVX512;
+};
+
+IMATH_AVX512_KERNELS_END
+
+#endif // IMATH_X86_RUNTIME_DISPATCH
+
+template <class T>
+void
+jacobiEigenMatrices (
+    const Matrix33<T>* A, T* s, T* v, size_t n, size_t stride)
+{
+    if (stride == 0) stride = n;
+
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+    if (imathCpuFeatures ().avx512f)
+    {
+        jacobiEigenAVX512<typename EigenKernel<T>::AVX512> (
+            A, s, v, n, stride);
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < n; ++i)
+        jacobiEigenScalar (A[i], s, v, i, stride);
+}
+
+//
+// The eigenvector of the symmetric matrix a for the eigenvalue e
+// that is farthest from the other two: the rows of a - e*I span a
+// plane, whose normal is the cross product of two of them. The
+// largest of the three cross products is the most accurate.
+//
+
+template <class T>
+Vec3<T>
+eigenvector0 (const T a[3][3], T e)
+{
+    const Vec3<T> r0 (a[0][0] - e, a[0][1], a[0][2]);
+    const Vec3<T> r1 (a[0][1], a[1][1] - e, a[1][2]);
+    const Vec3<T> r2 (a[0][2], a[1][2], a[2][2] - e);
+
+    const Vec3<T> c01 = r0.cross (r1);
+    const Vec3<T> c02 = r0.cross (r2);
+    const Vec3<T> c12 = r1.cross (r2);
+
+    const T d01 = c01.length2 ();
+    const T d02 = c02.length2 ();
+    const T d12 = c12.length2 ();
+
+    if (d01 >= d02 && d01 >= d12) return c01 / std::sqrt (d01);
+    if (d02 >= d12) return c02 / std::sqrt (d02);
+    return c12 / std::sqrt (d12);
+}
+
+template <class T>
+Vec3<T>
+symmetricTimes (const T a[3][3], const Vec3<T>& u)
+{
+    return Vec3<T> (
+        a[0][0] * u.x + a[0][1] * u.y + a[0][2] * u.z,
+        a[0][1] * u.x + a[1][1] * u.y + a[1][2] * u.z,
+        a[0][2] * u.x + a[1][2] * u.y + a[2][2] * u.z);
+}
+
+//
+// The closed-form solution, after D. Eberly, "A Robust Eigensolver
+// for 3x3 Symmetric Matrices": the eigenvalues are the roots of the
+// characteristic polynomial, found with the trigonometric formula
+// for three real roots. Only the eigenvalue that is farthest from
+// the other two is accurate enough to compute its eigenvector w; the
+// other two are found by diagonalizing the restriction of the
+// matrix to the plane orthogonal to w with a single rotation, and
+// all three eigenvalues are then recomputed as Rayleigh quotients.
+//
+
+template <class T>
+void
+analyticEigenScalar (const Matrix33<T>& A, T* s, T* v, size_t i, size_t stride)
+{
+    T S[3];
+    T V[3][3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+
+    //
+    // Scale the matrix to avoid overflow and underflow.
+    //
+
+    T a[3][3];
+    T scale = 0;
+
+    for (int j = 0; j < 3; ++j)
+        for (int k = j; k < 3; ++k)
+            scale = std::max (scale, std::abs (A[j][k]));
+
+    for (int j = 0; j < 3; ++j)
+        S[j] = A[j][j];
+
+    if (!(scale > 0) || !(scale <= std::numeric_limits<T>::max ()))
+    {
+        //
+        // Zero, or not finite
+        //
+
+        sortEigen (S, V);
+        storeEigen (S, V, s, v, i, stride);
+        return;
+    }
+
+    for (int j = 0; j < 3; ++j)
+        for (int k = j; k < 3; ++k)
+            a[j][k] = a[k][j] = A[j][k] / scale;
+
+    const T offDiagonal =
+        a[0][1] * a[0][1] + a[0][2] * a[0][2] + a[1][2] * a[1][2];
+
+    if (offDiagonal > 0)
+    {
+        const T q   = (a[0][0] + a[1][1] + a[2][2]) / 3;
+        const T b00 = a[0][0] - q;
+        const T b11 = a[1][1] - q;
+        const T b22 = a[2][2] - q;
+        const T p   = std::sqrt (
+            (b00 * b00 + b11 * b11 + b22 * b22 + 2 * offDiagonal) / 6);
+
+        //
+        // The determinant of (a - q*I) / p, which lies in [-2, 2].
+        // If it is positive, the largest eigenvalue is the farthest
+        // from the other two, otherwise the smallest is.
+        //
+
+        const T c00 = b11 * b22 - a[1][2] * a[1][2];
+        const T c01 = a[0][1] * b22 - a[1][2] * a[0][2];
+        const T c02 = a[0][1] * a[1][2] - b11 * a[0][2];
+        const T det =
+            (b00 * c00 - a[0][1] * c01 + a[0][2] * c02) / (p * p * p);
+
+        const T halfDet = std::min (std::max (det / 2, T (-1)), T (1));
+        const T angle   = std::acos (halfDet) / 3;
+
+        const T twoThirdsPi = T (2.09439510239319549);
+        const T beta        = halfDet >= 0 ? 2 * std::cos (angle)
+                                           : 2 * std::cos (angle + twoThirdsPi);
+
+        const Vec3<T> w = eigenvector0 (a, q + p * beta);
+
+        //
+        // An orthonormal basis u, v of the plane orthogonal to w,
+        // with u x v = w
+        //
+
+        Vec3<T> u;
+
+        if (std::abs (w.x) > std::abs (w.y))
+        {
+            const T inv = 1 / std::sqrt (w.x * w.x + w.z * w.z);
+            u           = Vec3<T> (-w.z * inv, 0, w.x * inv);
+        }
+        else
+        {
+            const T inv = 1 / std::sqrt (w.y * w.y + w.z * w.z);
+            u           = Vec3<T> (0, w.z * inv, -w.y * inv);
+        }
+
+        const Vec3<T> v = w.cross (u);
+
+        const Vec3<T> au = symmetricTimes (a, u);
+        const Vec3<T> av = symmetricTimes (a, v);
+
+        const T m00 = u.dot (au);
+        const T m01 = u.dot (av);
+        const T m11 = v.dot (av);
+
+        //
+        // The rotation that diagonalizes the restriction, as in
+        // jacobiRotate()
+        //
+
+        T t = 0;
+
+        if (m01 != 0)
+        {
+            const T theta = (m11 - m00) / (m01 + m01);
+
+            t = 1 / (std::abs (theta) + std::sqrt (theta * theta + 1));
+            if (theta < 0) t = -t;
+        }
+
+        const T c  = 1 / std::sqrt (t * t + 1);
+        const T sn = t * c;
+
+        const Vec3<T> e[3] = {w, c * u - sn * v, sn * u + c * v};
+
+        for (int k = 0; k < 3; ++k)
+        {
+            S[k] = e[k].dot (symmetricTimes (a, e[k])) * scale;
+
+            for (int j = 0; j < 3; ++j)
+                V[j][k] = e[k][j];
+        }
+    }
+
+    sortEigen (S, V);
+    storeEigen (S, V, s, v, i, stride);
+}
+
+template <class T>
+void
+analyticEigenMatrices (
+    const Matrix33<T>* A, T* s, T* v, size_t n, size_t stride)
+{
+    if (stride == 0) stride = n;
+
+    for (size_t i = 0; i < n; ++i)
+        analyticEigenScalar (A[i], s, v, i, stride);
+}
+
+} // namespace
+
+IMATH_EXPORT void
+jacobiEigenSolverArray (
+    const M33f* A, float* S, float* V, size_t n, size_t stride) IMATH_NOEXCEPT
+{
+    jacobiEigenMatrices (A, S, V, n, stride);
+}
+
+IMATH_EXPORT void
+jacobiEigenSolverArray (
+    const M33d* A, double* S, double* V, size_t n, size_t stride)
+    IMATH_NOEXCEPT
+{
+    jacobiEigenMatrices (A, S, V, n, stride);
+}
+
+IMATH_EXPORT void
+analyticEigenSolverArray (
+    const M33f* A, float* S, float* V, size_t n, size_t stride) IMATH_NOEXCEPT
+{
+    analyticEigenMatrices (A, S, V, n, stride);
+}
+
+IMATH_EXPORT void
+analyticEigenSolverArray (
+    const M33d* A, double* S, double* V, size_t n, size_t stride)
+    IMATH_NOEXCEPT
+{
+    analyticEigenMatrices (A, S, V, n, stride);
+}
+
+namespace
+{
+
+//
+// A fixed-sweep 3x3 SVD after McAdams et al., "Computing the Singular
+// Value Decomposition of 3x3 matrices with minimal branching and
+// elementary floating point operations": Jacobi sweeps orthogonalize
+// the columns of B = A * V, the columns are sorted by decreasing
+// length, and Givens rotations reduce B to an upper triangular
+// R = U^T * B, whose diagonal is S. The number of operations is
+// fixed, and the only conditionals are selects, so the scalar and
+// AVX-512 versions below execute the same operations in the same
+// order and give identical results.
+//
+// Unlike McAdams et al., the rotations are one-sided (Hestenes)
+// Jacobi rotations, computed from the columns of B rather than from
+// A^T * A, which would square the condition number and lose the
+// small singular values, and they use exact rather than approximate
+// angles. The matrix is scaled by its largest entry, so that the
+// squared column lengths neither overflow nor underflow.
+//
+
+const int svdSweeps = 4;
+
+//
+// The rotation of columns p and q of B that makes them orthogonal,
+// applied to the same columns of V
+//
+
+inline void
+hestenesRotate (float bp[3], float bq[3], float vp[3], float vq[3])
+{
+    const float app = bp[0] * bp[0] + bp[1] * bp[1] + bp[2] * bp[2];
+    const float aqq = bq[0] * bq[0] + bq[1] * bq[1] + bq[2] * bq[2];
+    const float apq = bp[0] * bq[0] + bp[1] * bq[1] + bp[2] * bq[2];
+
+    const float theta = (aqq - app) / (apq + apq);
+
+    float t = 1 / (std::abs (theta) + std::sqrt (theta * theta + 1));
+    t       = theta < 0 ? 0 - t : t;
+    t       = apq == 0 ? 0 : t;
+
+    const float c = 1 / std::sqrt (t * t + 1);
+    const float s = t * c;
+
+    for (int j = 0; j < 3; ++j)
+    {
+        const float jp = bp[j];
+        const float jq = bq[j];
+
+        bp[j] = c * jp - s * jq;
+        bq[j] = s * jp + c * jq;
+
+        const float kp = vp[j];
+        const float kq = vq[j];
+
+        vp[j] = c * kp - s * kq;
+        vq[j] = s * kp + c * kq;
+    }
+}
+
+//
+// Swap columns i and j of B and V if column i of B is shorter, and
+// negate the new column j, so that B * V^T and det(V) are unchanged.
+//
+
+inline void
+svdSort (float B[3][3], float V[3][3], float rho[3], int i, int j)
+{
+    const bool swap = rho[i] < rho[j];
+
+    for (int k = 0; k < 3; ++k)
+    {
+        const float bi = B[i][k];
+        const float bj = B[j][k];
+        const float vi = V[i][k];
+        const float vj = V[j][k];
+
+        B[i][k] = swap ? bj : bi;
+        B[j][k] = swap ? 0 - bi : bj;
+        V[i][k] = swap ? vj : vi;
+        V[j][k] = swap ? 0 - vi : vj;
+    }
+
+    const float ri = rho[i];
+    const float rj = rho[j];
+
+    rho[i] = swap ? rj : ri;
+    rho[j] = swap ? ri : rj;
+}
+
+//
+// The Givens rotation of rows p and q of B that zeroes element q of
+// column c, accumulated into the columns of U. Elements too small
+// for their squares to be normalized are left alone, as the rotation
+// would not be accurate.
+//
+
+inline void
+svdGivens (float B[3][3], float U[3][3], int c, int p, int q)
+{
+    const float a    = B[c][p];
+    const float b    = B[c][q];
+    const float r2   = a * a + b * b;
+    const float inv  = 1 / std::sqrt (r2);
+    const bool  tiny = r2 < std::numeric_limits<float>::min ();
+    const float cs   = tiny ? 1 : a * inv;
+    const float sn   = tiny ? 0 : b * inv;
+
+    for (int k = 0; k < 3; ++k)
+    {
+        const float x = B[k][p];
+        const float y = B[k][q];
+
+        B[k][p] = cs * x + sn * y;
+        B[k][q] = cs * y - sn * x;
+
+        const float up = U[p][k];
+        const float uq = U[q][k];
+
+        U[p][k] = cs * up + sn * uq;
+        U[q][k] = cs * uq - sn * up;
+    }
+}
+
+//
+// A rotation skipped by svdGivens() leaves element c of the diagonal
+// of R with the sign it had, which may be negative for a matrix of
+// low rank. Move a negative sign to the last element, negating
+// columns c and 2 of U, so that only the last singular value is
+// negative and U remains a rotation.
+//
+
+inline void
+svdSign (float B[3][3], float U[3][3], int c)
+{
+    const bool neg = B[c][c] < 0;
+
+    B[c][c] = neg ? 0 - B[c][c] : B[c][c];
+    B[2][2] = neg ? 0 - B[2][2] : B[2][2];
+
+    for (int k = 0; k < 3; ++k)
+    {
+        U[c][k] = neg ? 0 - U[c][k] : U[c][k];
+        U[2][k] = neg ? 0 - U[2][k] : U[2][k];
+    }
+}
+
+//
+// The arrays hold columns: B[c][i] is element [i][c] of B.
+//
+
+void
+fastSVDScalar (const M33f& A, float U[3][3], float S[3], float V[3][3])
+{
+    float scale = 0;
+
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+        {
+            const float x = std::abs (A[i][j]);
+            scale         = scale < x ? x : scale;
+        }
+
+    scale = scale == 0 ? 1 : scale;
+
+    const float inv = 1 / scale;
+    float       a[3][3];
+
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            a[i][j] = A[i][j] * inv;
+
+    //
+    // B = A * V, with orthogonal columns
+    //
+
+    float B[3][3];
+    float rho[3];
+
+    for (int c = 0; c < 3; ++c)
+        for (int j = 0; j < 3; ++j)
+        {
+            B[c][j] = a[j][c];
+            V[c][j] = c == j;
+        }
+
+    for (int sweep = 0; sweep < svdSweeps; ++sweep)
+    {
+        hestenesRotate (B[0], B[1], V[0], V[1]);
+        hestenesRotate (B[0], B[2], V[0], V[2]);
+        hestenesRotate (B[1], B[2], V[1], V[2]);
+    }
+
+    //
+    // Sort the columns by decreasing length
+    //
+
+    for (int c = 0; c < 3; ++c)
+        rho[c] = B[c][0] * B[c][0] + B[c][1] * B[c][1] + B[c][2] * B[c][2];
+
+    svdSort (B, V, rho, 0, 1);
+    svdSort (B, V, rho, 0, 2);
+    svdSort (B, V, rho, 1, 2);
+
+    //
+    // B = U * R
+    //
+
+    for (int c = 0; c < 3; ++c)
+        for (int j = 0; j < 3; ++j)
+            U[c][j] = c == j;
+
+    svdGivens (B, U, 0, 0, 1);
+    svdGivens (B, U, 0, 0, 2);
+    svdGivens (B, U, 1, 1, 2);
+
+    svdSign (B, U, 0);
+    svdSign (B, U, 1);
+
+    for (int c = 0; c < 3; ++c)
+        S[c] = B[c][c] * scale;
+}
+
+void
+storeSVD (
+    const float u[3][3],
+    const float s[3],
+    const float v[3][3],
+    M33f&       U,
+    V3f&        S,
+    M33f&       V)
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        S[i] = s[i];
+
+        for (int j = 0; j < 3; ++j)
+        {
+            U[i][j] = u[j][i];
+            V[i][j] = v[j][i];
+        }
+    }
+}
+
+//
+// R = U * V^T and P = V * S * V^T
+//
+
+void
+storePolar (
+    const float u[3][3],
+    const float s[3],
+    const float v[3][3],
+    M33f&       R,
+    M33f&       P)
+{
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            R[i][j] = u[0][i] * v[0][j] + u[1][i] * v[1][j] + u[2][i] * v[2][j];
+
+    for (int i = 0; i < 3; ++i)
+        for (int j = i; j < 3; ++j)
+            P[i][j] = P[j][i] = v[0][i] * s[0] * v[0][j] +
+                                v[1][i] * s[1] * v[1][j] +
+                                v[2][i] * s[2] * v[2][j];
+}
+
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+
+IMATH_AVX512_KERNELS_BEGIN
+
+IMATH_TARGET_AVX512 inline void
+hestenesRotate (
+    FloatLanes16 bp[3],
+    FloatLanes16 bq[3],
+    FloatLanes16 vp[3],
+    FloatLanes16 vq[3])
+{
+    const FloatLanes16 zero = splat (0.0f);
+    const FloatLanes16 one  = splat (1.0f);
+
+    const FloatLanes16 app = bp[0] * bp[0] + bp[1] * bp[1] + bp[2] * bp[2];
+    const FloatLanes16 aqq = bq[0] * bq[0] + bq[1] * bq[1] + bq[2] * bq[2];
+    const FloatLanes16 apq = bp[0] * bq[0] + bp[1] * bq[1] + bp[2] * bq[2];
+
+    const FloatLanes16 theta = (aqq - app) / (apq + apq);
+
+    FloatLanes16 t = one / (abs (theta) + sqrt (theta * theta + one));
+    t              = select (less (theta, zero), zero - t, t);
+    t              = select (equal (apq, zero), zero, t);
+
+    const FloatLanes16 c = one / sqrt (t * t + one);
+    const FloatLanes16 s = t * c;
+
+    for (int j = 0; j < 3; ++j)
+    {
+        const FloatLanes16 jp = bp[j];
+        const FloatLanes16 jq = bq[j];
+
+        bp[j] = c * jp - s * jq;
+        bq[j] = s * jp + c * jq;
+
+        const FloatLanes16 kp = vp[j];
+        const FloatLanes16 kq = vq[j];
+
+        vp[j] = c * kp - s * kq;
+        vq[j] = s * kp + c * kq;
+    }
+}
+
+IMATH_TARGET_AVX512 inline void
+svdSort (
+    FloatLanes16 B[3][3],
+    FloatLanes16 V[3][3],
+    FloatLanes16 rho[3],
+    int          i,
+    int          j)
+{
+    const __mmask16    swap = less (rho[i], rho[j]);
+    const FloatLanes16 zero = splat (0.0f);
+
+    for (int k = 0; k < 3; ++k)
+    {
+        const FloatLanes16 bi = B[i][k];
+        const FloatLanes16 bj = B[j][k];
+        const FloatLanes16 vi = V[i][k];
+        const FloatLanes16 vj = V[j][k];
+
+        B[i][k] = select (swap, bj, bi);
+        B[j][k] = select (swap, zero - bi, bj);
+        V[i][k] = select (swap, vj, vi);
+        V[j][k] = select (swap, zero - vi, vj);
+    }
+
+    const FloatLanes16 ri = rho[i];
+    const FloatLanes16 rj = rho[j];
+
+    rho[i] = select (swap, rj, ri);
+    rho[j] = select (swap, ri, rj);
+}
+
+IMATH_TARGET_AVX512 inline void
+svdGivens (FloatLanes16 B[3][3], FloatLanes16 U[3][3], int c, int p, int q)
+{
+    const FloatLanes16 a    = B[c][p];
+    const FloatLanes16 b    = B[c][q];
+    const FloatLanes16 r2   = a * a + b * b;
+    const FloatLanes16 inv  = splat (1.0f) / sqrt (r2);
+    const FloatLanes16 min  = splat (std::numeric_limits<float>::min ());
+    const __mmask16    tiny = less (r2, min);
+    const FloatLanes16 cs   = select (tiny, splat (1.0f), a * inv);
+    const FloatLanes16 sn   = select (tiny, splat (0.0f), b * inv);
+
+    for (int k = 0; k < 3; ++k)
+    {
+        const FloatLanes16 x = B[k][p];
+        const FloatLanes16 y = B[k][q];
+
+        B[k][p] = cs * x + sn * y;
+        B[k][q] = cs * y - sn * x;
+
+        const FloatLanes16 up = U[p][k];
+        const FloatLanes16 uq = U[q][k];
+
+        U[p][k] = cs * up + sn * uq;
+        U[q][k] = cs * uq - sn * up;
+    }
+}
+
+IMATH_TARGET_AVX512 inline void
+svdSign (FloatLanes16 B[3][3], FloatLanes16 U[3][3], int c)
+{
+    const FloatLanes16 zero = splat (0.0f);
+    const __mmask16    neg  = less (B[c][c], zero);
+
+    B[c][c] = select (neg, zero - B[c][c], B[c][c]);
+    B[2][2] = select (neg, zero - B[2][2], B[2][2]);
+
+    for (int k = 0; k < 3; ++k)
+    {
+        U[c][k] = select (neg, zero - U[c][k], U[c][k]);
+        U[2][k] = select (neg, zero - U[2][k], U[2][k]);
+    }
+}
+
+//
+// fastSVDScalar() for 16 matrices at a time; the matrices in the
+// lanes outside mask are zero.
+//
+
+IMATH_TARGET_AVX512 void
+fastSVDAVX512 (
+    const M33f*  A,
+    __mmask16    mask,
+    FloatLanes16 U[3][3],
+    FloatLanes16 S[3],
+    FloatLanes16 V[3][3])
+{
+    const FloatLanes16 zero = splat (0.0f);
+    const FloatLanes16 one  = splat (1.0f);
+
+    FloatLanes16 a[3][3];
+    FloatLanes16 scale = zero;
+
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+        {
+            a[i][j]              = gather<9> (&A[0][i][j], mask, 0.0f);
+            const FloatLanes16 x = abs (a[i][j]);
+            scale                = select (less (scale, x), x, scale);
+        }
+
+    scale = select (equal (scale, zero), one, scale);
+
+    const FloatLanes16 inv = one / scale;
+
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            a[i][j] = a[i][j] * inv;
+
+    FloatLanes16 B[3][3];
+    FloatLanes16 rho[3];
+
+    for (int c = 0; c < 3; ++c)
+        for (int j = 0; j < 3; ++j)
+        {
+            B[c][j] = a[j][c];
+            V[c][j] = c == j ? one : zero;
+        }
+
+    for (int sweep = 0; sweep < svdSweeps; ++sweep)
+    {
+        hestenesRotate (B[0], B[1], V[0], V[1]);
+        hestenesRotate (B[0], B[2], V[0], V[2]);
+        hestenesRotate (B[1], B[2], V[1], V[2]);
+    }
+
+    for (int c = 0; c < 3; ++c)
+        rho[c] = B[c][0] * B[c][0] + B[c][1] * B[c][1] + B[c][2] * B[c][2];
+
+    svdSort (B, V, rho, 0, 1);
+    svdSort (B, V, rho, 0, 2);
+    svdSort (B, V, rho, 1, 2);
+
+    for (int c = 0; c < 3; ++c)
+        for (int j = 0; j < 3; ++j)
+            U[c][j] = c == j ? one : zero;
+
+    svdGivens (B, U, 0, 0, 1);
+    svdGivens (B, U, 0, 0, 2);
+    svdGivens (B, U, 1, 1, 2);
+
+    svdSign (B, U, 0);
+    svdSign (B, U, 1);
+
+    for (int c = 0; c < 3; ++c)
+        S[c] = B[c][c] * scale;
+}
+
+IMATH_TARGET_AVX512 void
+fastSVDArrayAVX512 (const M33f* A, M33f* U, V3f* S, M33f* V, size_t n)
+{
+    for (size_t i = 0; i < n; i += 16)
+    {
+        const size_t    k    = n - i < 16 ? n - i : 16;
+        const __mmask16 mask = __mmask16 ((1u << k) - 1);
+
+        FloatLanes16 u[3][3], s[3], v[3][3];
+        fastSVDAVX512 (A + i, mask, u, s, v);
+
+        for (int r = 0; r < 3; ++r)
+        {
+            scatter<3> (&S[i][r], mask, s[r]);
+
+            for (int c = 0; c < 3; ++c)
+            {
+                scatter<9> (&U[i][r][c], mask, u[c][r]);
+                scatter<9> (&V[i][r][c], mask, v[c][r]);
+            }
+        }
+    }
+}
+
+IMATH_TARGET_AVX512 void
+polarDecompositionArrayAVX512 (const M33f* A, M33f* R, M33f* P, size_t n)
+{
+    for (size_t i = 0; i < n; i += 16)
+    {
+        const size_t    k    = n - i < 16 ? n - i : 16;
+        const __mmask16 mask = __mmask16 ((1u << k) - 1);
+
+        FloatLanes16 u[3][3], s[3], v[3][3];
+        fastSVDAVX512 (A + i, mask, u, s, v);
+
+        for (int r = 0; r < 3; ++r)
+            for (int c = 0; c < 3; ++c)
+                scatter<9> (
+                    &R[i][r][c],
+                    mask,
+                    u[0][r] * v[0][c] + u[1][r] * v[1][c] + u[2][r] * v[2][c]);
+
+        for (int r = 0; r < 3; ++r)
+            for (int c = r; c < 3; ++c)
+            {
+                const FloatLanes16 p = v[0][r] * s[0] * v[0][c] +
+                                       v[1][r] * s[1] * v[1][c] +
+                                       v[2][r] * s[2] * v[2][c];
+
+                scatter<9> (&P[i][r][c], mask, p);
+                scatter<9> (&P[i][c][r], mask, p);
+            }
+    }
+}
+
+IMATH_AVX512_KERNELS_END
+
+#endif // IMATH_X86_RUNTIME_DISPATCH
+
+} // namespace
+
+IMATH_EXPORT void
+fastSVD (const M33f& A, M33f& U, V3f& S, M33f& V) IMATH_NOEXCEPT
+{
+    float u[3][3], s[3], v[3][3];
+    fastSVDScalar (A, u, s, v);
+    storeSVD (u, s, v, U, S, V);
+}
+
+IMATH_EXPORT void
+polarDecomposition (const M33f& A, M33f& R, M33f& P) IMATH_NOEXCEPT
+{
+    float u[3][3], s[3], v[3][3];
+    fastSVDScalar (A, u, s, v);
+    storePolar (u, s, v, R, P);
+}
+
+IMATH_EXPORT void
+fastSVDArray (
+    const M33f* A, M33f* U, V3f* S, M33f* V, size_t n) IMATH_NOEXCEPT
+{
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+    if (imathCpuFeatures ().avx512f)
+    {
+        fastSVDArrayAVX512 (A, U, S, V, n);
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < n; ++i)
+        fastSVD (A[i], U[i], S[i], V[i]);
+}
+
+IMATH_EXPORT void
+polarDecompositionArray (
+    const M33f* A, M33f* R, M33f* P, size_t n) IMATH_NOEXCEPT
+{
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+    if (imathCpuFeatures ().avx512f)
+    {
+        polarDecompositionArrayAVX512 (A, R, P, n);
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < n; ++i)
+        polarDecomposition (A[i], R[i], P[i]);
+}
+
 IMATH_INTERNAL_NAMESPACE_SOURCE_EXIT
 
 /// @endcond
@@ -19,6 +19,8 @@
 #include "ImathNamespace.h"
 #include "ImathQuat.h"
 #include "ImathVec.h"
+#include <algorithm>
+#include <limits>
 #include <math.h>
 
 IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
@@ -248,6 +250,102 @@ bool extractSHRT (
 template <class T>
 bool checkForZeroScaleInRow (const T& scl, const Vec3<T>& row, bool exc = true);
 
+//
+// Decomposition of arrays of 4x4 matrices. These functions do not
+// throw; instead, they report the degenerate matrices, whose scaling
+// cannot be removed, in an optional array of flags, and return their
+// number. The results for the other matrices are identical to those
+// of the corresponding functions for single matrices. With AVX-512,
+// the scaling and shear are extracted 16 (float) or 8 (double)
+// matrices at a time.
+//
+
+/// Extract the scaling and shear of `mat[i]` into `scl[i]` and
+/// `shr[i]`, for `0 <= i < n`, as extractScalingAndShear() does.
+/// For a degenerate matrix, both are set to zero, and
+/// `degenerate[i]` is set to true; `degenerate` may be null.
+/// @return The number of degenerate matrices
+IMATH_EXPORT size_t extractScalingAndShearArray (
+    const M44f* mat,
+    V3f*        scl,
+    V3f*        shr,
+    size_t      n,
+    bool*       degenerate = 0) IMATH_NOEXCEPT;
+
+/// Extract the scaling and shear of `mat[i]`, for `0 <= i < n`.
+/// @return The number of degenerate matrices
+IMATH_EXPORT size_t extractScalingAndShearArray (
+    const M44d* mat,
+    V3d*        scl,
+    V3d*        shr,
+    size_t      n,
+    bool*       degenerate = 0) IMATH_NOEXCEPT;
+
+/// Extract the rotation of `mat[i]` into `rot[i]`, in the form of XYZ
+/// euler angles, for `0 <= i < n`, as extractEulerXYZ() does.
+IMATH_EXPORT void
+extractEulerXYZArray (const M44f* mat, V3f* rot, size_t n) IMATH_NOEXCEPT;
+
+/// Extract the rotation of `mat[i]` into `rot[i]`, for `0 <= i < n`.
+IMATH_EXPORT void
+extractEulerXYZArray (const M44d* mat, V3d* rot, size_t n) IMATH_NOEXCEPT;
+
+/// Extract the scaling, shear, rotation and translation of `mat[i]`
+/// into `s[i]`, `h[i]`, `r[i]` and `t[i]`, for `0 <= i < n`, as
+/// extractSHRT() does. For a degenerate matrix, the scaling, shear
+/// and rotation are set to zero, the translation is extracted, and
+/// `degenerate[i]` is set to true; `degenerate` may be null.
+/// @return The number of degenerate matrices
+IMATH_EXPORT size_t extractSHRTArray (
+    const M44f*   mat,
+    V3f*          s,
+    V3f*          h,
+    V3f*          r,
+    V3f*          t,
+    size_t        n,
+    bool*         degenerate = 0,
+    Eulerf::Order rOrder     = Eulerf::XYZ) IMATH_NOEXCEPT;
+
+/// Extract the scaling, shear, rotation and translation of `mat[i]`,
+/// for `0 <= i < n`.
+/// @return The number of degenerate matrices
+IMATH_EXPORT size_t extractSHRTArray (
+    const M44d*   mat,
+    V3d*          s,
+    V3d*          h,
+    V3d*          r,
+    V3d*          t,
+    size_t        n,
+    bool*         degenerate = 0,
+    Eulerd::Order rOrder     = Eulerd::XYZ) IMATH_NOEXCEPT;
+
+//
+// Conversion of arrays of rotation matrices to quaternions. The
+// results are identical to those of extractQuat(); with AVX-512, 16
+// (float) or 8 (double) matrices are converted at a time, without
+// branches. Only the upper left 3x3 elements are read. See
+// toMatrix33Array() and toMatrix44Array() for the reverse
+// conversion.
+//
+
+/// Compute `q[i] = extractQuat (M44f (mat[i], V3f (0)))`, for
+/// `0 <= i < n`.
+IMATH_EXPORT void
+extractQuatArray (const M33f* mat, Quatf* q, size_t n) IMATH_NOEXCEPT;
+
+/// Compute `q[i] = extractQuat (M44d (mat[i], V3d (0)))`, for
+/// `0 <= i < n`.
+IMATH_EXPORT void
+extractQuatArray (const M33d* mat, Quatd* q, size_t n) IMATH_NOEXCEPT;
+
+/// Compute `q[i] = extractQuat (mat[i])`, for `0 <= i < n`.
+IMATH_EXPORT void
+extractQuatArray (const M44f* mat, Quatf* q, size_t n) IMATH_NOEXCEPT;
+
+/// Compute `q[i] = extractQuat (mat[i])`, for `0 <= i < n`.
+IMATH_EXPORT void
+extractQuatArray (const M44d* mat, Quatd* q, size_t n) IMATH_NOEXCEPT;
+
 /// Return the 4x4 outer product two 4-vectors
 template <class T>
 Matrix44<T> outerProduct (const Vec4<T>& a, const Vec4<T>& b);
@@ -1418,6 +1516,76 @@ outerProduct (const Vec3<T>& a, const Vec3<T>& b)
         a.z * b.z);
 }
 
+///
+/// Accumulates corresponding 'from' and 'to' points, in chunks, for
+/// computing the procrustes transformation that brings the 'from'
+/// points as close as possible to the 'to' points, as
+/// procrustesRotationAndTranslation() does, without holding all the
+/// points in memory.
+///
+/// The accumulator keeps the weighted moments of the points about the
+/// first pair of points added, in double precision, so the result does
+/// not depend on how far the points are from the origin. Accumulating
+/// all the points in a single add() gives exactly the transformation
+/// that procrustesRotationAndTranslation() returns; with several
+/// chunks, it differs only by rounding. The weights may be negative,
+/// and a chunk whose weights sum to zero still counts.
+///
+/// An accumulator is not thread-safe. To accumulate in parallel, give
+/// each thread its own accumulator, and merge them at the end.
+///
+
+class ProcrustesAccumulator
+{
+public:
+    /// Construct an empty accumulator.
+    IMATH_EXPORT ProcrustesAccumulator ();
+
+    /// Add `numPoints` pairs of points, `A[i]` and `B[i]`, with
+    /// weights `weights[i]`. If `weights` is null, the points have
+    /// unit weight.
+    template <typename T>
+    IMATH_EXPORT void
+    add (const Vec3<T>* A,
+         const Vec3<T>* B,
+         const T*       weights,
+         const size_t   numPoints);
+
+    /// Add `numPoints` pairs of points with unit weight.
+    template <typename T>
+    void add (const Vec3<T>* A, const Vec3<T>* B, const size_t numPoints)
+    {
+        add (A, B, (const T*) 0, numPoints);
+    }
+
+    /// Add the points accumulated by `other`.
+    IMATH_EXPORT void merge (const ProcrustesAccumulator& other);
+
+    /// Remove all points.
+    IMATH_EXPORT void clear ();
+
+    /// Return the number of points added.
+    size_t numPoints () const { return _numPoints; }
+
+    /// Return the sum of the weights of the points added.
+    double weightsSum () const { return _weightsSum; }
+
+    /// Return the procrustes transformation of the points added. If
+    /// doScaling is true, a uniform scale is allowed also. If the
+    /// weights sum to zero, return the identity.
+    IMATH_EXPORT M44d result (const bool doScaling = false) const;
+
+private:
+    size_t _numPoints;
+    double _weightsSum;
+    V3d    _Aorigin;
+    V3d    _Borigin;
+    V3d    _Asum;
+    V3d    _Bsum;
+    M33d   _BAsum;
+    double _AAsum;
+};
+
 /// Computes the translation and rotation that brings the 'from' points
 /// as close as possible to the 'to' points under the Frobenius norm.
 /// To be more specific, let x be the matrix of 'from' points and y be
@@ -1510,6 +1678,40 @@ void jacobiSVD (
     const T            tol = std::numeric_limits<T>::epsilon (),
     const bool         forcePositiveDeterminant = false);
 
+/// Compute the SVD of a 3x3 matrix with a fixed number of Jacobi
+/// sweeps, after McAdams et al., "Computing the Singular Value
+/// Decomposition of 3x3 matrices with minimal branching and
+/// elementary floating point operations".
+///
+/// As with jacobiSVD() with `forcePositiveDeterminant` set, A = U * S
+/// * V^T, where U and V are rotations and the singular values are
+/// sorted by decreasing magnitude; the last one is negative if
+/// det(A) < 0. The results are accurate to a few ulps of the largest
+/// singular value. A single decomposition takes about as long as
+/// jacobiSVD(), but unlike jacobiSVD() it vectorizes; see
+/// fastSVDArray().
+IMATH_EXPORT void
+fastSVD (const M33f& A, M33f& U, V3f& S, M33f& V) IMATH_NOEXCEPT;
+
+/// Compute the polar decomposition A = R * P of a 3x3 matrix, where R
+/// is a rotation and P is symmetric, using fastSVD(): R = U * V^T and
+/// P = V * S * V^T. P is positive semi-definite if det(A) >= 0.
+IMATH_EXPORT void
+polarDecomposition (const M33f& A, M33f& R, M33f& P) IMATH_NOEXCEPT;
+
+/// Compute the SVD of `A[i]` into `U[i]`, `S[i]` and `V[i]`, for
+/// `0 <= i < n`. The results are identical to those of fastSVD();
+/// with AVX-512, 16 matrices are decomposed at a time, several times
+/// faster than one at a time.
+IMATH_EXPORT void fastSVDArray (
+    const M33f* A, M33f* U, V3f* S, M33f* V, size_t n) IMATH_NOEXCEPT;
+
+/// Compute the polar decomposition of `A[i]` into `R[i]` and `P[i]`,
+/// for `0 <= i < n`. The results are identical to those of
+/// polarDecomposition().
+IMATH_EXPORT void polarDecompositionArray (
+    const M33f* A, M33f* R, M33f* P, size_t n) IMATH_NOEXCEPT;
+
 /// Compute the eigenvalues (S) and the eigenvectors (V) of a real
 /// symmetric matrix using Jacobi transformation, using a given
 /// tolerance `tol`.
@@ -1574,6 +1776,113 @@ template <typename TM, typename TV> void maxEigenVector (TM& A, TV& S);
 /// of a real symmetric matrix using Jacobi transformation.
 template <typename TM, typename TV> void minEigenVector (TM& A, TV& S);
 
+//
+// Eigen decomposition of arrays of symmetric 3x3 matrices, such as
+// fields of covariance or structure tensors. Only the diagonal and
+// the upper triangle of each matrix are read.
+//
+// The results are stored as planes: eigenvalue k of matrix i is
+// `S[k * stride + i]`, and element [j][k] of its matrix of
+// eigenvectors is `V[(3 * j + k) * stride + i]`. A stride of 0 means
+// n. The eigenvectors are the columns, so that A = V * S * V^T, and
+// both solvers sort the eigenvalues in decreasing order and make V
+// a rotation (det(V) = 1).
+//
+// With AVX-512, the Jacobi solver runs a fixed number of sweeps on
+// 16 (float) or 8 (double) matrices at a time.
+//
+
+/// Compute the eigenvalues and eigenvectors of `A[i]`, for
+/// `0 <= i < n`, using Jacobi transformation.
+IMATH_EXPORT void jacobiEigenSolverArray (
+    const M33f* A,
+    float*      S,
+    float*      V,
+    size_t      n,
+    size_t      stride = 0) IMATH_NOEXCEPT;
+
+/// Compute the eigenvalues and eigenvectors of `A[i]`, for
+/// `0 <= i < n`, using Jacobi transformation.
+IMATH_EXPORT void jacobiEigenSolverArray (
+    const M33d* A,
+    double*     S,
+    double*     V,
+    size_t      n,
+    size_t      stride = 0) IMATH_NOEXCEPT;
+
+/// Compute the eigenvalues and eigenvectors of `A[i]`, for
+/// `0 <= i < n`, in closed form. This is faster than Jacobi
+/// transformation, but less accurate for nearly equal eigenvalues.
+IMATH_EXPORT void analyticEigenSolverArray (
+    const M33f* A,
+    float*      S,
+    float*      V,
+    size_t      n,
+    size_t      stride = 0) IMATH_NOEXCEPT;
+
+/// Compute the eigenvalues and eigenvectors of `A[i]`, for
+/// `0 <= i < n`, in closed form.
+IMATH_EXPORT void analyticEigenSolverArray (
+    const M33d* A,
+    double*     S,
+    double*     V,
+    size_t      n,
+    size_t      stride = 0) IMATH_NOEXCEPT;
+
+/// Compute the eigenvalues and eigenvectors of `A[i]`, for
+/// `0 <= i < n`, as jacobiEigenSolverArray() does, handing ranges of
+/// matrices to `executor`, which calls `body (begin, end)` for
+/// disjoint ranges covering `[begin, end)`, possibly in parallel.
+template <
+    class T,
+    class Executor,
+    IMATH_ENABLE_IF (!std::is_integral<Executor>::value)>
+inline void
+jacobiEigenSolverArray (
+    const Matrix33<T>* A, T* S, T* V, size_t n, Executor executor)
+{
+    //
+    // The executor's ranges are ints, so larger arrays are handed to
+    // it in pieces.
+    //
+
+    const size_t piece = size_t (std::numeric_limits<int>::max ());
+
+    for (size_t first = 0; first < n; first += piece)
+    {
+        const size_t m = std::min (n - first, piece);
+
+        executor (0, int (m), [=] (int begin, int end) {
+            const size_t i = first + size_t (begin);
+            jacobiEigenSolverArray (A + i, S + i, V + i, size_t (end - begin), n);
+        });
+    }
+}
+
+/// Compute the eigenvalues and eigenvectors of `A[i]`, for
+/// `0 <= i < n`, as analyticEigenSolverArray() does, handing ranges
+/// of matrices to `executor`.
+template <
+    class T,
+    class Executor,
+    IMATH_ENABLE_IF (!std::is_integral<Executor>::value)>
+inline void
+analyticEigenSolverArray (
+    const Matrix33<T>* A, T* S, T* V, size_t n, Executor executor)
+{
+    const size_t piece = size_t (std::numeric_limits<int>::max ());
+
+    for (size_t first = 0; first < n; first += piece)
+    {
+        const size_t m = std::min (n - first, piece);
+
+        executor (0, int (m), [=] (int begin, int end) {
+            const size_t i = first + size_t (begin);
+            analyticEigenSolverArray (A + i, S + i, V + i, size_t (end - begin), n);
+        });
+    }
+}
+
 IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
 
 #endif // INCLUDED_IMATHMATRIXALGO_H
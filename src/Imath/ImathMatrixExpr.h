@@ -0,0 +1,402 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+//
+// Lazy evaluation of chains of Matrix44 products
+//
+// This header is not included by ImathMatrix.h; include it to use
+// lazy(), which starts a chain:
+//
+//     V3f p = v * (lazy (a) * b * c * d);    // no matrix products
+//     M44f m = lazy (a) * b * c * d;         // one accumulator
+//
+// A chain records its operands, whose number is part of its type,
+// and defers the work until the chain is used. How it is used
+// decides the evaluation order:
+//
+//   - Converting a chain to a Matrix44 folds the product from left
+//     to right into a single matrix, without a temporary for each
+//     operator. The result is identical to that of operator*.
+//
+//   - Multiplying a vector by a chain passes the vector through each
+//     matrix in turn, which takes 16 multiply-adds per matrix instead
+//     of 64 per matrix product. Because the operations are grouped
+//     differently, the result may differ from that of multiplying by
+//     the folded product in the last bits.
+//
+//   - Transforming an array of vectors folds the product first, when
+//     that is cheaper, and then uses the array form of
+//     Matrix44::multVecMatrix().
+//
+// A chain refers to its operands, rather than copying them, so it
+// must not outlive them. Temporaries are not accepted as operands;
+// a chain stored in a variable is safe only if all its operands
+// outlive the variable.
+//
+
+#ifndef INCLUDED_IMATHMATRIXEXPR_H
+#define INCLUDED_IMATHMATRIXEXPR_H
+
+#include "ImathExport.h"
+#include "ImathNamespace.h"
+
+#include "ImathMatrix.h"
+#include "ImathVec.h"
+
+#include <stddef.h>
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+///
+/// A product of `N` Matrix44 operands, evaluated when it is used.
+/// Chains are created by lazy() and extended by operator*.
+///
+
+template <class T, int N> class MatrixChain44
+{
+public:
+    /// The operands, from left to right
+    const Matrix44<T>* operands[N];
+
+    /// @{
+    /// @name Evaluation
+
+    /// Return the product, folded from left to right. The result is
+    /// identical to that of applying operator* from left to right.
+    IMATH_HOSTDEVICE Matrix44<T> evaluate () const IMATH_NOEXCEPT;
+
+    /// Return the product, as by evaluate()
+    IMATH_HOSTDEVICE operator Matrix44<T> () const IMATH_NOEXCEPT
+    {
+        return evaluate ();
+    }
+
+    /// @}
+
+    /// @{
+    /// @name Transformation of vectors
+
+    /// Transform a point by the product, passing it through each
+    /// operand in turn, and divide by the homogeneous coordinate at
+    /// the end, as Matrix44::multVecMatrix() does.
+    template <class S>
+    IMATH_HOSTDEVICE void
+    multVecMatrix (const Vec3<S>& src, Vec3<S>& dst) const IMATH_NOEXCEPT;
+
+    /// Transform a direction by the product, as
+    /// Matrix44::multDirMatrix() does, passing it through each operand
+    /// in turn.
+    template <class S>
+    IMATH_HOSTDEVICE void
+    multDirMatrix (const Vec3<S>& src, Vec3<S>& dst) const IMATH_NOEXCEPT;
+
+    /// Transform an array of `n` points by the product. If there are
+    /// more than four points, whatever the length of the chain, the
+    /// product is folded first, and the points are transformed by the
+    /// array form of Matrix44::multVecMatrix(). `dst` may be the same
+    /// as `src`.
+    template <class S>
+    void multVecMatrix (const Vec3<S>* src, Vec3<S>* dst, size_t n) const
+        IMATH_NOEXCEPT;
+
+    /// Transform an array of `n` directions by the product, as the
+    /// array form of multVecMatrix() transforms points.
+    template <class S>
+    void multDirMatrix (const Vec3<S>* src, Vec3<S>* dst, size_t n) const
+        IMATH_NOEXCEPT;
+
+    /// Return `v` passed through each operand in turn, without a
+    /// homogeneous divide
+    template <class S>
+    IMATH_HOSTDEVICE Vec4<S> transform (Vec4<S> v) const IMATH_NOEXCEPT;
+
+    /// @}
+
+    /// The number of operands
+    IMATH_HOSTDEVICE constexpr static int length () IMATH_NOEXCEPT
+    {
+        return N;
+    }
+
+    /// The base type
+    typedef T BaseType;
+
+private:
+    //
+    // Vectors are cheaper to pass through the operands than to
+    // transform by the folded product while they number no more than
+    // this: folding takes 64 multiply-adds for each of the N - 1
+    // products, a transform 16 per operand, so folding n vectors
+    // saves 16 * (N - 1) * (n - 4) of them, whatever N is.
+    //
+
+    static constexpr size_t foldThreshold = 4;
+};
+
+/// Start a chain with a single operand
+template <class T>
+IMATH_HOSTDEVICE inline MatrixChain44<T, 1>
+lazy (const Matrix44<T>& m) IMATH_NOEXCEPT;
+
+/// A chain cannot start with a temporary, which would be destroyed
+/// before a chain stored in a variable is used.
+template <class T>
+MatrixChain44<T, 1> lazy (const Matrix44<T>&& m) = delete;
+
+/// Append an operand to a chain
+template <class T, int N>
+IMATH_HOSTDEVICE inline MatrixChain44<T, N + 1>
+operator* (const MatrixChain44<T, N>& a, const Matrix44<T>& b) IMATH_NOEXCEPT;
+
+/// A temporary cannot be appended to a chain, for the same reason.
+template <class T, int N>
+MatrixChain44<T, N + 1>
+operator* (const MatrixChain44<T, N>& a, const Matrix44<T>&& b) = delete;
+
+/// Prepend an operand to a chain
+template <class T, int N>
+IMATH_HOSTDEVICE inline MatrixChain44<T, N + 1>
+operator* (const Matrix44<T>& a, const MatrixChain44<T, N>& b) IMATH_NOEXCEPT;
+
+/// A temporary cannot be prepended to a chain, for the same reason.
+template <class T, int N>
+MatrixChain44<T, N + 1>
+operator* (const Matrix44<T>&& a, const MatrixChain44<T, N>& b) = delete;
+
+/// Concatenate two chains
+template <class T, int N, int M>
+IMATH_HOSTDEVICE inline MatrixChain44<T, N + M> operator* (
+    const MatrixChain44<T, N>& a, const MatrixChain44<T, M>& b) IMATH_NOEXCEPT;
+
+/// Point transformation by a chain: r = v * chain
+template <class S, class T, int N>
+IMATH_HOSTDEVICE inline Vec3<S>
+operator* (const Vec3<S>& v, const MatrixChain44<T, N>& m) IMATH_NOEXCEPT;
+
+/// Point transformation by a chain: v *= chain
+template <class S, class T, int N>
+IMATH_HOSTDEVICE inline const Vec3<S>&
+operator*= (Vec3<S>& v, const MatrixChain44<T, N>& m) IMATH_NOEXCEPT;
+
+/// Homogeneous transformation by a chain: r = v * chain
+template <class S, class T, int N>
+IMATH_HOSTDEVICE inline Vec4<S>
+operator* (const Vec4<S>& v, const MatrixChain44<T, N>& m) IMATH_NOEXCEPT;
+
+/// Homogeneous transformation by a chain: v *= chain
+template <class S, class T, int N>
+IMATH_HOSTDEVICE inline const Vec4<S>&
+operator*= (Vec4<S>& v, const MatrixChain44<T, N>& m) IMATH_NOEXCEPT;
+
+//---------------
+// Implementation
+//---------------
+
+template <class T, int N>
+IMATH_HOSTDEVICE inline Matrix44<T>
+MatrixChain44<T, N>::evaluate () const IMATH_NOEXCEPT
+{
+    Matrix44<T> r (*operands[0]);
+
+    //
+    // Each row of a product depends only on the same row of the left
+    // operand, so the product can replace the accumulator one row at
+    // a time. The operations are those of Matrix44::multiply().
+    //
+
+    for (int k = 1; k < N; ++k)
+    {
+        const Matrix44<T>& b = *operands[k];
+
+        for (int i = 0; i < 4; ++i)
+        {
+            const T a0 = r.x[i][0];
+            const T a1 = r.x[i][1];
+            const T a2 = r.x[i][2];
+            const T a3 = r.x[i][3];
+
+            for (int j = 0; j < 4; ++j)
+                r.x[i][j] = a0 * b.x[0][j] + a1 * b.x[1][j] + a2 * b.x[2][j] +
+                            a3 * b.x[3][j];
+        }
+    }
+
+    return r;
+}
+
+template <class T, int N>
+template <class S>
+IMATH_HOSTDEVICE inline Vec4<S>
+MatrixChain44<T, N>::transform (Vec4<S> v) const IMATH_NOEXCEPT
+{
+    for (int k = 0; k < N; ++k)
+    {
+        const Matrix44<T>& m = *operands[k];
+
+        v = Vec4<S> (
+            S (v.x * m.x[0][0] + v.y * m.x[1][0] + v.z * m.x[2][0] +
+               v.w * m.x[3][0]),
+            S (v.x * m.x[0][1] + v.y * m.x[1][1] + v.z * m.x[2][1] +
+               v.w * m.x[3][1]),
+            S (v.x * m.x[0][2] + v.y * m.x[1][2] + v.z * m.x[2][2] +
+               v.w * m.x[3][2]),
+            S (v.x * m.x[0][3] + v.y * m.x[1][3] + v.z * m.x[2][3] +
+               v.w * m.x[3][3]));
+    }
+
+    return v;
+}
+
+template <class T, int N>
+template <class S>
+IMATH_HOSTDEVICE inline void
+MatrixChain44<T, N>::multVecMatrix (const Vec3<S>& src, Vec3<S>& dst) const
+    IMATH_NOEXCEPT
+{
+    Vec4<S> v = transform (Vec4<S> (src.x, src.y, src.z, S (1)));
+
+    dst.x = v.x / v.w;
+    dst.y = v.y / v.w;
+    dst.z = v.z / v.w;
+}
+
+template <class T, int N>
+template <class S>
+IMATH_HOSTDEVICE inline void
+MatrixChain44<T, N>::multDirMatrix (const Vec3<S>& src, Vec3<S>& dst) const
+    IMATH_NOEXCEPT
+{
+    //
+    // A direction has a homogeneous coordinate of zero. Carrying the
+    // fourth coordinate from one operand to the next accounts for the
+    // last column of each operand, which contributes to the upper left
+    // 3x3 part of the product.
+    //
+
+    Vec4<S> v = transform (Vec4<S> (src.x, src.y, src.z, S (0)));
+
+    dst.x = v.x;
+    dst.y = v.y;
+    dst.z = v.z;
+}
+
+template <class T, int N>
+template <class S>
+inline void
+MatrixChain44<T, N>::multVecMatrix (
+    const Vec3<S>* src, Vec3<S>* dst, size_t n) const IMATH_NOEXCEPT
+{
+    if (N == 1 || n > foldThreshold)
+    {
+        evaluate ().multVecMatrix (src, dst, n);
+        return;
+    }
+
+    for (size_t i = 0; i < n; ++i)
+        multVecMatrix (src[i], dst[i]);
+}
+
+template <class T, int N>
+template <class S>
+inline void
+MatrixChain44<T, N>::multDirMatrix (
+    const Vec3<S>* src, Vec3<S>* dst, size_t n) const IMATH_NOEXCEPT
+{
+    if (N == 1 || n > foldThreshold)
+    {
+        evaluate ().multDirMatrix (src, dst, n);
+        return;
+    }
+
+    for (size_t i = 0; i < n; ++i)
+        multDirMatrix (src[i], dst[i]);
+}
+
+template <class T>
+IMATH_HOSTDEVICE inline MatrixChain44<T, 1>
+lazy (const Matrix44<T>& m) IMATH_NOEXCEPT
+{
+    MatrixChain44<T, 1> c;
+    c.operands[0] = &m;
+    return c;
+}
+
+template <class T, int N>
+IMATH_HOSTDEVICE inline MatrixChain44<T, N + 1>
+operator* (const MatrixChain44<T, N>& a, const Matrix44<T>& b) IMATH_NOEXCEPT
+{
+    MatrixChain44<T, N + 1> c;
+
+    for (int i = 0; i < N; ++i)
+        c.operands[i] = a.operands[i];
+
+    c.operands[N] = &b;
+    return c;
+}
+
+template <class T, int N>
+IMATH_HOSTDEVICE inline MatrixChain44<T, N + 1>
+operator* (const Matrix44<T>& a, const MatrixChain44<T, N>& b) IMATH_NOEXCEPT
+{
+    MatrixChain44<T, N + 1> c;
+    c.operands[0] = &a;
+
+    for (int i = 0; i < N; ++i)
+        c.operands[i + 1] = b.operands[i];
+
+    return c;
+}
+
+template <class T, int N, int M>
+IMATH_HOSTDEVICE inline MatrixChain44<T, N + M>
+operator* (const MatrixChain44<T, N>& a, const MatrixChain44<T, M>& b)
+    IMATH_NOEXCEPT
+{
+    MatrixChain44<T, N + M> c;
+
+    for (int i = 0; i < N; ++i)
+        c.operands[i] = a.operands[i];
+
+    for (int i = 0; i < M; ++i)
+        c.operands[N + i] = b.operands[i];
+
+    return c;
+}
+
+template <class S, class T, int N>
+IMATH_HOSTDEVICE inline Vec3<S>
+operator* (const Vec3<S>& v, const MatrixChain44<T, N>& m) IMATH_NOEXCEPT
+{
+    Vec3<S> r;
+    m.multVecMatrix (v, r);
+    return r;
+}
+
+template <class S, class T, int N>
+IMATH_HOSTDEVICE inline const Vec3<S>&
+operator*= (Vec3<S>& v, const MatrixChain44<T, N>& m) IMATH_NOEXCEPT
+{
+    m.multVecMatrix (v, v);
+    return v;
+}
+
+template <class S, class T, int N>
+IMATH_HOSTDEVICE inline Vec4<S>
+operator* (const Vec4<S>& v, const MatrixChain44<T, N>& m) IMATH_NOEXCEPT
+{
+    return m.transform (v);
+}
+
+template <class S, class T, int N>
+IMATH_HOSTDEVICE inline const Vec4<S>&
+operator*= (Vec4<S>& v, const MatrixChain44<T, N>& m) IMATH_NOEXCEPT
+{
+    v = m.transform (v);
+    return v;
+}
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif // INCLUDED_IMATHMATRIXEXPR_H
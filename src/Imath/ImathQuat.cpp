@@ -0,0 +1,1264 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+//---------------------------------------------------------------------------
+//
+//	SIMD implementations of Quat operations on arrays.
+//
+//	The rotation, multiplication and conversion kernels perform the
+//	operations of the scalar operators, in the same order, and give
+//	the same results. The interpolation kernels evaluate the
+//	trigonometric functions with polynomial approximations, accurate
+//	to an ulp or two, so their results may differ from those of the
+//	scalar functions in ImathQuat.h in the last bits. This file is
+//	compiled without floating-point contraction, so the results do
+//	not depend on the compiler's choice of FMA instructions.
+//
+//---------------------------------------------------------------------------
+
+#include "ImathQuat.h"
+#include "ImathCpuFeatures.h"
+#include "ImathSimd.h"
+
+#include <cmath>
+#include <limits>
+
+IMATH_INTERNAL_NAMESPACE_SOURCE_ENTER
+
+namespace
+{
+
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+
+IMATH_AVX512_KERNELS_BEGIN
+
+//
+// The interpolation parameters beyond which the approximations are
+// not used. The arguments of the sines are then at most about 65 pi,
+// which the range reduction below handles without loss.
+//
+
+const int maxInterpolationParameter = 64;
+
+template <class T> struct TrigConstants;
+
+//
+// pi split into three parts, as in Cephes, so that x - k * pi can be
+// computed without cancellation for small integers k, and the Taylor
+// coefficients (-1)^n / (2n+1)! of sin (x) for |x| <= pi/2
+//
+
+template <> struct TrigConstants<float>
+{
+    static constexpr float pi1 = 3.140625f;
+    static constexpr float pi2 = 9.67502593994140625e-4f;
+    static constexpr float pi3 = 1.509957990978376432e-7f;
+
+    static constexpr int   sinTerms = 6;
+    static constexpr float sin[sinTerms] = {
+        -1.0f / 6,
+        1.0f / 120,
+        -1.0f / 5040,
+        1.0f / 362880,
+        -1.0f / 39916800,
+        1.0f / 6227020800.0f};
+};
+
+template <> struct TrigConstants<double>
+{
+    static constexpr double pi1 = 3.14159250259399414062;
+    static constexpr double pi2 = 1.50995788317231926867e-7;
+    static constexpr double pi3 = 1.07806057163162381058e-14;
+
+    static constexpr int    sinTerms = 11;
+    static constexpr double sin[sinTerms] = {
+        -1.0 / 6,
+        1.0 / 120,
+        -1.0 / 5040,
+        1.0 / 362880,
+        -1.0 / 39916800,
+        1.0 / 6227020800.0,
+        -1.0 / 1307674368000.0,
+        1.0 / 355687428096000.0,
+        -1.0 / 121645100408832000.0,
+        1.0 / 51090942171709440000.0,
+        -1.0 / 25852016738884976640000.0};
+};
+
+constexpr float  TrigConstants<float>::sin[];
+constexpr double TrigConstants<double>::sin[];
+
+//
+// sin (x), for |x| up to a few hundred: x = k * pi + r, with
+// |r| <= pi/2, and sin (x) = (-1)^k * sin (r).
+//
+
+template <class W>
+IMATH_TARGET_AVX512 inline W
+sinLanes (W x)
+{
+    typedef typename W::BaseType T;
+    typedef TrigConstants<T>     C;
+
+    const W k = roundNearest (x * splat (T (1 / M_PI)));
+    const W r =
+        ((x - k * splat (C::pi1)) - k * splat (C::pi2)) - k * splat (C::pi3);
+    const W z = r * r;
+
+    W p = splat (C::sin[C::sinTerms - 1]);
+
+    for (int i = C::sinTerms - 2; i >= 0; --i)
+        p = p * z + splat (C::sin[i]);
+
+    const W s = r + r * z * p;
+
+    const typename W::Mask odd =
+        notEqual (roundNearest (k * splat (T (0.5))) * splat (T (2)), k);
+
+    return select (odd, splat (T (0)) - s, s);
+}
+
+//
+// sinx_over_x()
+//
+
+template <class W>
+IMATH_TARGET_AVX512 inline W
+sincLanes (W x)
+{
+    typedef typename W::BaseType T;
+
+    const typename W::Mask tiny =
+        less (x * x, splat (std::numeric_limits<T>::epsilon ()));
+
+    return select (tiny, splat (T (1)), sinLanes (x) / x);
+}
+
+//
+// atan (x) for 0 <= x <= 1, as in Cephes: for larger x, atan (x) =
+// pi/4 + atan ((x - 1) / (x + 1)), and a polynomial (float) or
+// rational function (double) approximates atan near zero.
+//
+
+IMATH_TARGET_AVX512 inline FloatLanes16
+atanUnitLanes (FloatLanes16 x)
+{
+    const __mmask16 big = less (splat (0.414213562373095f), x);
+
+    const FloatLanes16 y =
+        select (big, (x - splat (1.0f)) / (x + splat (1.0f)), x);
+    const FloatLanes16 z = y * y;
+
+    FloatLanes16 p = splat (8.05374449538e-2f);
+    p              = p * z - splat (1.38776856032e-1f);
+    p              = p * z + splat (1.99777106478e-1f);
+    p              = p * z - splat (3.33329491539e-1f);
+
+    const FloatLanes16 a = p * z * y + y;
+
+    return select (big, splat (float (M_PI / 4)) + a, a);
+}
+
+IMATH_TARGET_AVX512 inline DoubleLanes8
+atanUnitLanes (DoubleLanes8 x)
+{
+    const __mmask8 big = less (splat (0.66), x);
+
+    const DoubleLanes8 y =
+        select (big, (x - splat (1.0)) / (x + splat (1.0)), x);
+    const DoubleLanes8 z = y * y;
+
+    DoubleLanes8 p = splat (-8.750608600031904122785e-1);
+    p              = p * z - splat (1.615753718733365076637e1);
+    p              = p * z - splat (7.500855792314704667340e1);
+    p              = p * z - splat (1.228866684490136173410e2);
+    p              = p * z - splat (6.485021904942025371773e1);
+
+    DoubleLanes8 q = z + splat (2.485846490142306297962e1);
+    q              = q * z + splat (1.650270098316988542046e2);
+    q              = q * z + splat (4.328810604912902668951e2);
+    q              = q * z + splat (4.853903996359136964868e2);
+    q              = q * z + splat (1.945506571482613964425e2);
+
+    const DoubleLanes8 a = y + y * z * p / q;
+
+    //
+    // pi/4 is rounded; add back half of the rounding error of pi/2
+    //
+
+    return select (
+        big,
+        splat (M_PI / 4) + (a + splat (0.5 * 6.123233995736765886130e-17)),
+        a);
+}
+
+//
+// atan2 (y, x) for x, y >= 0
+//
+
+template <class W>
+IMATH_TARGET_AVX512 inline W
+atan2Lanes (W y, W x)
+{
+    typedef typename W::BaseType T;
+
+    const typename W::Mask swap = less (x, y);
+
+    const W num = select (swap, x, y);
+    const W den = select (swap, y, x);
+    const W r   = select (equal (den, splat (T (0))), splat (T (0)), num / den);
+    const W a   = atanUnitLanes (r);
+
+    return select (swap, splat (T (M_PI / 2)) - a, a);
+}
+
+//
+// The four components of a quaternion, r, v.x, v.y and v.z
+//
+
+template <class W> struct QuatLanes
+{
+    W c[4];
+};
+
+template <class W>
+IMATH_SIMD_INLINE QuatLanes<W>
+loadQuat (const Quat<typename W::BaseType>* q, typename W::Mask mask)
+{
+    typedef typename W::BaseType T;
+
+    QuatLanes<W> l;
+    const T*     p = &q->r;
+
+    l.c[0] = gather<4> (p + 0, mask, T (1));
+    l.c[1] = gather<4> (p + 1, mask, T (0));
+    l.c[2] = gather<4> (p + 2, mask, T (0));
+    l.c[3] = gather<4> (p + 3, mask, T (0));
+
+    return l;
+}
+
+template <class W>
+IMATH_SIMD_INLINE void
+storeQuat (
+    Quat<typename W::BaseType>* q,
+    typename W::Mask            mask,
+    const QuatLanes<W>&         l)
+{
+    typedef typename W::BaseType T;
+
+    T* p = &q->r;
+
+    for (int j = 0; j < 4; ++j)
+        scatter<4> (p + j, mask, l.c[j]);
+}
+
+//
+// q1 ^ q2, which adds the products of the real and imaginary parts
+// separately
+//
+
+template <class W>
+IMATH_TARGET_AVX512 inline W
+dot (const QuatLanes<W>& a, const QuatLanes<W>& b)
+{
+    return a.c[0] * b.c[0] +
+           (a.c[1] * b.c[1] + a.c[2] * b.c[2] + a.c[3] * b.c[3]);
+}
+
+//
+// Quat::normalized (k1 * q1 + k2 * q2)
+//
+
+template <class W>
+IMATH_TARGET_AVX512 inline QuatLanes<W>
+combine (W k1, const QuatLanes<W>& q1, W k2, const QuatLanes<W>& q2)
+{
+    typedef typename W::BaseType T;
+
+    QuatLanes<W> q;
+
+    for (int j = 0; j < 4; ++j)
+        q.c[j] = k1 * q1.c[j] + k2 * q2.c[j];
+
+    const W                l    = sqrt (dot (q, q));
+    const typename W::Mask zero = equal (l, splat (T (0)));
+
+    for (int j = 0; j < 4; ++j)
+        q.c[j] = select (zero, splat (T (j == 0)), q.c[j] / l);
+
+    return q;
+}
+
+//
+// slerp()
+//
+
+template <class W>
+IMATH_TARGET_AVX512 inline QuatLanes<W>
+slerpLanes (const QuatLanes<W>& q1, const QuatLanes<W>& q2, W t)
+{
+    typedef typename W::BaseType T;
+
+    QuatLanes<W> d, s;
+
+    for (int j = 0; j < 4; ++j)
+    {
+        d.c[j] = q1.c[j] - q2.c[j];
+        s.c[j] = q1.c[j] + q2.c[j];
+    }
+
+    const W a =
+        splat (T (2)) * atan2Lanes (sqrt (dot (d, d)), sqrt (dot (s, s)));
+    const W u  = splat (T (1)) - t;
+    const W sa = sincLanes (a);
+    const W k1 = sincLanes (u * a) / sa * u;
+    const W k2 = sincLanes (t * a) / sa * t;
+
+    return combine (k1, q1, k2, q2);
+}
+
+//
+// The lanes in mask whose interpolation parameter is in the range of
+// the approximations
+//
+
+template <class W>
+IMATH_TARGET_AVX512 inline typename W::Mask
+inRange (W t, typename W::Mask mask)
+{
+    typedef typename W::BaseType T;
+
+    return mask & greaterEqual (splat (T (maxInterpolationParameter)), abs (t));
+}
+
+//
+// The offsets of the segments index[i] in an array of SlerpSegments,
+// in units of T. They are 64-bit, since index[i] times the size of a
+// segment need not fit in an int.
+//
+
+IMATH_TARGET_AVX512 inline __m512i
+scaleOffsets (__m256i index, int stride)
+{
+    //
+    // _mm512_mul_epi32() multiplies the sign-extended low halves of
+    // the 64-bit lanes into 64-bit products
+    //
+
+    return _mm512_mul_epi32 (
+        _mm512_cvtepi32_epi64 (index), _mm512_set1_epi64 (stride));
+}
+
+IMATH_TARGET_AVX512 inline Offsets16
+segmentOffsets (FloatLanes16, const int* index, __mmask16 mask)
+{
+    const int     stride = sizeof (SlerpSegment<float>) / sizeof (float);
+    const __m512i i      = _mm512_maskz_loadu_epi32 (mask, index);
+
+    return {
+        scaleOffsets (_mm512_castsi512_si256 (i), stride),
+        scaleOffsets (_mm512_extracti64x4_epi64 (i, 1), stride)};
+}
+
+IMATH_TARGET_AVX512 inline __m512i
+segmentOffsets (DoubleLanes8, const int* index, __mmask8 mask)
+{
+    const int stride = sizeof (SlerpSegment<double>) / sizeof (double);
+
+    return scaleOffsets (
+        _mm512_castsi512_si256 (
+            _mm512_maskz_loadu_epi32 (__mmask16 (mask), index)),
+        stride);
+}
+
+//
+// Process the problems in groups of W::lanes. The problems outside
+// the range of the approximations are left to the scalar functions;
+// they are not stored by the kernel, so that dst may be an input.
+//
+
+template <class W>
+IMATH_TARGET_AVX512 void
+slerpAVX512 (
+    const Quat<typename W::BaseType>* q1,
+    const Quat<typename W::BaseType>* q2,
+    const typename W::BaseType*       t,
+    Quat<typename W::BaseType>*       dst,
+    size_t                            n,
+    bool                              shortestArc)
+{
+    typedef typename W::BaseType T;
+    typedef typename W::Mask     Mask;
+
+    for (size_t i = 0; i < n; i += W::lanes)
+    {
+        const size_t k    = laneCount<W> (n, i);
+        const Mask   mask = Mask ((1u << k) - 1);
+
+        const QuatLanes<W> a  = loadQuat<W> (q1 + i, mask);
+        QuatLanes<W>       b  = loadQuat<W> (q2 + i, mask);
+        const W            tt = gather<1> (t + i, mask, T (0));
+
+        if (shortestArc)
+        {
+            //
+            // As in slerpShortestArc(), negate q2 unless q1 ^ q2 >= 0
+            //
+
+            const Mask negate =
+                Mask (~greaterEqual (dot (a, b), splat (T (0))));
+
+            for (int j = 0; j < 4; ++j)
+                b.c[j] = select (negate, splat (T (0)) - b.c[j], b.c[j]);
+        }
+
+        const Mask good = inRange (tt, mask);
+
+        storeQuat (dst + i, good, slerpLanes (a, b, tt));
+
+        for (size_t j = i; j < i + k; ++j)
+        {
+            if ((good >> (j - i)) & 1) continue;
+
+            dst[j] = shortestArc ? slerpShortestArc (q1[j], q2[j], t[j])
+                                 : slerp (q1[j], q2[j], t[j]);
+        }
+    }
+}
+
+template <class W>
+IMATH_TARGET_AVX512 void
+squadAVX512 (
+    const Quat<typename W::BaseType>* q1,
+    const Quat<typename W::BaseType>* qa,
+    const Quat<typename W::BaseType>* qb,
+    const Quat<typename W::BaseType>* q2,
+    const typename W::BaseType*       t,
+    Quat<typename W::BaseType>*       dst,
+    size_t                            n)
+{
+    typedef typename W::BaseType T;
+    typedef typename W::Mask     Mask;
+
+    for (size_t i = 0; i < n; i += W::lanes)
+    {
+        const size_t k    = laneCount<W> (n, i);
+        const Mask   mask = Mask ((1u << k) - 1);
+
+        const W tt = gather<1> (t + i, mask, T (0));
+        const W w  = splat (T (2)) * tt * (splat (T (1)) - tt);
+
+        const QuatLanes<W> r1 = slerpLanes (
+            loadQuat<W> (q1 + i, mask), loadQuat<W> (q2 + i, mask), tt);
+        const QuatLanes<W> r2 = slerpLanes (
+            loadQuat<W> (qa + i, mask), loadQuat<W> (qb + i, mask), tt);
+
+        const Mask good = inRange (tt, mask) & inRange (w, mask);
+
+        storeQuat (dst + i, good, slerpLanes (r1, r2, w));
+
+        for (size_t j = i; j < i + k; ++j)
+        {
+            if ((good >> (j - i)) & 1) continue;
+
+            dst[j] = squad (q1[j], qa[j], qb[j], q2[j], t[j]);
+        }
+    }
+}
+
+template <class W>
+IMATH_TARGET_AVX512 void
+slerpSegmentAVX512 (
+    const SlerpSegment<typename W::BaseType>* segments,
+    const int*                                index,
+    const typename W::BaseType*               t,
+    Quat<typename W::BaseType>*               dst,
+    size_t                                    n)
+{
+    typedef typename W::BaseType T;
+    typedef typename W::Mask     Mask;
+
+    static_assert (
+        sizeof (SlerpSegment<T>) == 10 * sizeof (T),
+        "the fields of SlerpSegment must be contiguous");
+
+    const T* base = &segments->q1.r;
+
+    for (size_t i = 0; i < n; i += W::lanes)
+    {
+        const size_t k    = laneCount<W> (n, i);
+        const Mask   mask = Mask ((1u << k) - 1);
+
+        const auto offsets = segmentOffsets (W (), index + i, mask);
+
+        QuatLanes<W> q1, q2;
+
+        for (int j = 0; j < 4; ++j)
+        {
+            q1.c[j] = gather (base + j, offsets, mask, T (j == 0));
+            q2.c[j] = gather (base + 4 + j, offsets, mask, T (j == 0));
+        }
+
+        const W angle   = gather (base + 8, offsets, mask, T (0));
+        const W invSinc = gather (base + 9, offsets, mask, T (1));
+
+        //
+        // As in SlerpSegment::operator()
+        //
+
+        const W tt = gather<1> (t + i, mask, T (0));
+        const W u  = splat (T (1)) - tt;
+        const W k1 = sincLanes (u * angle) * invSinc * u;
+        const W k2 = sincLanes (tt * angle) * invSinc * tt;
+
+        const Mask good = inRange (tt, mask);
+
+        storeQuat (dst + i, good, combine (k1, q1, k2, q2));
+
+        for (size_t j = i; j < i + k; ++j)
+        {
+            if ((good >> (j - i)) & 1) continue;
+
+            dst[j] = segments[index[j]](t[j]);
+        }
+    }
+}
+
+//
+// The three components of a vector
+//
+
+template <class W> struct Vec3Lanes
+{
+    W c[3];
+};
+
+template <class W>
+IMATH_SIMD_INLINE Vec3Lanes<W>
+loadVec3 (const Vec3<typename W::BaseType>* v, typename W::Mask mask)
+{
+    typedef typename W::BaseType T;
+
+    Vec3Lanes<W> l;
+    const T*     p = &v->x;
+
+    for (int j = 0; j < 3; ++j)
+        l.c[j] = gather<3> (p + j, mask, T (0));
+
+    return l;
+}
+
+template <class W>
+IMATH_SIMD_INLINE void
+storeVec3 (
+    Vec3<typename W::BaseType>* v,
+    typename W::Mask            mask,
+    const Vec3Lanes<W>&         l)
+{
+    typedef typename W::BaseType T;
+
+    T* p = &v->x;
+
+    for (int j = 0; j < 3; ++j)
+        scatter<3> (p + j, mask, l.c[j]);
+}
+
+//
+// Vec3::operator%, on the components of two vectors
+//
+
+template <class W>
+IMATH_SIMD_INLINE Vec3Lanes<W>
+cross (const W a[3], const W b[3])
+{
+    Vec3Lanes<W> l;
+
+    l.c[0] = a[1] * b[2] - a[2] * b[1];
+    l.c[1] = a[2] * b[0] - a[0] * b[2];
+    l.c[2] = a[0] * b[1] - a[1] * b[0];
+
+    return l;
+}
+
+//
+// v * q, in the cross product form of operator*(Vec3, Quat), which
+// takes 18 multiplications instead of the 32 of q * v * ~q
+//
+
+template <class W>
+IMATH_SIMD_INLINE Vec3Lanes<W>
+rotateLanes (const QuatLanes<W>& q, const Vec3Lanes<W>& v)
+{
+    typedef typename W::BaseType T;
+
+    const Vec3Lanes<W> a = cross (q.c + 1, v.c);
+    const Vec3Lanes<W> b = cross (q.c + 1, a.c);
+
+    Vec3Lanes<W> l;
+
+    for (int j = 0; j < 3; ++j)
+        l.c[j] = v.c[j] + splat<W> (T (2)) * (q.c[0] * a.c[j] + b.c[j]);
+
+    return l;
+}
+
+//
+// q1 * q2, in the order of operations of operator*(Quat, Quat)
+//
+
+template <class W>
+IMATH_SIMD_INLINE QuatLanes<W>
+multiplyLanes (const QuatLanes<W>& q1, const QuatLanes<W>& q2)
+{
+    const Vec3Lanes<W> c = cross (q1.c + 1, q2.c + 1);
+
+    QuatLanes<W> l;
+
+    l.c[0] = q1.c[0] * q2.c[0] -
+             (q1.c[1] * q2.c[1] + q1.c[2] * q2.c[2] + q1.c[3] * q2.c[3]);
+
+    for (int j = 0; j < 3; ++j)
+    {
+        l.c[j + 1] = q1.c[0] * q2.c[j + 1] + q1.c[j + 1] * q2.c[0] + c.c[j];
+    }
+
+    return l;
+}
+
+//
+// The kernels for both instruction sets. With a single quaternion,
+// its components are splatted across the lanes once. Each group is
+// loaded before it is stored, so dst may be an input.
+//
+
+template <class W>
+IMATH_SIMD_INLINE void
+rotateGroups (
+    const Quat<typename W::BaseType>& q,
+    const Vec3<typename W::BaseType>* src,
+    Vec3<typename W::BaseType>*       dst,
+    size_t                            n)
+{
+    typedef typename W::Mask Mask;
+
+    QuatLanes<W> ql;
+
+    ql.c[0] = splat<W> (q.r);
+    ql.c[1] = splat<W> (q.v.x);
+    ql.c[2] = splat<W> (q.v.y);
+    ql.c[3] = splat<W> (q.v.z);
+
+    for (size_t i = 0; i < n; i += W::lanes)
+    {
+        const size_t k    = laneCount<W> (n, i);
+        const Mask   mask = Mask ((1u << k) - 1);
+
+        storeVec3 (dst + i, mask, rotateLanes (ql, loadVec3<W> (src + i, mask)));
+    }
+}
+
+template <class W>
+IMATH_SIMD_INLINE void
+rotateEachGroups (
+    const Quat<typename W::BaseType>* q,
+    const Vec3<typename W::BaseType>* src,
+    Vec3<typename W::BaseType>*       dst,
+    size_t                            n)
+{
+    typedef typename W::Mask Mask;
+
+    for (size_t i = 0; i < n; i += W::lanes)
+    {
+        const size_t k    = laneCount<W> (n, i);
+        const Mask   mask = Mask ((1u << k) - 1);
+
+        storeVec3 (
+            dst + i,
+            mask,
+            rotateLanes (loadQuat<W> (q + i, mask), loadVec3<W> (src + i, mask)));
+    }
+}
+
+template <class W>
+IMATH_SIMD_INLINE void
+multiplyGroups (
+    const Quat<typename W::BaseType>* q1,
+    const Quat<typename W::BaseType>* q2,
+    Quat<typename W::BaseType>*       dst,
+    size_t                            n)
+{
+    typedef typename W::Mask Mask;
+
+    for (size_t i = 0; i < n; i += W::lanes)
+    {
+        const size_t k    = laneCount<W> (n, i);
+        const Mask   mask = Mask ((1u << k) - 1);
+
+        storeQuat (
+            dst + i,
+            mask,
+            multiplyLanes (loadQuat<W> (q1 + i, mask), loadQuat<W> (q2 + i, mask)));
+    }
+}
+
+//
+// Quat::toMatrix33() or toMatrix44(), for the N x N matrices whose
+// elements start at m. The nine rotation elements are computed as
+// those functions compute them; for N = 4, the other elements are
+// those of the identity.
+//
+
+template <class W, int N>
+IMATH_SIMD_INLINE void
+toMatrixGroups (
+    const Quat<typename W::BaseType>* q,
+    typename W::BaseType*             m,
+    size_t                            n)
+{
+    typedef typename W::BaseType T;
+    typedef typename W::Mask     Mask;
+
+    const W one = splat<W> (T (1));
+    const W two = splat<W> (T (2));
+
+    for (size_t i = 0; i < n; i += W::lanes)
+    {
+        const size_t k    = laneCount<W> (n, i);
+        const Mask   mask = Mask ((1u << k) - 1);
+
+        const QuatLanes<W> l = loadQuat<W> (q + i, mask);
+
+        const W r = l.c[0];
+        const W x = l.c[1];
+        const W y = l.c[2];
+        const W z = l.c[3];
+
+        W e[N][N];
+
+        e[0][0] = one - two * (y * y + z * z);
+        e[0][1] = two * (x * y + z * r);
+        e[0][2] = two * (z * x - y * r);
+
+        e[1][0] = two * (x * y - z * r);
+        e[1][1] = one - two * (z * z + x * x);
+        e[1][2] = two * (y * z + x * r);
+
+        e[2][0] = two * (z * x + y * r);
+        e[2][1] = two * (y * z - x * r);
+        e[2][2] = one - two * (y * y + x * x);
+
+        for (int a = 3; a < N; ++a)
+        {
+            for (int b = 0; b < N; ++b)
+                e[a][b] = e[b][a] = splat<W> (T (a == b));
+        }
+
+        //
+        // Transpose the elements through memory, which is faster than
+        // scattering them
+        //
+
+        T buf[N * N][W::lanes];
+
+        for (int a = 0; a < N; ++a)
+        {
+            for (int b = 0; b < N; ++b)
+                store (buf[a * N + b], e[a][b]);
+        }
+
+        T* p = m + i * N * N;
+
+        for (size_t j = 0; j < k; ++j)
+        {
+            for (int c = 0; c < N * N; ++c)
+                p[j * N * N + c] = buf[c][j];
+        }
+    }
+}
+
+template <class W>
+IMATH_TARGET_AVX512 void
+rotateAVX512 (
+    const Quat<typename W::BaseType>& q,
+    const Vec3<typename W::BaseType>* src,
+    Vec3<typename W::BaseType>*       dst,
+    size_t                            n)
+{
+    rotateGroups<W> (q, src, dst, n);
+}
+
+template <class W>
+IMATH_TARGET_AVX512 void
+rotateEachAVX512 (
+    const Quat<typename W::BaseType>* q,
+    const Vec3<typename W::BaseType>* src,
+    Vec3<typename W::BaseType>*       dst,
+    size_t                            n)
+{
+    rotateEachGroups<W> (q, src, dst, n);
+}
+
+template <class W>
+IMATH_TARGET_AVX512 void
+multiplyAVX512 (
+    const Quat<typename W::BaseType>* q1,
+    const Quat<typename W::BaseType>* q2,
+    Quat<typename W::BaseType>*       dst,
+    size_t                            n)
+{
+    multiplyGroups<W> (q1, q2, dst, n);
+}
+
+template <class W, int N>
+IMATH_TARGET_AVX512 void
+toMatrixAVX512 (
+    const Quat<typename W::BaseType>* q,
+    typename W::BaseType*             m,
+    size_t                            n)
+{
+    toMatrixGroups<W, N> (q, m, n);
+}
+
+template <class W>
+IMATH_TARGET_AVX2 void
+rotateAVX2 (
+    const Quat<typename W::BaseType>& q,
+    const Vec3<typename W::BaseType>* src,
+    Vec3<typename W::BaseType>*       dst,
+    size_t                            n)
+{
+    rotateGroups<W> (q, src, dst, n);
+}
+
+template <class W>
+IMATH_TARGET_AVX2 void
+rotateEachAVX2 (
+    const Quat<typename W::BaseType>* q,
+    const Vec3<typename W::BaseType>* src,
+    Vec3<typename W::BaseType>*       dst,
+    size_t                            n)
+{
+    rotateEachGroups<W> (q, src, dst, n);
+}
+
+template <class W>
+IMATH_TARGET_AVX2 void
+multiplyAVX2 (
+    const Quat<typename W::BaseType>* q1,
+    const Quat<typename W::BaseType>* q2,
+    Quat<typename W::BaseType>*       dst,
+    size_t                            n)
+{
+    multiplyGroups<W> (q1, q2, dst, n);
+}
+
+template <class W, int N>
+IMATH_TARGET_AVX2 void
+toMatrixAVX2 (
+    const Quat<typename W::BaseType>* q,
+    typename W::BaseType*             m,
+    size_t                            n)
+{
+    toMatrixGroups<W, N> (q, m, n);
+}
+
+//
+// The register types of the kernels for each base type
+//
+
+template <class T> struct QuatKernel;
+
+template <> struct QuatKernel<float>
+{
+    typedef FloatLanes16 AVX512;
+    typedef FloatLanes8  AVX2;
+};
+
+template <> struct QuatKernel<double>
+{
+    typedef DoubleLanes8 AVX512;
+    typedef DoubleLanes4 AVX2;
+};
+
+IMATH_AVX512_KERNELS_END
+
+#endif // IMATH_X86_RUNTIME_DISPATCH
+
+template <class T>
+void
+slerpQuats (
+    const Quat<T>* q1,
+    const Quat<T>* q2,
+    const T*       t,
+    Quat<T>*       dst,
+    size_t         n,
+    bool           shortestArc)
+{
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+    if (imathCpuFeatures ().avx512f)
+    {
+        slerpAVX512<typename QuatKernel<T>::AVX512> (
+            q1, q2, t, dst, n, shortestArc);
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        dst[i] = shortestArc ? slerpShortestArc (q1[i], q2[i], t[i])
+                             : slerp (q1[i], q2[i], t[i]);
+    }
+}
+
+template <class T>
+void
+squadQuats (
+    const Quat<T>* q1,
+    const Quat<T>* qa,
+    const Quat<T>* qb,
+    const Quat<T>* q2,
+    const T*       t,
+    Quat<T>*       dst,
+    size_t         n)
+{
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+    if (imathCpuFeatures ().avx512f)
+    {
+        squadAVX512<typename QuatKernel<T>::AVX512> (
+            q1, qa, qb, q2, t, dst, n);
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < n; ++i)
+        dst[i] = squad (q1[i], qa[i], qb[i], q2[i], t[i]);
+}
+
+template <class T>
+void
+slerpSegments (
+    const SlerpSegment<T>* segments,
+    const int*             index,
+    const T*               t,
+    Quat<T>*               dst,
+    size_t                 n)
+{
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+    if (imathCpuFeatures ().avx512f)
+    {
+        slerpSegmentAVX512<typename QuatKernel<T>::AVX512> (
+            segments, index, t, dst, n);
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < n; ++i)
+        dst[i] = segments[index[i]](t[i]);
+}
+
+template <class T>
+void
+rotateVectors (const Quat<T>& q, const Vec3<T>* src, Vec3<T>* dst, size_t n)
+{
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+    const ImathCpuFeatures& cpu = imathCpuFeatures ();
+
+    if (cpu.avx512f)
+    {
+        rotateAVX512<typename QuatKernel<T>::AVX512> (q, src, dst, n);
+        return;
+    }
+
+    if (cpu.avx2)
+    {
+        rotateAVX2<typename QuatKernel<T>::AVX2> (q, src, dst, n);
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < n; ++i)
+        dst[i] = src[i] * q;
+}
+
+template <class T>
+void
+rotateVectors (const Quat<T>* q, const Vec3<T>* src, Vec3<T>* dst, size_t n)
+{
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+    const ImathCpuFeatures& cpu = imathCpuFeatures ();
+
+    if (cpu.avx512f)
+    {
+        rotateEachAVX512<typename QuatKernel<T>::AVX512> (q, src, dst, n);
+        return;
+    }
+
+    if (cpu.avx2)
+    {
+        rotateEachAVX2<typename QuatKernel<T>::AVX2> (q, src, dst, n);
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < n; ++i)
+        dst[i] = src[i] * q[i];
+}
+
+template <class T>
+void
+multiplyQuats (const Quat<T>* q1, const Quat<T>* q2, Quat<T>* dst, size_t n)
+{
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+    const ImathCpuFeatures& cpu = imathCpuFeatures ();
+
+    if (cpu.avx512f)
+    {
+        multiplyAVX512<typename QuatKernel<T>::AVX512> (q1, q2, dst, n);
+        return;
+    }
+
+    if (cpu.avx2)
+    {
+        multiplyAVX2<typename QuatKernel<T>::AVX2> (q1, q2, dst, n);
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < n; ++i)
+        dst[i] = q1[i] * q2[i];
+}
+
+template <class T>
+void
+toMatrices (const Quat<T>* q, Matrix33<T>* dst, size_t n)
+{
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+    const ImathCpuFeatures& cpu = imathCpuFeatures ();
+
+    if (cpu.avx512f)
+    {
+        toMatrixAVX512<typename QuatKernel<T>::AVX512, 3> (q, &dst->x[0][0], n);
+        return;
+    }
+
+    if (cpu.avx2)
+    {
+        toMatrixAVX2<typename QuatKernel<T>::AVX2, 3> (q, &dst->x[0][0], n);
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < n; ++i)
+        dst[i] = q[i].toMatrix33 ();
+}
+
+template <class T>
+void
+toMatrices (const Quat<T>* q, Matrix44<T>* dst, size_t n)
+{
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+    const ImathCpuFeatures& cpu = imathCpuFeatures ();
+
+    if (cpu.avx512f)
+    {
+        toMatrixAVX512<typename QuatKernel<T>::AVX512, 4> (q, &dst->x[0][0], n);
+        return;
+    }
+
+    if (cpu.avx2)
+    {
+        toMatrixAVX2<typename QuatKernel<T>::AVX2, 4> (q, &dst->x[0][0], n);
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < n; ++i)
+        dst[i] = q[i].toMatrix44 ();
+}
+
+} // namespace
+
+IMATH_EXPORT void
+slerpArray (
+    const Quat<float>* q1,
+    const Quat<float>* q2,
+    const float*       t,
+    Quat<float>*       dst,
+    size_t             n) IMATH_NOEXCEPT
+{
+    slerpQuats (q1, q2, t, dst, n, false);
+}
+
+IMATH_EXPORT void
+slerpArray (
+    const Quat<double>* q1,
+    const Quat<double>* q2,
+    const double*       t,
+    Quat<double>*       dst,
+    size_t              n) IMATH_NOEXCEPT
+{
+    slerpQuats (q1, q2, t, dst, n, false);
+}
+
+IMATH_EXPORT void
+slerpShortestArcArray (
+    const Quat<float>* q1,
+    const Quat<float>* q2,
+    const float*       t,
+    Quat<float>*       dst,
+    size_t             n) IMATH_NOEXCEPT
+{
+    slerpQuats (q1, q2, t, dst, n, true);
+}
+
+IMATH_EXPORT void
+slerpShortestArcArray (
+    const Quat<double>* q1,
+    const Quat<double>* q2,
+    const double*       t,
+    Quat<double>*       dst,
+    size_t              n) IMATH_NOEXCEPT
+{
+    slerpQuats (q1, q2, t, dst, n, true);
+}
+
+IMATH_EXPORT void
+squadArray (
+    const Quat<float>* q1,
+    const Quat<float>* qa,
+    const Quat<float>* qb,
+    const Quat<float>* q2,
+    const float*       t,
+    Quat<float>*       dst,
+    size_t             n) IMATH_NOEXCEPT
+{
+    squadQuats (q1, qa, qb, q2, t, dst, n);
+}
+
+IMATH_EXPORT void
+squadArray (
+    const Quat<double>* q1,
+    const Quat<double>* qa,
+    const Quat<double>* qb,
+    const Quat<double>* q2,
+    const double*       t,
+    Quat<double>*       dst,
+    size_t              n) IMATH_NOEXCEPT
+{
+    squadQuats (q1, qa, qb, q2, t, dst, n);
+}
+
+IMATH_EXPORT void
+slerpSegmentArray (
+    const SlerpSegment<float>* segments,
+    const int*                 index,
+    const float*               t,
+    Quat<float>*               dst,
+    size_t                     n) IMATH_NOEXCEPT
+{
+    slerpSegments (segments, index, t, dst, n);
+}
+
+IMATH_EXPORT void
+slerpSegmentArray (
+    const SlerpSegment<double>* segments,
+    const int*                  index,
+    const double*               t,
+    Quat<double>*               dst,
+    size_t                      n) IMATH_NOEXCEPT
+{
+    slerpSegments (segments, index, t, dst, n);
+}
+
+IMATH_EXPORT void
+rotateArray (
+    const Quat<float>& q,
+    const Vec3<float>* src,
+    Vec3<float>*       dst,
+    size_t             n) IMATH_NOEXCEPT
+{
+    rotateVectors (q, src, dst, n);
+}
+
+IMATH_EXPORT void
+rotateArray (
+    const Quat<double>& q,
+    const Vec3<double>* src,
+    Vec3<double>*       dst,
+    size_t              n) IMATH_NOEXCEPT
+{
+    rotateVectors (q, src, dst, n);
+}
+
+IMATH_EXPORT void
+rotateArray (
+    const Quat<float>* q,
+    const Vec3<float>* src,
+    Vec3<float>*       dst,
+    size_t             n) IMATH_NOEXCEPT
+{
+    rotateVectors (q, src, dst, n);
+}
+
+IMATH_EXPORT void
+rotateArray (
+    const Quat<double>* q,
+    const Vec3<double>* src,
+    Vec3<double>*       dst,
+    size_t              n) IMATH_NOEXCEPT
+{
+    rotateVectors (q, src, dst, n);
+}
+
+IMATH_EXPORT void
+multiplyArray (
+    const Quat<float>* q1,
+    const Quat<float>* q2,
+    Quat<float>*       dst,
+    size_t             n) IMATH_NOEXCEPT
+{
+    multiplyQuats (q1, q2, dst, n);
+}
+
+IMATH_EXPORT void
+multiplyArray (
+    const Quat<double>* q1,
+    const Quat<double>* q2,
+    Quat<double>*       dst,
+    size_t              n) IMATH_NOEXCEPT
+{
+    multiplyQuats (q1, q2, dst, n);
+}
+
+IMATH_EXPORT void
+toMatrix33Array (const Quat<float>* q, Matrix33<float>* dst, size_t n)
+    IMATH_NOEXCEPT
+{
+    toMatrices (q, dst, n);
+}
+
+IMATH_EXPORT void
+toMatrix33Array (const Quat<double>* q, Matrix33<double>* dst, size_t n)
+    IMATH_NOEXCEPT
+{
+    toMatrices (q, dst, n);
+}
+
+IMATH_EXPORT void
+toMatrix44Array (const Quat<float>* q, Matrix44<float>* dst, size_t n)
+    IMATH_NOEXCEPT
+{
+    toMatrices (q, dst, n);
+}
+
+IMATH_EXPORT void
+toMatrix44Array (const Quat<double>* q, Matrix44<double>* dst, size_t n)
+    IMATH_NOEXCEPT
+{
+    toMatrices (q, dst, n);
+}
+
+IMATH_INTERNAL_NAMESPACE_SOURCE_EXIT
@@ -223,6 +223,14 @@ template <class T>
 IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Quat<T>
 slerpShortestArc (const Quat<T>& q1, const Quat<T>& q2, T t) IMATH_NOEXCEPT;
 
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Quat<T>
+nlerp (const Quat<T>& q1, const Quat<T>& q2, T t) IMATH_NOEXCEPT;
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Quat<T>
+slerpShortestArcFast (const Quat<T>& q1, const Quat<T>& q2, T t) IMATH_NOEXCEPT;
+
 template <class T>
 IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Quat<T> squad (
     const Quat<T>& q1,
@@ -598,6 +606,69 @@ slerpShortestArc (const Quat<T>& q1, const Quat<T>& q2, T t) IMATH_NOEXCEPT
         return slerp (q1, -q2, t);
 }
 
+///
+/// Normalized linear interpolation: the normalized (1-t) * q1 + t * q2.
+/// The result lies on the same arc as slerp (q1, q2, t), but moves
+/// along it at a varying speed, so it differs from slerp() except at
+/// t = 0, 1/2 and 1; along the shortest arc, by up to 0.14 radians
+/// of rotation.
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline Quat<T>
+nlerp (const Quat<T>& q1, const Quat<T>& q2, T t) IMATH_NOEXCEPT
+{
+    Quat<T> q = (1 - t) * q1 + t * q2;
+
+    return q.normalized ();
+}
+
+///
+/// Approximate spherical linear interpolation along the shortest arc,
+/// without trigonometric functions: an nlerp() whose parameter is
+/// corrected by a polynomial. For unit quaternions q1 and q2 and
+/// 0 <= t <= 1, the result differs from slerpShortestArc (q1, q2, t)
+/// by a rotation of less than 6.1e-5 radians (0.0035 degrees), over
+/// the full range of angles between q1 and q2, plus rounding. The
+/// bound is that of the approximation, the same for float and
+/// double. Outside [0, 1], the error is not bounded.
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline Quat<T>
+slerpShortestArcFast (const Quat<T>& q1, const Quat<T>& q2, T t) IMATH_NOEXCEPT
+{
+    //
+    // nlerp (q1, q2, u) equals slerp (q1, q2, t) for
+    //
+    //     u = sin (t a) / (sin (t a) + sin ((1 - t) a)),
+    //
+    // where a is the angle between q1 and q2. u - t is odd about
+    // t = 1/2 and vanishes at t = 0, 1/2 and 1; it is approximated by
+    // t (t - 1/2) (t - 1) times a quadratic in (t - 1/2)^2, whose
+    // coefficients are polynomials in d = cos (a), fitted to minimize
+    // the maximum angular error for 0 <= d <= 1.
+    //
+
+    T       d = q1 ^ q2;
+    Quat<T> b = q2;
+
+    if (d < 0)
+    {
+        d = -d;
+        b = -q2;
+    }
+
+    const T k0 =
+        T (0.859044825) +
+        d * (T (-1.13245605) + d * (T (0.351175692) + d * T (-0.0728101806)));
+    const T k1 =
+        T (0.815970055) +
+        d * (T (-2.15596611) + d * (T (2.30997777) + d * T (-1.10570994)));
+    const T k2 = T (1.18846001) + d * (T (-4.04105864) + d * T (3.3640701));
+
+    const T h = (t - T (0.5)) * (t - T (0.5));
+    const T u = t + t * (t - T (0.5)) * (t - 1) * (k0 + h * (k1 + h * k2));
+
+    return nlerp (q1, b, u);
+}
+
 ///
 /// Spherical Cubic Spline Interpolation - from Advanced Animation and
 /// Rendering Techniques by Watt and Watt, Page 366:
@@ -1005,6 +1076,214 @@ IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline Vec3<T>
     return v + T (2) * (q.r * a + b);
 }
 
+//--------------------------------------
+// Spherical interpolation over arrays
+//--------------------------------------
+
+///
+/// The spherical linear interpolation from `q1` to `q2`, with the
+/// angle between them precomputed, for evaluating slerp (q1, q2, t)
+/// at many values of t. The result differs from that of slerp() only
+/// by rounding.
+///
+
+template <class T> struct SlerpSegment
+{
+    Quat<T> q1;       ///< The start of the segment
+    Quat<T> q2;       ///< The end of the segment
+    T       angle;    ///< angle4D (q1, q2)
+    T       invSinc;  ///< 1 / sinx_over_x (angle)
+
+    /// Interpolate from the identity to itself
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 SlerpSegment () IMATH_NOEXCEPT
+        : angle (0),
+          invSinc (1)
+    {}
+
+    /// Interpolate from `a` to `b`, which must be unit quaternions
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14
+    SlerpSegment (const Quat<T>& a, const Quat<T>& b) IMATH_NOEXCEPT
+        : q1 (a),
+          q2 (b),
+          angle (angle4D (a, b)),
+          invSinc (1 / sinx_over_x (angle))
+    {}
+
+    /// Return slerp (q1, q2, t)
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Quat<T>
+    operator() (T t) const IMATH_NOEXCEPT
+    {
+        const T s = 1 - t;
+
+        Quat<T> q = sinx_over_x (s * angle) * invSinc * s * q1 +
+                    sinx_over_x (t * angle) * invSinc * t * q2;
+
+        return q.normalized ();
+    }
+};
+
+//
+// Array forms of slerp(), slerpShortestArc() and squad(), which
+// evaluate one (q1, q2, t) problem per element. With AVX-512, 16
+// (float) or 8 (double) problems are evaluated at a time, with
+// polynomial approximations of the trigonometric functions, so the
+// results may differ from those of the functions for single
+// quaternions by a few ulps. For |t| > 64, where the approximations
+// lose accuracy, the single functions are used.
+//
+
+/// Compute `dst[i] = slerp (q1[i], q2[i], t[i])`, for `0 <= i < n`.
+/// `dst` may be the same array as `q1` or `q2`.
+IMATH_EXPORT void slerpArray (
+    const Quat<float>* q1,
+    const Quat<float>* q2,
+    const float*       t,
+    Quat<float>*       dst,
+    size_t             n) IMATH_NOEXCEPT;
+
+/// Compute `dst[i] = slerp (q1[i], q2[i], t[i])`, for `0 <= i < n`.
+IMATH_EXPORT void slerpArray (
+    const Quat<double>* q1,
+    const Quat<double>* q2,
+    const double*       t,
+    Quat<double>*       dst,
+    size_t              n) IMATH_NOEXCEPT;
+
+/// Compute `dst[i] = slerpShortestArc (q1[i], q2[i], t[i])`, for
+/// `0 <= i < n`.
+IMATH_EXPORT void slerpShortestArcArray (
+    const Quat<float>* q1,
+    const Quat<float>* q2,
+    const float*       t,
+    Quat<float>*       dst,
+    size_t             n) IMATH_NOEXCEPT;
+
+/// Compute `dst[i] = slerpShortestArc (q1[i], q2[i], t[i])`, for
+/// `0 <= i < n`.
+IMATH_EXPORT void slerpShortestArcArray (
+    const Quat<double>* q1,
+    const Quat<double>* q2,
+    const double*       t,
+    Quat<double>*       dst,
+    size_t              n) IMATH_NOEXCEPT;
+
+/// Compute `dst[i] = squad (q1[i], qa[i], qb[i], q2[i], t[i])`, for
+/// `0 <= i < n`.
+IMATH_EXPORT void squadArray (
+    const Quat<float>* q1,
+    const Quat<float>* qa,
+    const Quat<float>* qb,
+    const Quat<float>* q2,
+    const float*       t,
+    Quat<float>*       dst,
+    size_t             n) IMATH_NOEXCEPT;
+
+/// Compute `dst[i] = squad (q1[i], qa[i], qb[i], q2[i], t[i])`, for
+/// `0 <= i < n`.
+IMATH_EXPORT void squadArray (
+    const Quat<double>* q1,
+    const Quat<double>* qa,
+    const Quat<double>* qb,
+    const Quat<double>* q2,
+    const double*       t,
+    Quat<double>*       dst,
+    size_t              n) IMATH_NOEXCEPT;
+
+/// Compute `dst[i] = segments[index[i]] (t[i])`, for `0 <= i < n`.
+IMATH_EXPORT void slerpSegmentArray (
+    const SlerpSegment<float>* segments,
+    const int*                 index,
+    const float*               t,
+    Quat<float>*               dst,
+    size_t                     n) IMATH_NOEXCEPT;
+
+/// Compute `dst[i] = segments[index[i]] (t[i])`, for `0 <= i < n`.
+IMATH_EXPORT void slerpSegmentArray (
+    const SlerpSegment<double>* segments,
+    const int*                  index,
+    const double*               t,
+    Quat<double>*               dst,
+    size_t                      n) IMATH_NOEXCEPT;
+
+//----------------------------------------------------
+// Rotation, multiplication and conversion over arrays
+//----------------------------------------------------
+
+//
+// Array forms of operator*(Vec3, Quat), operator*(Quat, Quat),
+// toMatrix33() and toMatrix44(). With AVX-512, 16 (float) or 8
+// (double) elements are processed at a time, and with AVX2, 8 (float)
+// or 4 (double), with the same operations in the same order as the
+// scalar functions, so the results are those of the functions compiled
+// without floating-point contraction.
+//
+
+/// Rotate `n` vectors by the unit quaternion `q`: compute
+/// `dst[i] = src[i] * q`, for `0 <= i < n`. `dst` may be the same
+/// array as `src`.
+IMATH_EXPORT void rotateArray (
+    const Quat<float>& q,
+    const Vec3<float>* src,
+    Vec3<float>*       dst,
+    size_t             n) IMATH_NOEXCEPT;
+
+/// Rotate `n` vectors by the unit quaternion `q`: compute
+/// `dst[i] = src[i] * q`, for `0 <= i < n`.
+IMATH_EXPORT void rotateArray (
+    const Quat<double>& q,
+    const Vec3<double>* src,
+    Vec3<double>*       dst,
+    size_t              n) IMATH_NOEXCEPT;
+
+/// Rotate each of `n` vectors by its own unit quaternion: compute
+/// `dst[i] = src[i] * q[i]`, for `0 <= i < n`. `dst` may be the
+/// same array as `src`.
+IMATH_EXPORT void rotateArray (
+    const Quat<float>* q,
+    const Vec3<float>* src,
+    Vec3<float>*       dst,
+    size_t             n) IMATH_NOEXCEPT;
+
+/// Rotate each of `n` vectors by its own unit quaternion: compute
+/// `dst[i] = src[i] * q[i]`, for `0 <= i < n`.
+IMATH_EXPORT void rotateArray (
+    const Quat<double>* q,
+    const Vec3<double>* src,
+    Vec3<double>*       dst,
+    size_t              n) IMATH_NOEXCEPT;
+
+/// Compute `dst[i] = q1[i] * q2[i]`, for `0 <= i < n`. `dst` may be
+/// the same array as `q1` or `q2`.
+IMATH_EXPORT void multiplyArray (
+    const Quat<float>* q1,
+    const Quat<float>* q2,
+    Quat<float>*       dst,
+    size_t             n) IMATH_NOEXCEPT;
+
+/// Compute `dst[i] = q1[i] * q2[i]`, for `0 <= i < n`.
+IMATH_EXPORT void multiplyArray (
+    const Quat<double>* q1,
+    const Quat<double>* q2,
+    Quat<double>*       dst,
+    size_t              n) IMATH_NOEXCEPT;
+
+/// Compute `dst[i] = q[i].toMatrix33 ()`, for `0 <= i < n`. See
+/// extractQuatArray() for the reverse conversion.
+IMATH_EXPORT void toMatrix33Array (
+    const Quat<float>* q, Matrix33<float>* dst, size_t n) IMATH_NOEXCEPT;
+
+/// Compute `dst[i] = q[i].toMatrix33 ()`, for `0 <= i < n`.
+IMATH_EXPORT void toMatrix33Array (
+    const Quat<double>* q, Matrix33<double>* dst, size_t n) IMATH_NOEXCEPT;
+
+/// Compute `dst[i] = q[i].toMatrix44 ()`, for `0 <= i < n`.
+IMATH_EXPORT void toMatrix44Array (
+    const Quat<float>* q, Matrix44<float>* dst, size_t n) IMATH_NOEXCEPT;
+
+/// Compute `dst[i] = q[i].toMatrix44 ()`, for `0 <= i < n`.
+IMATH_EXPORT void toMatrix44Array (
+    const Quat<double>* q, Matrix44<double>* dst, size_t n) IMATH_NOEXCEPT;
+
 #if (defined _WIN32 || defined _WIN64) && defined _MSC_VER
 #    pragma warning(pop)
 #endif
@@ -0,0 +1,359 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+//
+// A keyframed rotation curve, sampled with slerp or squad
+//
+
+#ifndef INCLUDED_IMATHQUATTRACK_H
+#define INCLUDED_IMATHQUATTRACK_H
+
+#include "ImathExport.h"
+#include "ImathNamespace.h"
+
+#include "ImathQuat.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+///
+/// The `QuatTrack` class template holds a rotation curve given by
+/// unit quaternion keys at increasing times, and samples it.
+///
+/// Between two keys, the curve is interpolated either linearly, with
+/// slerp(), or with a spherical cubic spline, as by spline(), whose
+/// outer keys are repeated at the ends of the curve. Before the first
+/// key and after the last one, the curve is constant.
+///
+/// The constructor precomputes, for each segment between two keys,
+/// the angle between them and the sine term that slerp() divides by,
+/// and for splines the intermediate() control points, so that a
+/// sample costs no more than evaluating the interpolation itself.
+/// sample() and resample() evaluate many times at once with
+/// slerpSegmentArray() and slerpArray(), and the same approximations:
+/// their results may differ from those of sample() for a single time
+/// by a few ulps.
+///
+/// Only `QuatTrack<float>` and `QuatTrack<double>` are supported.
+///
+
+template <class T> class IMATH_EXPORT_TEMPLATE_TYPE QuatTrack
+{
+public:
+    /// The interpolation between keys
+    enum Interpolation
+    {
+        LINEAR, ///< slerp() between each pair of keys
+        SPLINE  ///< spline() through each pair of keys and their neighbors
+    };
+
+    /// @{
+    /// @name Constructors
+
+    /// An empty track, which is the identity at all times
+    QuatTrack ();
+
+    /// A track with keys `keys[i]` at `times[i]`, for `0 <= i < n`.
+    /// The keys must be unit quaternions. If `shortestArc` is true,
+    /// each key is negated where needed so that it lies in the same
+    /// hemisphere as the one before it, so that the curve follows the
+    /// shortest arc between keys, as slerpShortestArc() does.
+    /// @throw std::invalid_argument if the times are not increasing
+    QuatTrack (
+        const T*       times,
+        const Quat<T>* keys,
+        int            n,
+        Interpolation  interpolation = LINEAR,
+        bool           shortestArc   = true);
+
+    /// @}
+
+    /// @{
+    /// @name Keys
+
+    /// The number of keys
+    int size () const IMATH_NOEXCEPT;
+
+    /// The interpolation between keys
+    Interpolation interpolation () const IMATH_NOEXCEPT;
+
+    /// The time of key `i`
+    T time (int i) const IMATH_NOEXCEPT;
+
+    /// Key `i`, negated if the constructor moved it to the hemisphere
+    /// of the key before it
+    const Quat<T>& key (int i) const IMATH_NOEXCEPT;
+
+    /// @}
+
+    /// @{
+    /// @name Sampling
+
+    /// The rotation at `time`
+    Quat<T> sample (T time) const IMATH_NOEXCEPT;
+
+    /// Compute `dst[i] = sample (times[i])`, for `0 <= i < n`. The
+    /// times need not be sorted, but sampling is fastest when they
+    /// are.
+    void sample (const T* times, Quat<T>* dst, size_t n) const IMATH_NOEXCEPT;
+
+    /// Compute `dst[i] = sample (start + i * step)`, for `0 <= i < n`,
+    /// as when resampling the track at a new frame rate
+    void resample (T start, T step, Quat<T>* dst, size_t n) const
+        IMATH_NOEXCEPT;
+
+    /// @}
+
+    /// The base type
+    typedef T BaseType;
+
+private:
+    //
+    // The number of samples evaluated at a time by sample() and
+    // resample()
+    //
+
+    enum
+    {
+        CHUNK = 256
+    };
+
+    int  locate (T time, int hint, T& u) const IMATH_NOEXCEPT;
+    void sampleChunk (const T* times, Quat<T>* dst, size_t n, int& hint) const
+        IMATH_NOEXCEPT;
+
+    Interpolation _interpolation;
+
+    std::vector<T>       _times;
+    std::vector<Quat<T>> _keys;
+
+    //
+    // For segment k, between keys k and k + 1: the slerp between the
+    // keys, 1 / (times[k + 1] - times[k]) and, for splines, the slerp
+    // between the intermediate() control points
+    //
+
+    std::vector<SlerpSegment<T>> _segments;
+    std::vector<T>               _invDurations;
+    std::vector<SlerpSegment<T>> _controls;
+};
+
+/// Track of float quaternions
+typedef QuatTrack<float> QuatTrackf;
+
+/// Track of double quaternions
+typedef QuatTrack<double> QuatTrackd;
+
+//---------------
+// Implementation
+//---------------
+
+template <class T>
+inline QuatTrack<T>::QuatTrack () : _interpolation (LINEAR)
+{}
+
+template <class T>
+inline QuatTrack<T>::QuatTrack (
+    const T*       times,
+    const Quat<T>* keys,
+    int            n,
+    Interpolation  interpolation,
+    bool           shortestArc)
+    : _interpolation (interpolation),
+      _times (times, times + std::max (n, 0)),
+      _keys (keys, keys + std::max (n, 0))
+{
+    for (int i = 1; i < n; ++i)
+    {
+        if (!(_times[i - 1] < _times[i]))
+            throw std::invalid_argument (
+                "The times of the keys of a quaternion track "
+                "must be increasing.");
+
+        if (shortestArc && (_keys[i - 1] ^ _keys[i]) < 0)
+            _keys[i] = -_keys[i];
+    }
+
+    for (int i = 0; i + 1 < n; ++i)
+    {
+        _segments.push_back (SlerpSegment<T> (_keys[i], _keys[i + 1]));
+        _invDurations.push_back (1 / (_times[i + 1] - _times[i]));
+
+        if (interpolation == SPLINE)
+        {
+            const Quat<T>& q0 = _keys[std::max (i - 1, 0)];
+            const Quat<T>& q1 = _keys[i];
+            const Quat<T>& q2 = _keys[i + 1];
+            const Quat<T>& q3 = _keys[std::min (i + 2, n - 1)];
+
+            _controls.push_back (SlerpSegment<T> (
+                intermediate (q0, q1, q2), intermediate (q1, q2, q3)));
+        }
+    }
+}
+
+template <class T>
+inline int
+QuatTrack<T>::size () const IMATH_NOEXCEPT
+{
+    return int (_keys.size ());
+}
+
+template <class T>
+inline typename QuatTrack<T>::Interpolation
+QuatTrack<T>::interpolation () const IMATH_NOEXCEPT
+{
+    return _interpolation;
+}
+
+template <class T>
+inline T
+QuatTrack<T>::time (int i) const IMATH_NOEXCEPT
+{
+    return _times[i];
+}
+
+template <class T>
+inline const Quat<T>&
+QuatTrack<T>::key (int i) const IMATH_NOEXCEPT
+{
+    return _keys[i];
+}
+
+//
+// Return the segment that contains time, and set u to the position
+// of time within it, from 0 to 1. Times outside the track are clamped
+// to its ends, and a NaN to its start. The search starts at segment
+// hint, so that a sequence of increasing times is located in a single
+// pass over the keys. There must be at least two keys.
+//
+
+template <class T>
+inline int
+QuatTrack<T>::locate (T time, int hint, T& u) const IMATH_NOEXCEPT
+{
+    const int last = int (_segments.size ()) - 1;
+
+    if (!(time > _times[0]))
+    {
+        u = 0;
+        return 0;
+    }
+
+    if (time >= _times[last + 1])
+    {
+        u = 1;
+        return last;
+    }
+
+    int k = hint;
+
+    if (time < _times[k])
+    {
+        k = int (std::upper_bound (_times.begin (), _times.end (), time) -
+                 _times.begin ()) -
+            1;
+    }
+    else
+    {
+        while (k < last && time >= _times[k + 1])
+            ++k;
+    }
+
+    u = (time - _times[k]) * _invDurations[k];
+    return k;
+}
+
+template <class T>
+inline Quat<T>
+QuatTrack<T>::sample (T time) const IMATH_NOEXCEPT
+{
+    if (_keys.size () < 2) return _keys.empty () ? Quat<T> () : _keys[0];
+
+    T         u;
+    const int k = locate (time, 0, u);
+
+    if (_interpolation == LINEAR) return _segments[k](u);
+
+    return slerp (_segments[k](u), _controls[k](u), 2 * u * (1 - u));
+}
+
+template <class T>
+inline void
+QuatTrack<T>::sampleChunk (
+    const T* times, Quat<T>* dst, size_t n, int& hint) const IMATH_NOEXCEPT
+{
+    int index[CHUNK];
+    T   u[CHUNK];
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        index[i] = hint = locate (times[i], hint, u[i]);
+    }
+
+    slerpSegmentArray (&_segments[0], index, u, dst, n);
+
+    if (_interpolation == SPLINE)
+    {
+        Quat<T> r2[CHUNK];
+        T       w[CHUNK];
+
+        slerpSegmentArray (&_controls[0], index, u, r2, n);
+
+        for (size_t i = 0; i < n; ++i)
+            w[i] = 2 * u[i] * (1 - u[i]);
+
+        slerpArray (dst, r2, w, dst, n);
+    }
+}
+
+template <class T>
+inline void
+QuatTrack<T>::sample (const T* times, Quat<T>* dst, size_t n) const
+    IMATH_NOEXCEPT
+{
+    if (_keys.size () < 2)
+    {
+        std::fill (dst, dst + n, _keys.empty () ? Quat<T> () : _keys[0]);
+        return;
+    }
+
+    int hint = 0;
+
+    for (size_t i = 0; i < n; i += CHUNK)
+        sampleChunk (times + i, dst + i, std::min<size_t> (n - i, CHUNK), hint);
+}
+
+template <class T>
+inline void
+QuatTrack<T>::resample (T start, T step, Quat<T>* dst, size_t n) const
+    IMATH_NOEXCEPT
+{
+    if (_keys.size () < 2)
+    {
+        std::fill (dst, dst + n, _keys.empty () ? Quat<T> () : _keys[0]);
+        return;
+    }
+
+    int hint = 0;
+    T   times[CHUNK];
+
+    for (size_t i = 0; i < n; i += CHUNK)
+    {
+        const size_t m = std::min<size_t> (n - i, CHUNK);
+
+        for (size_t j = 0; j < m; ++j)
+            times[j] = start + T (i + j) * step;
+
+        sampleChunk (times, dst + i, m, hint);
+    }
+}
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif // INCLUDED_IMATHQUATTRACK_H
@@ -0,0 +1,568 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+//---------------------------------------------------------------------------
+//
+//	AVX-512 and AVX2 register wrappers for structure-of-arrays
+//	kernels, shared by the library sources. This header is private to
+//	the library and is not installed.
+//
+//	A kernel in structure-of-arrays form processes 16 float or 8
+//	double problems at a time with AVX-512, or 8 float or 4 double
+//	problems with AVX2, one per lane, with the same operations in the
+//	same order as scalar code for a single problem, so that each
+//	lane's results are identical to the scalar ones. The wrappers give
+//	the registers arithmetic operators, so that such a kernel is
+//	written once, as a template, for both types.
+//
+//	The wrappers are compiled for their instruction set regardless of
+//	the library's compiler flags, and must only be called after
+//	imathCpuFeatures() has reported support for it. The AVX2 wrappers
+//	only have the operations that the AVX2 kernels need.
+//
+//	Lane arithmetic shared by the kernels for both instruction sets is
+//	declared IMATH_SIMD_INLINE. It has no target of its own, and is
+//	always inlined into the kernel that uses it, so it is compiled for
+//	that kernel's instruction set.
+//
+//---------------------------------------------------------------------------
+
+#ifndef INCLUDED_IMATHSIMD_H
+#define INCLUDED_IMATHSIMD_H
+
+#include "ImathCpuFeatures.h"
+#include "ImathNamespace.h"
+
+#include <cstddef>
+#include <limits>
+
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+
+#    if defined(_MSC_VER) && !defined(__clang__)
+#        define IMATH_SIMD_INLINE __forceinline
+#    else
+#        define IMATH_SIMD_INLINE inline __attribute__ ((always_inline))
+#    endif
+
+IMATH_AVX512_KERNELS_BEGIN
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+namespace
+{
+
+struct FloatLanes16
+{
+    typedef float     BaseType;
+    typedef __mmask16 Mask;
+    enum { lanes = 16 };
+
+    __m512 v;
+};
+
+struct DoubleLanes8
+{
+    typedef double   BaseType;
+    typedef __mmask8 Mask;
+    enum { lanes = 8 };
+
+    __m512d v;
+};
+
+//
+// AVX2 has no mask registers; the mask of an AVX2 wrapper has a bit
+// per lane, as an AVX-512 mask does.
+//
+
+struct FloatLanes8
+{
+    typedef float    BaseType;
+    typedef unsigned Mask;
+    enum { lanes = 8 };
+
+    __m256 v;
+};
+
+struct DoubleLanes4
+{
+    typedef double   BaseType;
+    typedef unsigned Mask;
+    enum { lanes = 4 };
+
+    __m256d v;
+};
+
+//
+// The number of lanes of W that problems i and above of n fill: all
+// of them, except for the last group of problems.
+//
+
+template <class W>
+inline size_t
+laneCount (size_t n, size_t i)
+{
+    return n - i < size_t (W::lanes) ? n - i : size_t (W::lanes);
+}
+
+IMATH_TARGET_AVX512 inline FloatLanes16
+operator+ (FloatLanes16 a, FloatLanes16 b)
+{
+    return {_mm512_add_ps (a.v, b.v)};
+}
+
+IMATH_TARGET_AVX512 inline FloatLanes16
+operator- (FloatLanes16 a, FloatLanes16 b)
+{
+    return {_mm512_sub_ps (a.v, b.v)};
+}
+
+IMATH_TARGET_AVX512 inline FloatLanes16
+operator* (FloatLanes16 a, FloatLanes16 b)
+{
+    return {_mm512_mul_ps (a.v, b.v)};
+}
+
+IMATH_TARGET_AVX512 inline FloatLanes16
+operator/ (FloatLanes16 a, FloatLanes16 b)
+{
+    return {_mm512_div_ps (a.v, b.v)};
+}
+
+IMATH_TARGET_AVX512 inline DoubleLanes8
+operator+ (DoubleLanes8 a, DoubleLanes8 b)
+{
+    return {_mm512_add_pd (a.v, b.v)};
+}
+
+IMATH_TARGET_AVX512 inline DoubleLanes8
+operator- (DoubleLanes8 a, DoubleLanes8 b)
+{
+    return {_mm512_sub_pd (a.v, b.v)};
+}
+
+IMATH_TARGET_AVX512 inline DoubleLanes8
+operator* (DoubleLanes8 a, DoubleLanes8 b)
+{
+    return {_mm512_mul_pd (a.v, b.v)};
+}
+
+IMATH_TARGET_AVX512 inline DoubleLanes8
+operator/ (DoubleLanes8 a, DoubleLanes8 b)
+{
+    return {_mm512_div_pd (a.v, b.v)};
+}
+
+IMATH_TARGET_AVX512 inline FloatLanes16
+splat (float a)
+{
+    return {_mm512_set1_ps (a)};
+}
+
+IMATH_TARGET_AVX512 inline DoubleLanes8
+splat (double a)
+{
+    return {_mm512_set1_pd (a)};
+}
+
+//
+// splat<W> (a), for lane arithmetic shared by several register types
+//
+
+template <class W> W splat (typename W::BaseType a);
+
+template <>
+IMATH_TARGET_AVX512 inline FloatLanes16
+splat<FloatLanes16> (float a)
+{
+    return splat (a);
+}
+
+template <>
+IMATH_TARGET_AVX512 inline DoubleLanes8
+splat<DoubleLanes8> (double a)
+{
+    return splat (a);
+}
+
+//
+// gather (p, mask, fill) loads p[Stride * i] into lane i for the
+// lanes in mask, and fill into the others; scatter (p, mask, v)
+// stores the lanes in mask back. The default stride is that of the
+// elements of an array of Matrix44.
+//
+
+template <int Stride>
+IMATH_TARGET_AVX512 inline __m512i
+laneOffsets16 ()
+{
+    return _mm512_mullo_epi32 (
+        _mm512_set_epi32 (15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0),
+        _mm512_set1_epi32 (Stride));
+}
+
+template <int Stride>
+IMATH_TARGET_AVX512 inline __m256i
+laneOffsets8 ()
+{
+    return _mm256_mullo_epi32 (
+        _mm256_set_epi32 (7, 6, 5, 4, 3, 2, 1, 0), _mm256_set1_epi32 (Stride));
+}
+
+template <int Stride = 16>
+IMATH_TARGET_AVX512 inline FloatLanes16
+gather (const float* p, __mmask16 mask, float fill)
+{
+    return {_mm512_mask_i32gather_ps (
+        _mm512_set1_ps (fill), mask, laneOffsets16<Stride> (), p, 4)};
+}
+
+template <int Stride = 16>
+IMATH_TARGET_AVX512 inline DoubleLanes8
+gather (const double* p, __mmask8 mask, double fill)
+{
+    return {_mm512_mask_i32gather_pd (
+        _mm512_set1_pd (fill), mask, laneOffsets8<Stride> (), p, 8)};
+}
+
+template <int Stride = 16>
+IMATH_TARGET_AVX512 inline void
+scatter (float* p, __mmask16 mask, FloatLanes16 v)
+{
+    _mm512_mask_i32scatter_ps (p, mask, laneOffsets16<Stride> (), v.v, 4);
+}
+
+template <int Stride = 16>
+IMATH_TARGET_AVX512 inline void
+scatter (double* p, __mmask8 mask, DoubleLanes8 v)
+{
+    _mm512_mask_i32scatter_pd (p, mask, laneOffsets8<Stride> (), v.v, 8);
+}
+
+//
+// gather (p, offsets, mask, fill) loads p[offsets[i]] into lane i for
+// the lanes in mask, and fill into the others. The offsets are 64-bit;
+// those of the float lanes take two registers.
+//
+
+struct Offsets16
+{
+    __m512i lo;
+    __m512i hi;
+};
+
+IMATH_TARGET_AVX512 inline FloatLanes16
+gather (const float* p, Offsets16 offsets, __mmask16 mask, float fill)
+{
+    const __m256 f  = _mm256_set1_ps (fill);
+    const __m256 lo = _mm512_mask_i64gather_ps (
+        f, __mmask8 (mask), offsets.lo, p, 4);
+    const __m256 hi = _mm512_mask_i64gather_ps (
+        f, __mmask8 (mask >> 8), offsets.hi, p, 4);
+
+    return {_mm512_castpd_ps (_mm512_insertf64x4 (
+        _mm512_castps_pd (_mm512_castps256_ps512 (lo)),
+        _mm256_castps_pd (hi),
+        1))};
+}
+
+IMATH_TARGET_AVX512 inline DoubleLanes8
+gather (const double* p, __m512i offsets, __mmask8 mask, double fill)
+{
+    return {_mm512_mask_i64gather_pd (
+        _mm512_set1_pd (fill), mask, offsets, p, 8)};
+}
+
+//
+// The lanes of r that are finite, and the lanes of a in mask with
+// the others replaced by b
+//
+
+IMATH_TARGET_AVX512 inline __mmask16
+finite (FloatLanes16 r)
+{
+    return _mm512_cmp_ps_mask (
+        _mm512_abs_ps (r.v),
+        _mm512_set1_ps (std::numeric_limits<float>::max ()),
+        _CMP_LE_OQ);
+}
+
+IMATH_TARGET_AVX512 inline __mmask8
+finite (DoubleLanes8 r)
+{
+    return _mm512_cmp_pd_mask (
+        _mm512_abs_pd (r.v),
+        _mm512_set1_pd (std::numeric_limits<double>::max ()),
+        _CMP_LE_OQ);
+}
+
+IMATH_TARGET_AVX512 inline FloatLanes16
+select (__mmask16 mask, FloatLanes16 a, FloatLanes16 b)
+{
+    return {_mm512_mask_blend_ps (mask, b.v, a.v)};
+}
+
+IMATH_TARGET_AVX512 inline DoubleLanes8
+select (__mmask8 mask, DoubleLanes8 a, DoubleLanes8 b)
+{
+    return {_mm512_mask_blend_pd (mask, b.v, a.v)};
+}
+
+IMATH_TARGET_AVX512 inline FloatLanes16
+sqrt (FloatLanes16 a)
+{
+    return {_mm512_sqrt_ps (a.v)};
+}
+
+IMATH_TARGET_AVX512 inline DoubleLanes8
+sqrt (DoubleLanes8 a)
+{
+    return {_mm512_sqrt_pd (a.v)};
+}
+
+IMATH_TARGET_AVX512 inline FloatLanes16
+abs (FloatLanes16 a)
+{
+    return {_mm512_abs_ps (a.v)};
+}
+
+IMATH_TARGET_AVX512 inline DoubleLanes8
+abs (DoubleLanes8 a)
+{
+    return {_mm512_abs_pd (a.v)};
+}
+
+//
+// Rounding to the nearest integer, with ties to even
+//
+
+IMATH_TARGET_AVX512 inline FloatLanes16
+roundNearest (FloatLanes16 a)
+{
+    return {_mm512_roundscale_ps (
+        a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)};
+}
+
+IMATH_TARGET_AVX512 inline DoubleLanes8
+roundNearest (DoubleLanes8 a)
+{
+    return {_mm512_roundscale_pd (
+        a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)};
+}
+
+//
+// Comparisons, returning the mask of the lanes where they hold. As
+// in scalar code, a comparison with a NAN is false, except for
+// notEqual().
+//
+
+IMATH_TARGET_AVX512 inline __mmask16
+less (FloatLanes16 a, FloatLanes16 b)
+{
+    return _mm512_cmp_ps_mask (a.v, b.v, _CMP_LT_OQ);
+}
+
+IMATH_TARGET_AVX512 inline __mmask8
+less (DoubleLanes8 a, DoubleLanes8 b)
+{
+    return _mm512_cmp_pd_mask (a.v, b.v, _CMP_LT_OQ);
+}
+
+IMATH_TARGET_AVX512 inline __mmask16
+greaterEqual (FloatLanes16 a, FloatLanes16 b)
+{
+    return _mm512_cmp_ps_mask (a.v, b.v, _CMP_GE_OQ);
+}
+
+IMATH_TARGET_AVX512 inline __mmask8
+greaterEqual (DoubleLanes8 a, DoubleLanes8 b)
+{
+    return _mm512_cmp_pd_mask (a.v, b.v, _CMP_GE_OQ);
+}
+
+IMATH_TARGET_AVX512 inline __mmask16
+equal (FloatLanes16 a, FloatLanes16 b)
+{
+    return _mm512_cmp_ps_mask (a.v, b.v, _CMP_EQ_OQ);
+}
+
+IMATH_TARGET_AVX512 inline __mmask8
+equal (DoubleLanes8 a, DoubleLanes8 b)
+{
+    return _mm512_cmp_pd_mask (a.v, b.v, _CMP_EQ_OQ);
+}
+
+IMATH_TARGET_AVX512 inline __mmask16
+notEqual (FloatLanes16 a, FloatLanes16 b)
+{
+    return _mm512_cmp_ps_mask (a.v, b.v, _CMP_NEQ_UQ);
+}
+
+IMATH_TARGET_AVX512 inline __mmask8
+notEqual (DoubleLanes8 a, DoubleLanes8 b)
+{
+    return _mm512_cmp_pd_mask (a.v, b.v, _CMP_NEQ_UQ);
+}
+
+//
+// Store all lanes, or the lanes in mask, to consecutive values
+//
+
+IMATH_TARGET_AVX512 inline void
+store (float* p, FloatLanes16 v)
+{
+    _mm512_storeu_ps (p, v.v);
+}
+
+IMATH_TARGET_AVX512 inline void
+store (double* p, DoubleLanes8 v)
+{
+    _mm512_storeu_pd (p, v.v);
+}
+
+IMATH_TARGET_AVX512 inline void
+store (float* p, __mmask16 mask, FloatLanes16 v)
+{
+    _mm512_mask_storeu_ps (p, mask, v.v);
+}
+
+IMATH_TARGET_AVX512 inline void
+store (double* p, __mmask8 mask, DoubleLanes8 v)
+{
+    _mm512_mask_storeu_pd (p, mask, v.v);
+}
+
+//
+// AVX2: arithmetic, splat<W>(), and gather(), scatter() and store() as
+// for AVX-512. AVX2 has no scatter instruction, so scatter() stores
+// the lanes one at a time.
+//
+
+IMATH_TARGET_AVX2 inline FloatLanes8
+operator+ (FloatLanes8 a, FloatLanes8 b)
+{
+    return {_mm256_add_ps (a.v, b.v)};
+}
+
+IMATH_TARGET_AVX2 inline FloatLanes8
+operator- (FloatLanes8 a, FloatLanes8 b)
+{
+    return {_mm256_sub_ps (a.v, b.v)};
+}
+
+IMATH_TARGET_AVX2 inline FloatLanes8
+operator* (FloatLanes8 a, FloatLanes8 b)
+{
+    return {_mm256_mul_ps (a.v, b.v)};
+}
+
+IMATH_TARGET_AVX2 inline DoubleLanes4
+operator+ (DoubleLanes4 a, DoubleLanes4 b)
+{
+    return {_mm256_add_pd (a.v, b.v)};
+}
+
+IMATH_TARGET_AVX2 inline DoubleLanes4
+operator- (DoubleLanes4 a, DoubleLanes4 b)
+{
+    return {_mm256_sub_pd (a.v, b.v)};
+}
+
+IMATH_TARGET_AVX2 inline DoubleLanes4
+operator* (DoubleLanes4 a, DoubleLanes4 b)
+{
+    return {_mm256_mul_pd (a.v, b.v)};
+}
+
+template <>
+IMATH_TARGET_AVX2 inline FloatLanes8
+splat<FloatLanes8> (float a)
+{
+    return {_mm256_set1_ps (a)};
+}
+
+template <>
+IMATH_TARGET_AVX2 inline DoubleLanes4
+splat<DoubleLanes4> (double a)
+{
+    return {_mm256_set1_pd (a)};
+}
+
+template <int Stride = 16>
+IMATH_TARGET_AVX2 inline FloatLanes8
+gather (const float* p, unsigned mask, float fill)
+{
+    const __m256i lane = _mm256_set_epi32 (7, 6, 5, 4, 3, 2, 1, 0);
+    const __m256i bits = _mm256_sllv_epi32 (_mm256_set1_epi32 (1), lane);
+    const __m256i on   = _mm256_cmpeq_epi32 (
+        _mm256_and_si256 (_mm256_set1_epi32 (int (mask)), bits), bits);
+
+    return {_mm256_mask_i32gather_ps (
+        _mm256_set1_ps (fill),
+        p,
+        _mm256_mullo_epi32 (lane, _mm256_set1_epi32 (Stride)),
+        _mm256_castsi256_ps (on),
+        4)};
+}
+
+template <int Stride = 16>
+IMATH_TARGET_AVX2 inline DoubleLanes4
+gather (const double* p, unsigned mask, double fill)
+{
+    const __m256i lane = _mm256_set_epi64x (3, 2, 1, 0);
+    const __m256i bits = _mm256_sllv_epi64 (_mm256_set1_epi64x (1), lane);
+    const __m256i on   = _mm256_cmpeq_epi64 (
+        _mm256_and_si256 (_mm256_set1_epi64x (mask), bits), bits);
+
+    return {_mm256_mask_i32gather_pd (
+        _mm256_set1_pd (fill),
+        p,
+        _mm_mullo_epi32 (_mm_set_epi32 (3, 2, 1, 0), _mm_set1_epi32 (Stride)),
+        _mm256_castsi256_pd (on),
+        8)};
+}
+
+IMATH_TARGET_AVX2 inline void
+store (float* p, FloatLanes8 v)
+{
+    _mm256_storeu_ps (p, v.v);
+}
+
+IMATH_TARGET_AVX2 inline void
+store (double* p, DoubleLanes4 v)
+{
+    _mm256_storeu_pd (p, v.v);
+}
+
+template <int Stride = 16>
+IMATH_TARGET_AVX2 inline void
+scatter (float* p, unsigned mask, FloatLanes8 v)
+{
+    float buf[8];
+    store (buf, v);
+
+    for (int i = 0; i < 8; ++i)
+        if ((mask >> i) & 1) p[Stride * i] = buf[i];
+}
+
+template <int Stride = 16>
+IMATH_TARGET_AVX2 inline void
+scatter (double* p, unsigned mask, DoubleLanes4 v)
+{
+    double buf[4];
+    store (buf, v);
+
+    for (int i = 0; i < 4; ++i)
+        if ((mask >> i) & 1) p[Stride * i] = buf[i];
+}
+
+} // namespace
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+IMATH_AVX512_KERNELS_END
+
+#endif // IMATH_X86_RUNTIME_DISPATCH
+
+#endif // INCLUDED_IMATHSIMD_H
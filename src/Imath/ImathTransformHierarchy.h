@@ -0,0 +1,512 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+//
+// A hierarchy of 4x4 transformations, stored in flat arrays
+//
+
+#ifndef INCLUDED_IMATHTRANSFORMHIERARCHY_H
+#define INCLUDED_IMATHTRANSFORMHIERARCHY_H
+
+#include "ImathExport.h"
+#include "ImathNamespace.h"
+
+#include "ImathMatrix.h"
+
+#include <functional>
+#include <stdexcept>
+#include <stdint.h>
+#include <vector>
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+///
+/// The `TransformHierarchy` class template holds a tree of nodes,
+/// each with a local transformation relative to its parent, and
+/// computes their world transformations:
+///
+///     world (i) = local (i) * world (parent (i))
+///
+/// As with Matrix44, vectors are row vectors, so a point is
+/// transformed by a node's local matrix first, and then by those of
+/// its ancestors.
+///
+/// Nodes are numbered in the order they are added, and a node's
+/// parent must be added before it. The matrices are kept in flat
+/// arrays in that order, so evaluating the hierarchy is a single pass
+/// over contiguous memory.
+///
+/// setLocal() marks a node as changed. update() then recomputes the
+/// world matrices of the changed nodes and their descendants, and no
+/// others. The inverse and the inverse transpose of a world matrix
+/// are computed when first asked for after it changed, and kept until
+/// it changes again.
+///
+/// update() and updateInverses() can spread their work over several
+/// threads through an executor, as halfFunction does. An executor is
+/// any callable of the form
+///
+///     void executor (int begin, int end,
+///                    const std::function<void (int, int)>& body);
+///
+/// that calls body(b, e) for disjoint ranges [b, e) which together
+/// cover [begin, end), possibly concurrently, and returns when all of
+/// them are done. The nodes at each depth of the tree are independent
+/// of one another, so they are handed to the executor one depth at a
+/// time.
+///
+/// A TransformHierarchy is not otherwise safe to use from several
+/// threads at once: in particular inverse() and inverseTranspose()
+/// update the cache. After updateInverses(), they only read it.
+///
+
+template <class T> class IMATH_EXPORT_TEMPLATE_TYPE TransformHierarchy
+{
+public:
+    /// The parent of a root node
+    static constexpr int noParent = -1;
+
+    /// @{
+    /// @name Constructors and Building
+
+    /// An empty hierarchy
+    TransformHierarchy ();
+
+    /// Reserve space for `n` nodes
+    void reserve (int n);
+
+    /// Add a node with the given parent and local transformation,
+    /// and return its index. `parent` must be `noParent` or the index
+    /// of an existing node.
+    /// @throw std::invalid_argument if `parent` is not valid
+    int addNode (int parent, const Matrix44<T>& local = Matrix44<T> ());
+
+    /// Remove all nodes
+    void clear ();
+
+    /// @}
+
+    /// @{
+    /// @name Structure
+
+    /// The number of nodes
+    int size () const IMATH_NOEXCEPT;
+
+    /// The parent of node `i`, or `noParent`
+    int parent (int i) const IMATH_NOEXCEPT;
+
+    /// The depth of node `i`: 0 for a root, one more than its parent's
+    /// depth otherwise
+    int depth (int i) const IMATH_NOEXCEPT;
+
+    /// @}
+
+    /// @{
+    /// @name Local Transformations
+
+    /// The local transformation of node `i`
+    const Matrix44<T>& local (int i) const IMATH_NOEXCEPT;
+
+    /// Set the local transformation of node `i`, and mark it as
+    /// changed
+    void setLocal (int i, const Matrix44<T>& m) IMATH_NOEXCEPT;
+
+    /// Return true if any local transformation changed since the last
+    /// update()
+    bool changed () const IMATH_NOEXCEPT;
+
+    /// @}
+
+    /// @{
+    /// @name Evaluation
+
+    /// Recompute the world transformations of the nodes whose local
+    /// transformations changed since the last update, and of their
+    /// descendants. Return the number of nodes recomputed.
+    int update ();
+
+    /// Recompute the world transformations as update() does, handing
+    /// the nodes at each depth to `executor`.
+    template <class Executor> int update (Executor executor);
+
+    /// Compute the inverses and inverse transposes of all world
+    /// transformations that are not cached.
+    void updateInverses ();
+
+    /// Compute the inverses and inverse transposes as
+    /// updateInverses() does, handing the nodes to `executor`.
+    template <class Executor> void updateInverses (Executor executor);
+
+    /// @}
+
+    /// @{
+    /// @name World Transformations
+    ///
+    /// These reflect the local transformations as of the last
+    /// update().
+
+    /// The world transformation of node `i`
+    const Matrix44<T>& world (int i) const IMATH_NOEXCEPT;
+
+    /// The inverse of the world transformation of node `i`, or the
+    /// identity if that cannot be inverted, as by Matrix44::inverse()
+    const Matrix44<T>& inverse (int i) IMATH_NOEXCEPT;
+
+    /// The transpose of inverse(i), which transforms normals
+    const Matrix44<T>& inverseTranspose (int i) IMATH_NOEXCEPT;
+
+    /// @}
+
+    /// The base type
+    typedef T BaseType;
+
+private:
+    enum
+    {
+        LOCAL_CHANGED           = 1,
+        INVERSE_VALID           = 2,
+        INVERSE_TRANSPOSE_VALID = 4
+    };
+
+    struct Node
+    {
+        int      parent;
+        int      depth;
+        uint32_t pass; // the update() that last changed the world matrix
+        uint8_t  flags;
+    };
+
+    struct SerialExecutor
+    {
+        void operator() (
+            int begin, int end, const std::function<void (int, int)>& body)
+            const
+        {
+            body (begin, end);
+        }
+    };
+
+    bool evaluate (int i) IMATH_NOEXCEPT;
+    void evaluateInverse (int i) IMATH_NOEXCEPT;
+    void sortByDepth ();
+
+    std::vector<Node>        _nodes;
+    std::vector<Matrix44<T>> _local;
+    std::vector<Matrix44<T>> _world;
+    std::vector<Matrix44<T>> _inverse;
+    std::vector<Matrix44<T>> _inverseTranspose;
+
+    //
+    // The nodes sorted by depth; the nodes at depth d are
+    // _byDepth[_depthBegin[d]] to _byDepth[_depthBegin[d + 1] - 1].
+    // The order is rebuilt when nodes are added.
+    //
+
+    std::vector<int> _byDepth;
+    std::vector<int> _depthBegin;
+    bool             _sorted;
+
+    uint32_t _pass;
+    bool     _changed;
+};
+
+/// Hierarchy of float transformations
+typedef TransformHierarchy<float> TransformHierarchyf;
+
+/// Hierarchy of double transformations
+typedef TransformHierarchy<double> TransformHierarchyd;
+
+//---------------
+// Implementation
+//---------------
+
+template <class T>
+inline TransformHierarchy<T>::TransformHierarchy ()
+    : _sorted (true), _pass (0), _changed (false)
+{}
+
+template <class T>
+inline void
+TransformHierarchy<T>::reserve (int n)
+{
+    _nodes.reserve (n);
+    _local.reserve (n);
+    _world.reserve (n);
+    _inverse.reserve (n);
+    _inverseTranspose.reserve (n);
+}
+
+template <class T>
+inline int
+TransformHierarchy<T>::addNode (int parent, const Matrix44<T>& local)
+{
+    if (parent < noParent || parent >= size ())
+        throw std::invalid_argument (
+            "The parent of a transform hierarchy node "
+            "must be added before it.");
+
+    //
+    // The world matrix is computed by the next update(); until then
+    // it is the identity.
+    //
+
+    Node n;
+    n.parent = parent;
+    n.depth  = parent == noParent ? 0 : _nodes[parent].depth + 1;
+    n.pass   = 0;
+    n.flags  = LOCAL_CHANGED;
+
+    _nodes.push_back (n);
+    _local.push_back (local);
+    _world.push_back (Matrix44<T> ());
+    _inverse.push_back (Matrix44<T> ());
+    _inverseTranspose.push_back (Matrix44<T> ());
+
+    _sorted  = false;
+    _changed = true;
+
+    return size () - 1;
+}
+
+template <class T>
+inline void
+TransformHierarchy<T>::clear ()
+{
+    _nodes.clear ();
+    _local.clear ();
+    _world.clear ();
+    _inverse.clear ();
+    _inverseTranspose.clear ();
+    _byDepth.clear ();
+    _depthBegin.clear ();
+    _sorted  = true;
+    _changed = false;
+}
+
+template <class T>
+inline int
+TransformHierarchy<T>::size () const IMATH_NOEXCEPT
+{
+    return int (_nodes.size ());
+}
+
+template <class T>
+inline int
+TransformHierarchy<T>::parent (int i) const IMATH_NOEXCEPT
+{
+    return _nodes[i].parent;
+}
+
+template <class T>
+inline int
+TransformHierarchy<T>::depth (int i) const IMATH_NOEXCEPT
+{
+    return _nodes[i].depth;
+}
+
+template <class T>
+inline const Matrix44<T>&
+TransformHierarchy<T>::local (int i) const IMATH_NOEXCEPT
+{
+    return _local[i];
+}
+
+template <class T>
+inline void
+TransformHierarchy<T>::setLocal (int i, const Matrix44<T>& m) IMATH_NOEXCEPT
+{
+    _local[i] = m;
+    _nodes[i].flags |= LOCAL_CHANGED;
+    _changed = true;
+}
+
+template <class T>
+inline bool
+TransformHierarchy<T>::changed () const IMATH_NOEXCEPT
+{
+    return _changed;
+}
+
+template <class T>
+inline const Matrix44<T>&
+TransformHierarchy<T>::world (int i) const IMATH_NOEXCEPT
+{
+    return _world[i];
+}
+
+template <class T>
+inline const Matrix44<T>&
+TransformHierarchy<T>::inverse (int i) IMATH_NOEXCEPT
+{
+    if (!(_nodes[i].flags & INVERSE_VALID)) evaluateInverse (i);
+
+    return _inverse[i];
+}
+
+template <class T>
+inline const Matrix44<T>&
+TransformHierarchy<T>::inverseTranspose (int i) IMATH_NOEXCEPT
+{
+    Node& n = _nodes[i];
+
+    if (!(n.flags & INVERSE_TRANSPOSE_VALID))
+    {
+        if (!(n.flags & INVERSE_VALID)) evaluateInverse (i);
+
+        _inverseTranspose[i] = _inverse[i].transposed ();
+        n.flags |= INVERSE_TRANSPOSE_VALID;
+    }
+
+    return _inverseTranspose[i];
+}
+
+//
+// Recompute the world matrix of node i if its local matrix changed,
+// or if its parent's world matrix changed in the current pass. The
+// parent is evaluated before the node, either earlier in index order
+// or at a smaller depth, so the change propagates down the tree in a
+// single pass. Each call writes only node i.
+//
+
+template <class T>
+inline bool
+TransformHierarchy<T>::evaluate (int i) IMATH_NOEXCEPT
+{
+    Node& n = _nodes[i];
+
+    if (n.parent == noParent)
+    {
+        if (!(n.flags & LOCAL_CHANGED)) return false;
+
+        _world[i] = _local[i];
+    }
+    else
+    {
+        if (!(n.flags & LOCAL_CHANGED) && _nodes[n.parent].pass != _pass)
+            return false;
+
+        _world[i] = _local[i] * _world[n.parent];
+    }
+
+    n.pass  = _pass;
+    n.flags = 0;
+    return true;
+}
+
+template <class T>
+inline void
+TransformHierarchy<T>::evaluateInverse (int i) IMATH_NOEXCEPT
+{
+    _inverse[i] = _world[i].inverse ();
+    _nodes[i].flags |= INVERSE_VALID;
+}
+
+template <class T>
+inline int
+TransformHierarchy<T>::update ()
+{
+    if (!_changed) return 0;
+
+    //
+    // Pass numbers start at 1, so that new nodes, whose pass is 0,
+    // never look as if their parent changed. Should the counter wrap
+    // around, nodes last changed 2^32 passes ago are harmlessly
+    // recomputed.
+    //
+
+    if (++_pass == 0) ++_pass;
+
+    int count = 0;
+
+    for (int i = 0, n = size (); i < n; ++i)
+        if (evaluate (i)) ++count;
+
+    _changed = false;
+    return count;
+}
+
+template <class T>
+inline void
+TransformHierarchy<T>::sortByDepth ()
+{
+    int depths = 0;
+
+    for (const Node& n: _nodes)
+        if (n.depth >= depths) depths = n.depth + 1;
+
+    //
+    // A counting sort, which keeps the nodes at each depth in index
+    // order
+    //
+
+    _depthBegin.assign (depths + 1, 0);
+
+    for (const Node& n: _nodes)
+        ++_depthBegin[n.depth + 1];
+
+    for (int d = 0; d < depths; ++d)
+        _depthBegin[d + 1] += _depthBegin[d];
+
+    std::vector<int> next (_depthBegin.begin (), _depthBegin.end () - 1);
+    _byDepth.resize (_nodes.size ());
+
+    for (int i = 0, n = size (); i < n; ++i)
+        _byDepth[next[_nodes[i].depth]++] = i;
+
+    _sorted = true;
+}
+
+template <class T>
+template <class Executor>
+inline int
+TransformHierarchy<T>::update (Executor executor)
+{
+    if (!_changed) return 0;
+
+    if (!_sorted) sortByDepth ();
+
+    if (++_pass == 0) ++_pass;
+
+    std::vector<int> counts (_byDepth.size ());
+
+    for (size_t d = 0; d + 1 < _depthBegin.size (); ++d)
+    {
+        executor (
+            _depthBegin[d], _depthBegin[d + 1], [&] (int begin, int end) {
+                for (int k = begin; k < end; ++k)
+                    counts[k] = evaluate (_byDepth[k]);
+            });
+    }
+
+    int count = 0;
+
+    for (int c: counts)
+        count += c;
+
+    _changed = false;
+    return count;
+}
+
+template <class T>
+inline void
+TransformHierarchy<T>::updateInverses ()
+{
+    updateInverses (SerialExecutor ());
+}
+
+template <class T>
+template <class Executor>
+inline void
+TransformHierarchy<T>::updateInverses (Executor executor)
+{
+    executor (0, size (), [this] (int begin, int end) {
+        for (int i = begin; i < end; ++i)
+            inverseTranspose (i);
+    });
+}
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif // INCLUDED_IMATHTRANSFORMHIERARCHY_H
@@ -39,6 +39,12 @@ IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
 /// Specialization so that Vec<half> supports length/normalize.
 template <> struct is_float_like<half> : public std::true_type {};
 
+class bfloat16;
+
+/// Specialization so that Vec<bfloat16> supports length/normalize.
+/// The bfloat16 vectors need bfloat16.h, which is not included here.
+template <> struct is_float_like<bfloat16> : public std::true_type {};
+
 template <class T> class Vec2;
 template <class T> class Vec3;
 template <class T> class Vec4;
@@ -1055,6 +1061,9 @@ operator* (T a, const Vec4<T>& v) IMATH_NOEXCEPT;
 /// Vec2 of half
 typedef Vec2<half> V2h;
 
+/// Vec2 of bfloat16 (include bfloat16.h to use it)
+typedef Vec2<bfloat16> V2bf;
+
 /// Vec2 of short
 typedef Vec2<short> V2s;
 
@@ -1073,6 +1082,9 @@ typedef Vec2<double> V2d;
 /// Vec3 of half
 typedef Vec3<half> V3h;
 
+/// Vec3 of bfloat16 (include bfloat16.h to use it)
+typedef Vec3<bfloat16> V3bf;
+
 /// Vec3 of short
 typedef Vec3<short> V3s;
 
@@ -1091,6 +1103,9 @@ typedef Vec3<double> V3d;
 /// Vec4 of half
 typedef Vec4<half> V4h;
 
+/// Vec4 of bfloat16 (include bfloat16.h to use it)
+typedef Vec4<bfloat16> V4bf;
+
 /// Vec4 of short
 typedef Vec4<short> V4s;
 
@@ -0,0 +1,176 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+//---------------------------------------------------------------------------
+//
+//	class bfloat16 --
+//	implementation of non-inline members and bulk conversion
+//
+//---------------------------------------------------------------------------
+
+#include "bfloat16.h"
+
+//
+// The SSE2 kernels need nothing beyond the x86-64 baseline, so unlike
+// the half kernels they are used directly, without run-time dispatch.
+//
+
+#if !defined(__CUDA_ARCH__) &&                                                 \
+    (defined(__SSE2__) || defined(_M_X64) ||                                   \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#    define IMATH_BFLOAT16_SSE2
+#    include <emmintrin.h>
+#endif
+
+using namespace std;
+
+namespace
+{
+
+//
+// Convert this many values at a time between half and bfloat16, via a
+// float buffer small enough to stay in the L1 cache.
+//
+
+const size_t blockSize = 256;
+
+} // namespace
+
+extern "C" {
+
+IMATH_EXPORT void
+imath_bfloat16_to_float_array (
+    const imath_bfloat16_bits_t* src, float* dst, size_t n)
+{
+    size_t i = 0;
+
+#ifdef IMATH_BFLOAT16_SSE2
+    const __m128i zero = _mm_setzero_si128 ();
+
+    for (; i + 8 <= n; i += 8)
+    {
+        __m128i b = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (src + i));
+
+        // interleaving zeros below each value shifts it into the
+        // upper 16 bits of a 32-bit lane
+        _mm_storeu_si128 (
+            reinterpret_cast<__m128i*> (dst + i), _mm_unpacklo_epi16 (zero, b));
+        _mm_storeu_si128 (
+            reinterpret_cast<__m128i*> (dst + i + 4),
+            _mm_unpackhi_epi16 (zero, b));
+    }
+#endif
+
+    for (; i < n; ++i)
+        dst[i] = imath_bfloat16_to_float (src[i]);
+}
+
+#ifdef IMATH_BFLOAT16_SSE2
+
+//
+// imath_float_to_bfloat16() on four values, leaving the result
+// sign-extended in each 32-bit lane so that a signed pack keeps the
+// bits intact.
+//
+
+static inline __m128i
+floatToBfloat16SSE2 (__m128i u)
+{
+    const __m128i one   = _mm_set1_epi32 (1);
+    const __m128i bias  = _mm_set1_epi32 (0x7fff);
+    const __m128i abs   = _mm_set1_epi32 (0x7fffffff);
+    const __m128i inf   = _mm_set1_epi32 (0x7f800000);
+    const __m128i quiet = _mm_set1_epi32 (0x00400000);
+
+    __m128i nan = _mm_cmpgt_epi32 (_mm_and_si128 (u, abs), inf);
+
+    __m128i r = _mm_add_epi32 (
+        u,
+        _mm_add_epi32 (bias, _mm_and_si128 (_mm_srli_epi32 (u, 16), one)));
+
+    r = _mm_or_si128 (
+        _mm_andnot_si128 (nan, r), _mm_and_si128 (nan, _mm_or_si128 (u, quiet)));
+
+    return _mm_srai_epi32 (r, 16);
+}
+
+#endif
+
+IMATH_EXPORT void
+imath_float_to_bfloat16_array (
+    const float* src, imath_bfloat16_bits_t* dst, size_t n)
+{
+    size_t i = 0;
+
+#ifdef IMATH_BFLOAT16_SSE2
+    for (; i + 8 <= n; i += 8)
+    {
+        __m128i lo = floatToBfloat16SSE2 (
+            _mm_loadu_si128 (reinterpret_cast<const __m128i*> (src + i)));
+        __m128i hi = floatToBfloat16SSE2 (
+            _mm_loadu_si128 (reinterpret_cast<const __m128i*> (src + i + 4)));
+
+        _mm_storeu_si128 (
+            reinterpret_cast<__m128i*> (dst + i), _mm_packs_epi32 (lo, hi));
+    }
+#endif
+
+    for (; i < n; ++i)
+        dst[i] = imath_float_to_bfloat16 (src[i]);
+}
+
+IMATH_EXPORT void
+imath_half_to_bfloat16_array (
+    const imath_half_bits_t* src, imath_bfloat16_bits_t* dst, size_t n)
+{
+    float buf[blockSize];
+
+    for (size_t i = 0; i < n; i += blockSize)
+    {
+        size_t m = n - i < blockSize ? n - i : blockSize;
+        imath_half_to_float_array (src + i, buf, m);
+        imath_float_to_bfloat16_array (buf, dst + i, m);
+    }
+}
+
+IMATH_EXPORT void
+imath_bfloat16_to_half_array (
+    const imath_bfloat16_bits_t* src, imath_half_bits_t* dst, size_t n)
+{
+    float buf[blockSize];
+
+    for (size_t i = 0; i < n; i += blockSize)
+    {
+        size_t m = n - i < blockSize ? n - i : blockSize;
+        imath_bfloat16_to_float_array (src + i, buf, m);
+        imath_float_to_half_array (buf, dst + i, m);
+    }
+}
+
+} // extern "C"
+
+IMATH_INTERNAL_NAMESPACE_SOURCE_ENTER
+
+//---------------------
+// Stream I/O operators
+//---------------------
+
+IMATH_EXPORT ostream&
+operator<< (ostream& os, bfloat16 b)
+{
+    os << float (b);
+    return os;
+}
+
+IMATH_EXPORT istream&
+operator>> (istream& is, bfloat16& b)
+{
+    float f;
+    is >> f;
+    b = bfloat16 (f);
+    return is;
+}
+
+IMATH_INTERNAL_NAMESPACE_SOURCE_EXIT
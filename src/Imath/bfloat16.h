@@ -0,0 +1,668 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifndef IMATH_BFLOAT16_H_
+#define IMATH_BFLOAT16_H_
+
+#include "ImathExport.h"
+#include "ImathNamespace.h"
+#include "ImathPlatform.h"
+#include "half.h"
+
+/// @file bfloat16.h
+/// The bfloat16 type is a 16-bit floating point number consisting of
+/// the upper 16 bits of an IEEE 754 single-precision float.
+///
+/// **Representation of a 16-bit bfloat16:**
+///
+/// Here is the bit-layout for a bfloat16 number, b:
+///
+///     15 (msb)
+///     |
+///     | 14     7
+///     | |      |
+///     | |      | 6     0 (lsb)
+///     | |      | |     |
+///     X XXXXXXXX XXXXXXX
+///
+///     s e        m
+///
+/// S is the sign-bit, e is the exponent and m is the significand.
+/// The exponent is the same as a float's, so bfloat16 covers the
+/// range of float with only 8 bits of precision, where half covers
+/// a much smaller range with 11.
+///
+/// If e is between 1 and 254, b is a normalized number:
+///
+///             s    e-127
+///     b = (-1)  * 2      * 1.m
+///
+/// If e is 0, and m is not zero, b is a denormalized number:
+///
+///             s    -126
+///     b = (-1)  * 2      * 0.m
+///
+/// If e is 255, b is an "infinity" or "not a number" (NAN),
+/// depending on whether m is zero or not.
+///
+/// Examples:
+///
+///     0 00000000 0000000 = 0.0
+///     0 01111110 0000000 = 0.5
+///     0 01111111 0000000 = 1.0
+///     0 10000000 1000000 = 3.0
+///     1 10000101 1111000 = -124.0
+///     0 11111111 0000000 = +infinity
+///     0 11111111 1000000 = NAN
+///
+/// **Conversion:**
+///
+/// Conversion from bfloat16 to float is exact and needs only a
+/// shift. Conversion from float to bfloat16 rounds to nearest even;
+/// a NAN stays a NAN, and is made quiet.
+///
+/// **Bulk Conversion:**
+///
+/// As with half, the ``imath_bfloat16_to_float_array`` and
+/// ``imath_float_to_bfloat16_array`` functions convert whole arrays,
+/// 8 values at a time with SSE2 on x86. The
+/// ``imath_half_to_bfloat16_array`` and
+/// ``imath_bfloat16_to_half_array`` functions convert directly
+/// between the two 16-bit types, going through float only in small
+/// blocks that stay in cache, so that the data is read and written
+/// once.
+///
+
+#include <float.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Largest positive bfloat16
+#define BFLOAT16_MAX 3.38953139e+38f
+/// Smallest positive normalized bfloat16
+#define BFLOAT16_MIN 1.17549435e-38f
+/// Smallest positive denormalized bfloat16
+#define BFLOAT16_DENORM_MIN 9.18354962e-41f
+/// Smallest positive e for which ``bfloat16(1.0 + e) != bfloat16(1.0)``
+#define BFLOAT16_EPSILON 0.0078125f
+
+/// Number of digits in mantissa (significand + hidden leading 1)
+#define BFLOAT16_MANT_DIG 8
+/// Number of base 10 digits that can be represented without change:
+///
+/// ``floor( (BFLOAT16_MANT_DIG - 1) * log10(2) ) => 2.10... -> 2``
+#define BFLOAT16_DIG 2
+/// Number of base-10 digits that are necessary to uniquely represent
+/// all distinct values:
+///
+/// ``ceil(BFLOAT16_MANT_DIG * log10(2) + 1) => 3.40... -> 4``
+#define BFLOAT16_DECIMAL_DIG 4
+
+/// a type for both C-only programs and C++ to use the same utilities
+typedef uint16_t imath_bfloat16_bits_t;
+
+///
+/// Convert bfloat16 to float
+///
+
+static inline float
+imath_bfloat16_to_float (imath_bfloat16_bits_t b)
+{
+    imath_half_uif_t v;
+    v.i = (uint32_t) b << 16;
+    return v.f;
+}
+
+///
+/// Convert float to bfloat16, rounding to nearest even
+///
+
+static inline imath_bfloat16_bits_t
+imath_float_to_bfloat16 (float f)
+{
+    imath_half_uif_t v;
+    v.f = f;
+
+    // quiet a NAN rather than let rounding turn it into an infinity
+    if (IMATH_UNLIKELY ((v.i & 0x7fffffff) > 0x7f800000))
+        return (imath_bfloat16_bits_t) ((v.i >> 16) | 0x0040);
+
+    v.i += 0x7fff + ((v.i >> 16) & 1);
+    return (imath_bfloat16_bits_t) (v.i >> 16);
+}
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+///
+/// Convert an array of n bfloat16 values to float.
+///
+/// ``src`` and ``dst`` may have any alignment, but must not overlap.
+///
+
+IMATH_EXPORT void imath_bfloat16_to_float_array (
+    const imath_bfloat16_bits_t* src, float* dst, size_t n);
+
+///
+/// Convert an array of n float values to bfloat16, rounding like
+/// ``imath_float_to_bfloat16``.
+///
+/// ``src`` and ``dst`` may have any alignment, but must not overlap.
+///
+
+IMATH_EXPORT void imath_float_to_bfloat16_array (
+    const float* src, imath_bfloat16_bits_t* dst, size_t n);
+
+///
+/// Convert an array of n half values to bfloat16. The result is the
+/// same as converting each value through float.
+///
+
+IMATH_EXPORT void imath_half_to_bfloat16_array (
+    const imath_half_bits_t* src, imath_bfloat16_bits_t* dst, size_t n);
+
+///
+/// Convert an array of n bfloat16 values to half. The result is the
+/// same as converting each value through float.
+///
+
+IMATH_EXPORT void imath_bfloat16_to_half_array (
+    const imath_bfloat16_bits_t* src, imath_half_bits_t* dst, size_t n);
+
+#if defined(__cplusplus)
+} // extern "C"
+#endif
+
+////////////////////////////////////////
+
+#ifdef __cplusplus
+
+#    include <iostream>
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+///
+/// class bfloat16 represents a 16-bit "brain" floating point number
+///
+/// Type bfloat16 can represent positive and negative numbers whose
+/// magnitude is between roughly 1.2e-38 and 3.4e+38 with a relative
+/// error of 3.9e-3. All integers from -256 to +256 can be represented
+/// exactly.
+///
+/// Like half, bfloat16 behaves (almost) like the built-in C++
+/// floating point types: it converts implicitly to and from float,
+/// and arithmetic is carried out in float.
+///
+
+class IMATH_EXPORT_TYPE bfloat16
+{
+public:
+    /// A special tag that lets us initialize a bfloat16 from the raw bits.
+    enum IMATH_EXPORT_ENUM FromBitsTag
+    {
+        FromBits
+    };
+
+    /// @{
+    ///	@name Constructors
+
+    /// Default construction provides no initialization (hence it is
+    /// not constexpr).
+    bfloat16 () IMATH_NOEXCEPT = default;
+
+    /// Construct from float
+    bfloat16 (float f) IMATH_NOEXCEPT;
+
+    /// Construct from bit-vector
+    constexpr bfloat16 (FromBitsTag, uint16_t bits) IMATH_NOEXCEPT;
+
+    /// Copy constructor
+    constexpr bfloat16 (const bfloat16&) IMATH_NOEXCEPT = default;
+
+    /// Move constructor
+    constexpr bfloat16 (bfloat16&&) IMATH_NOEXCEPT = default;
+
+    /// Destructor
+    ~bfloat16 () IMATH_NOEXCEPT = default;
+
+    /// @}
+
+    /// Conversion to float
+    operator float () const IMATH_NOEXCEPT;
+
+    /// @{
+    /// @name Basic Algebra
+
+    /// Unary minus
+    constexpr bfloat16 operator- () const IMATH_NOEXCEPT;
+
+    /// Assignment
+    bfloat16& operator= (const bfloat16& b) IMATH_NOEXCEPT = default;
+
+    /// Move assignment
+    bfloat16& operator= (bfloat16&& b) IMATH_NOEXCEPT = default;
+
+    /// Assignment from float
+    bfloat16& operator= (float f) IMATH_NOEXCEPT;
+
+    /// Addition assignment
+    bfloat16& operator+= (bfloat16 b) IMATH_NOEXCEPT;
+
+    /// Addition assignment from float
+    bfloat16& operator+= (float f) IMATH_NOEXCEPT;
+
+    /// Subtraction assignment
+    bfloat16& operator-= (bfloat16 b) IMATH_NOEXCEPT;
+
+    /// Subtraction assignment from float
+    bfloat16& operator-= (float f) IMATH_NOEXCEPT;
+
+    /// Multiplication assignment
+    bfloat16& operator*= (bfloat16 b) IMATH_NOEXCEPT;
+
+    /// Multiplication assignment from float
+    bfloat16& operator*= (float f) IMATH_NOEXCEPT;
+
+    /// Division assignment
+    bfloat16& operator/= (bfloat16 b) IMATH_NOEXCEPT;
+
+    /// Division assignment from float
+    bfloat16& operator/= (float f) IMATH_NOEXCEPT;
+
+    /// @}
+
+    /// Round to n-bit precision (n should be between 0 and 7).
+    /// After rounding, the significand's 7-n least significant
+    /// bits will be zero.
+    IMATH_CONSTEXPR14 bfloat16 round (unsigned int n) const IMATH_NOEXCEPT;
+
+    /// @{
+    /// @name Classification
+
+    /// Return true if a normalized number, a denormalized number, or
+    /// zero.
+    constexpr bool isFinite () const IMATH_NOEXCEPT;
+
+    /// Return true if a normalized number.
+    constexpr bool isNormalized () const IMATH_NOEXCEPT;
+
+    /// Return true if a denormalized number.
+    constexpr bool isDenormalized () const IMATH_NOEXCEPT;
+
+    /// Return true if zero.
+    constexpr bool isZero () const IMATH_NOEXCEPT;
+
+    /// Return true if NAN.
+    constexpr bool isNan () const IMATH_NOEXCEPT;
+
+    /// Return true if a positive or a negative infinity
+    constexpr bool isInfinity () const IMATH_NOEXCEPT;
+
+    /// Return true if the sign bit is set (negative)
+    constexpr bool isNegative () const IMATH_NOEXCEPT;
+
+    /// @}
+
+    /// @{
+    /// @name Special values
+
+    /// Return +infinity
+    static constexpr bfloat16 posInf () IMATH_NOEXCEPT;
+
+    /// Return -infinity
+    static constexpr bfloat16 negInf () IMATH_NOEXCEPT;
+
+    /// Returns a NAN with the bit pattern 0111111111000000
+    static constexpr bfloat16 qNan () IMATH_NOEXCEPT;
+
+    /// Return a NAN with the bit pattern 0111111110100000
+    static constexpr bfloat16 sNan () IMATH_NOEXCEPT;
+
+    /// @}
+
+    /// @{
+    /// @name Access to the internal representation
+
+    /// Return the bit pattern
+    constexpr uint16_t bits () const IMATH_NOEXCEPT;
+
+    /// Set the bit pattern
+    IMATH_CONSTEXPR14 void setBits (uint16_t bits) IMATH_NOEXCEPT;
+
+    /// @}
+
+private:
+    constexpr uint16_t mantissa () const IMATH_NOEXCEPT;
+    constexpr uint16_t exponent () const IMATH_NOEXCEPT;
+
+    uint16_t _b;
+};
+
+//--------------------------------
+// bfloat16-from-float constructor
+//--------------------------------
+
+inline bfloat16::bfloat16 (float f) IMATH_NOEXCEPT
+    : _b (imath_float_to_bfloat16 (f))
+{}
+
+//------------------------------------------
+// bfloat16 from raw bits constructor
+//------------------------------------------
+
+inline constexpr bfloat16::bfloat16 (FromBitsTag, uint16_t bits) IMATH_NOEXCEPT
+    : _b (bits)
+{}
+
+//-----------------------------
+// bfloat16-to-float conversion
+//-----------------------------
+
+inline bfloat16::operator float () const IMATH_NOEXCEPT
+{
+    return imath_bfloat16_to_float (_b);
+}
+
+//-------------------------
+// Round to n-bit precision
+//-------------------------
+
+inline IMATH_CONSTEXPR14 bfloat16
+bfloat16::round (unsigned int n) const IMATH_NOEXCEPT
+{
+    if (n >= 7) return *this;
+
+    //
+    // As in half::round(): round the combined exponent and
+    // significand, and truncate instead if that overflows.
+    //
+
+    uint16_t s = _b & 0x8000;
+    uint16_t e = _b & 0x7fff;
+
+    e >>= 6 - n;
+    e += e & 1;
+    e <<= 6 - n;
+
+    if (e >= 0x7f80)
+    {
+        e = _b;
+        e >>= 7 - n;
+        e <<= 7 - n;
+    }
+
+    return bfloat16 (FromBits, s | e);
+}
+
+//-----------------------
+// Other inline functions
+//-----------------------
+
+inline constexpr bfloat16
+bfloat16::operator- () const IMATH_NOEXCEPT
+{
+    return bfloat16 (FromBits, bits () ^ 0x8000);
+}
+
+inline bfloat16&
+bfloat16::operator= (float f) IMATH_NOEXCEPT
+{
+    *this = bfloat16 (f);
+    return *this;
+}
+
+inline bfloat16&
+bfloat16::operator+= (bfloat16 b) IMATH_NOEXCEPT
+{
+    *this = bfloat16 (float (*this) + float (b));
+    return *this;
+}
+
+inline bfloat16&
+bfloat16::operator+= (float f) IMATH_NOEXCEPT
+{
+    *this = bfloat16 (float (*this) + f);
+    return *this;
+}
+
+inline bfloat16&
+bfloat16::operator-= (bfloat16 b) IMATH_NOEXCEPT
+{
+    *this = bfloat16 (float (*this) - float (b));
+    return *this;
+}
+
+inline bfloat16&
+bfloat16::operator-= (float f) IMATH_NOEXCEPT
+{
+    *this = bfloat16 (float (*this) - f);
+    return *this;
+}
+
+inline bfloat16&
+bfloat16::operator*= (bfloat16 b) IMATH_NOEXCEPT
+{
+    *this = bfloat16 (float (*this) * float (b));
+    return *this;
+}
+
+inline bfloat16&
+bfloat16::operator*= (float f) IMATH_NOEXCEPT
+{
+    *this = bfloat16 (float (*this) * f);
+    return *this;
+}
+
+inline bfloat16&
+bfloat16::operator/= (bfloat16 b) IMATH_NOEXCEPT
+{
+    *this = bfloat16 (float (*this) / float (b));
+    return *this;
+}
+
+inline bfloat16&
+bfloat16::operator/= (float f) IMATH_NOEXCEPT
+{
+    *this = bfloat16 (float (*this) / f);
+    return *this;
+}
+
+inline constexpr uint16_t
+bfloat16::mantissa () const IMATH_NOEXCEPT
+{
+    return _b & 0x7f;
+}
+
+inline constexpr uint16_t
+bfloat16::exponent () const IMATH_NOEXCEPT
+{
+    return (_b >> 7) & 0xff;
+}
+
+inline constexpr bool
+bfloat16::isFinite () const IMATH_NOEXCEPT
+{
+    return exponent () < 255;
+}
+
+inline constexpr bool
+bfloat16::isNormalized () const IMATH_NOEXCEPT
+{
+    return exponent () > 0 && exponent () < 255;
+}
+
+inline constexpr bool
+bfloat16::isDenormalized () const IMATH_NOEXCEPT
+{
+    return exponent () == 0 && mantissa () != 0;
+}
+
+inline constexpr bool
+bfloat16::isZero () const IMATH_NOEXCEPT
+{
+    return (_b & 0x7fff) == 0;
+}
+
+inline constexpr bool
+bfloat16::isNan () const IMATH_NOEXCEPT
+{
+    return exponent () == 255 && mantissa () != 0;
+}
+
+inline constexpr bool
+bfloat16::isInfinity () const IMATH_NOEXCEPT
+{
+    return exponent () == 255 && mantissa () == 0;
+}
+
+inline constexpr bool
+bfloat16::isNegative () const IMATH_NOEXCEPT
+{
+    return (_b & 0x8000) != 0;
+}
+
+inline constexpr bfloat16
+bfloat16::posInf () IMATH_NOEXCEPT
+{
+    return bfloat16 (FromBits, 0x7f80);
+}
+
+inline constexpr bfloat16
+bfloat16::negInf () IMATH_NOEXCEPT
+{
+    return bfloat16 (FromBits, 0xff80);
+}
+
+inline constexpr bfloat16
+bfloat16::qNan () IMATH_NOEXCEPT
+{
+    return bfloat16 (FromBits, 0x7fc0);
+}
+
+inline constexpr bfloat16
+bfloat16::sNan () IMATH_NOEXCEPT
+{
+    return bfloat16 (FromBits, 0x7fa0);
+}
+
+inline constexpr uint16_t
+bfloat16::bits () const IMATH_NOEXCEPT
+{
+    return _b;
+}
+
+inline IMATH_CONSTEXPR14 void
+bfloat16::setBits (uint16_t bits) IMATH_NOEXCEPT
+{
+    _b = bits;
+}
+
+/// Output b to os, formatted as a float
+IMATH_EXPORT std::ostream& operator<< (std::ostream& os, bfloat16 b);
+
+/// Input b from is
+IMATH_EXPORT std::istream& operator>> (std::istream& is, bfloat16& b);
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#    include <limits>
+
+namespace std
+{
+
+template <> class numeric_limits<IMATH_INTERNAL_NAMESPACE::bfloat16>
+{
+public:
+    static const bool is_specialized = true;
+
+    static constexpr IMATH_INTERNAL_NAMESPACE::bfloat16 min () IMATH_NOEXCEPT
+    {
+        return IMATH_INTERNAL_NAMESPACE::bfloat16 (IMATH_INTERNAL_NAMESPACE::bfloat16::FromBits, 0x0080); /*BFLOAT16_MIN*/
+    }
+    static constexpr IMATH_INTERNAL_NAMESPACE::bfloat16 max () IMATH_NOEXCEPT
+    {
+        return IMATH_INTERNAL_NAMESPACE::bfloat16 (IMATH_INTERNAL_NAMESPACE::bfloat16::FromBits, 0x7f7f); /*BFLOAT16_MAX*/
+    }
+    static constexpr IMATH_INTERNAL_NAMESPACE::bfloat16 lowest ()
+    {
+        return IMATH_INTERNAL_NAMESPACE::bfloat16 (IMATH_INTERNAL_NAMESPACE::bfloat16::FromBits, 0xff7f); /* -BFLOAT16_MAX */
+    }
+
+    static constexpr int  digits       = BFLOAT16_MANT_DIG;
+    static constexpr int  digits10     = BFLOAT16_DIG;
+    static constexpr int  max_digits10 = BFLOAT16_DECIMAL_DIG;
+    static constexpr bool is_signed    = true;
+    static constexpr bool is_integer   = false;
+    static constexpr bool is_exact     = false;
+    static constexpr int  radix        = 2;
+    static constexpr IMATH_INTERNAL_NAMESPACE::bfloat16 epsilon () IMATH_NOEXCEPT
+    {
+        return IMATH_INTERNAL_NAMESPACE::bfloat16 (IMATH_INTERNAL_NAMESPACE::bfloat16::FromBits, 0x3c00); /*BFLOAT16_EPSILON*/
+    }
+    static constexpr IMATH_INTERNAL_NAMESPACE::bfloat16 round_error () IMATH_NOEXCEPT
+    {
+        return IMATH_INTERNAL_NAMESPACE::bfloat16 (IMATH_INTERNAL_NAMESPACE::bfloat16::FromBits, 0x3f00); /*0.5*/
+    }
+
+    // the exponent range is that of float
+    static constexpr int min_exponent   = FLT_MIN_EXP;
+    static constexpr int min_exponent10 = FLT_MIN_10_EXP;
+    static constexpr int max_exponent   = FLT_MAX_EXP;
+    static constexpr int max_exponent10 = FLT_MAX_10_EXP;
+
+    static constexpr bool               has_infinity      = true;
+    static constexpr bool               has_quiet_NaN     = true;
+    static constexpr bool               has_signaling_NaN = true;
+
+    // See the numeric_limits<half> specialization in half.h about
+    // the C++23 deprecation of float_denorm_style.
+#    if (defined(__clang__) || defined(__GNUC__)) && (__cplusplus >= 202302L)
+#        pragma GCC diagnostic push
+#        pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#    elif defined(_MSC_VER) && defined(_MSVC_LANG) && (_MSVC_LANG >= 202302L)
+#        pragma warning(push)
+#        pragma warning(disable : 4996)
+#    endif
+    static constexpr float_denorm_style has_denorm = denorm_present;
+#    if (defined(__clang__) || defined(__GNUC__)) && (__cplusplus >= 202302L)
+#        pragma GCC diagnostic pop
+#    elif defined(_MSC_VER) && defined(_MSVC_LANG) && (_MSVC_LANG >= 202302L)
+#        pragma warning(pop)
+#    endif
+    static constexpr bool               has_denorm_loss   = false;
+    static constexpr IMATH_INTERNAL_NAMESPACE::bfloat16 infinity () IMATH_NOEXCEPT
+    {
+        return IMATH_INTERNAL_NAMESPACE::bfloat16 (IMATH_INTERNAL_NAMESPACE::bfloat16::FromBits, 0x7f80); /*bfloat16::posInf()*/
+    }
+    static constexpr IMATH_INTERNAL_NAMESPACE::bfloat16 quiet_NaN () IMATH_NOEXCEPT
+    {
+        return IMATH_INTERNAL_NAMESPACE::bfloat16 (IMATH_INTERNAL_NAMESPACE::bfloat16::FromBits, 0x7fc0); /*bfloat16::qNan()*/
+    }
+    static constexpr IMATH_INTERNAL_NAMESPACE::bfloat16 signaling_NaN () IMATH_NOEXCEPT
+    {
+        return IMATH_INTERNAL_NAMESPACE::bfloat16 (IMATH_INTERNAL_NAMESPACE::bfloat16::FromBits, 0x7fa0); /*bfloat16::sNan()*/
+    }
+    static constexpr IMATH_INTERNAL_NAMESPACE::bfloat16 denorm_min () IMATH_NOEXCEPT
+    {
+        return IMATH_INTERNAL_NAMESPACE::bfloat16 (IMATH_INTERNAL_NAMESPACE::bfloat16::FromBits, 0x0001); /*BFLOAT16_DENORM_MIN*/
+    }
+
+    static constexpr bool is_iec559  = false;
+    static constexpr bool is_bounded = true;
+    static constexpr bool is_modulo  = false;
+
+    static constexpr bool              traps           = false;
+    static constexpr bool              tinyness_before = false;
+    static constexpr float_round_style round_style     = round_to_nearest;
+};
+
+} // namespace std
+
+using bfloat16 = IMATH_INTERNAL_NAMESPACE::bfloat16;
+
+#endif // __cplusplus
+
+#endif // IMATH_BFLOAT16_H_
@@ -17,7 +17,10 @@
 //---------------------------------------------------------------------------
 
 #include "half.h"
+#include "ImathCpuFeatures.h"
 #include <assert.h>
+#include <math.h>
+#include <string.h>
 
 using namespace std;
 
@@ -34,7 +37,7 @@ using namespace std;
 // clang-format off
 
 #if !defined(IMATH_HALF_NO_LOOKUP_TABLE)
-// Omit the table entirely if IMATH_HALF_NO_LOOKUP_TABLE is
+// Omit the tables entirely if IMATH_HALF_NO_LOOKUP_TABLE is
 // defined. Half-to-float conversion must be accomplished either by
 // F16C instructions or the bit-shift algorithm.
 const imath_half_uif_t imath_half_to_float_table_data[1 << 16] =
@@ -44,10 +47,695 @@ extern "C" {
 EXPORT_CONST const imath_half_uif_t *imath_half_to_float_table = imath_half_to_float_table_data;
 } // extern "C"
 
+const uint32_t imath_half_to_float_compact_table_data[1 << 11] =
+#include "toFloatCompact.h"
+
+extern "C" {
+EXPORT_CONST const uint32_t *imath_half_to_float_compact_table = imath_half_to_float_compact_table_data;
+} // extern "C"
+
 #endif
 
 // clang-format on
 
+//-------------------------------------------------
+// Bulk half-to-float and float-to-half conversion
+//-------------------------------------------------
+
+//
+// On x86 the SIMD kernels are compiled regardless of the compiler
+// flags used for the library, and the fastest one the host CPU
+// supports is chosen at run time. Elsewhere, only the portable loop
+// is available.
+//
+
+namespace
+{
+
+typedef void (*HalfToFloatArrayFn) (const imath_half_bits_t*, float*, size_t);
+typedef void (*FloatToHalfArrayFn) (const float*, imath_half_bits_t*, size_t);
+
+//
+// Portable fallback: a loop over the scalar conversion, which is
+// whichever of the F16C, table or bit-shift methods half.h selected
+// for this compilation.
+//
+
+void
+halfToFloatArrayScalar (
+    const imath_half_bits_t* IMATH_RESTRICT src,
+    float* IMATH_RESTRICT dst,
+    size_t                   n)
+{
+    for (size_t i = 0; i < n; ++i)
+        dst[i] = imath_half_to_float (src[i]);
+}
+
+void
+floatToHalfArrayScalar (
+    const float* IMATH_RESTRICT src,
+    imath_half_bits_t* IMATH_RESTRICT dst,
+    size_t                            n)
+{
+    for (size_t i = 0; i < n; ++i)
+        dst[i] = imath_float_to_half (src[i]);
+}
+
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+
+//
+// The SIMD kernels convert any remainder through a zero-padded
+// register-sized buffer rather than the scalar path, so that every
+// element of an array is converted by the same instruction.
+//
+
+//
+// F16C: 8 values per instruction in a 256-bit register.
+//
+
+IMATH_TARGET_F16C void
+halfToFloatArrayF16C (
+    const imath_half_bits_t* IMATH_RESTRICT src,
+    float* IMATH_RESTRICT dst,
+    size_t                   n)
+{
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        __m128i h = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (src + i));
+        _mm256_storeu_ps (dst + i, _mm256_cvtph_ps (h));
+    }
+
+    if (i < n)
+    {
+        imath_half_bits_t hbuf[8] = {0};
+        float             fbuf[8];
+        memcpy (hbuf, src + i, (n - i) * sizeof (imath_half_bits_t));
+        __m128i h = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (hbuf));
+        _mm256_storeu_ps (fbuf, _mm256_cvtph_ps (h));
+        memcpy (dst + i, fbuf, (n - i) * sizeof (float));
+    }
+}
+
+IMATH_TARGET_F16C void
+floatToHalfArrayF16C (
+    const float* IMATH_RESTRICT src,
+    imath_half_bits_t* IMATH_RESTRICT dst,
+    size_t                            n)
+{
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        __m128i h = _mm256_cvtps_ph (
+            _mm256_loadu_ps (src + i),
+            (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+        _mm_storeu_si128 (reinterpret_cast<__m128i*> (dst + i), h);
+    }
+
+    if (i < n)
+    {
+        float             fbuf[8] = {0};
+        imath_half_bits_t hbuf[8];
+        memcpy (fbuf, src + i, (n - i) * sizeof (float));
+        __m128i h = _mm256_cvtps_ph (
+            _mm256_loadu_ps (fbuf),
+            (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+        _mm_storeu_si128 (reinterpret_cast<__m128i*> (hbuf), h);
+        memcpy (dst + i, hbuf, (n - i) * sizeof (imath_half_bits_t));
+    }
+}
+
+//
+// AVX-512: 16 values per instruction in a 512-bit register.
+//
+
+IMATH_AVX512_KERNELS_BEGIN
+
+IMATH_TARGET_AVX512 void
+halfToFloatArrayAVX512 (
+    const imath_half_bits_t* IMATH_RESTRICT src,
+    float* IMATH_RESTRICT dst,
+    size_t                   n)
+{
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16)
+    {
+        __m256i h =
+            _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (src + i));
+        _mm512_storeu_ps (dst + i, _mm512_cvtph_ps (h));
+    }
+
+    if (i < n)
+    {
+        imath_half_bits_t hbuf[16] = {0};
+        float             fbuf[16];
+        memcpy (hbuf, src + i, (n - i) * sizeof (imath_half_bits_t));
+        __m256i h = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (hbuf));
+        _mm512_storeu_ps (fbuf, _mm512_cvtph_ps (h));
+        memcpy (dst + i, fbuf, (n - i) * sizeof (float));
+    }
+}
+
+IMATH_TARGET_AVX512 void
+floatToHalfArrayAVX512 (
+    const float* IMATH_RESTRICT src,
+    imath_half_bits_t* IMATH_RESTRICT dst,
+    size_t                            n)
+{
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16)
+    {
+        __m256i h = _mm512_cvtps_ph (
+            _mm512_loadu_ps (src + i),
+            (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+        _mm256_storeu_si256 (reinterpret_cast<__m256i*> (dst + i), h);
+    }
+
+    if (i < n)
+    {
+        float             fbuf[16] = {0};
+        imath_half_bits_t hbuf[16];
+        memcpy (fbuf, src + i, (n - i) * sizeof (float));
+        __m256i h = _mm512_cvtps_ph (
+            _mm512_loadu_ps (fbuf),
+            (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+        _mm256_storeu_si256 (reinterpret_cast<__m256i*> (hbuf), h);
+        memcpy (dst + i, hbuf, (n - i) * sizeof (imath_half_bits_t));
+    }
+}
+
+IMATH_AVX512_KERNELS_END
+
+enum HalfKernel
+{
+    HALF_KERNEL_SCALAR,
+    HALF_KERNEL_F16C,
+    HALF_KERNEL_AVX512
+};
+
+HalfKernel
+detectHalfKernel ()
+{
+    const ImathCpuFeatures& cpu = imathCpuFeatures ();
+
+    if (cpu.avx512f) return HALF_KERNEL_AVX512;
+
+    if (cpu.f16c) return HALF_KERNEL_F16C;
+
+    return HALF_KERNEL_SCALAR;
+}
+
+#endif // IMATH_X86_RUNTIME_DISPATCH
+
+struct HalfConversionKernels
+{
+    HalfToFloatArrayFn toFloat;
+    FloatToHalfArrayFn toHalf;
+    const char*        name;
+};
+
+HalfConversionKernels
+selectHalfConversionKernels ()
+{
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+    switch (detectHalfKernel ())
+    {
+        case HALF_KERNEL_AVX512:
+            return {halfToFloatArrayAVX512, floatToHalfArrayAVX512, "avx512"};
+        case HALF_KERNEL_F16C:
+            return {halfToFloatArrayF16C, floatToHalfArrayF16C, "f16c"};
+        default: break;
+    }
+#endif
+    return {halfToFloatArrayScalar, floatToHalfArrayScalar, "scalar"};
+}
+
+//
+// The kernels are selected once, on first use.
+//
+
+const HalfConversionKernels&
+halfConversionKernels ()
+{
+    static const HalfConversionKernels kernels = selectHalfConversionKernels ();
+    return kernels;
+}
+
+} // namespace
+
+extern "C" {
+
+IMATH_EXPORT void
+imath_half_to_float_array (const imath_half_bits_t* src, float* dst, size_t n)
+{
+    halfConversionKernels ().toFloat (src, dst, n);
+}
+
+IMATH_EXPORT void
+imath_float_to_half_array (const float* src, imath_half_bits_t* dst, size_t n)
+{
+    halfConversionKernels ().toHalf (src, dst, n);
+}
+
+IMATH_EXPORT const char*
+imath_half_array_kernel (void)
+{
+    return halfConversionKernels ().name;
+}
+
+} // extern "C"
+
+//----------------------------
+// Bulk arithmetic on halfs
+//----------------------------
+
+//
+// Each operation converts a register's worth of halfs to float,
+// computes in float, and rounds the result back to half. An
+// operation is described by a struct with a scalar() member for the
+// portable path and, on x86, f16c() and avx512() members that
+// compute the same thing on 8 and 16 lanes. Multiply-adds are always
+// fused, so that every path rounds the same way.
+//
+
+namespace
+{
+
+struct AddOp
+{
+    float scalar (float a, float b, float) const { return a + b; }
+
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+    IMATH_TARGET_F16C_FMA __m256 f16c (__m256 a, __m256 b, __m256) const
+    {
+        return _mm256_add_ps (a, b);
+    }
+
+    IMATH_TARGET_AVX512 __m512 avx512 (__m512 a, __m512 b, __m512) const
+    {
+        return _mm512_add_ps (a, b);
+    }
+#endif
+};
+
+struct MulOp
+{
+    float scalar (float a, float b, float) const { return a * b; }
+
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+    IMATH_TARGET_F16C_FMA __m256 f16c (__m256 a, __m256 b, __m256) const
+    {
+        return _mm256_mul_ps (a, b);
+    }
+
+    IMATH_TARGET_AVX512 __m512 avx512 (__m512 a, __m512 b, __m512) const
+    {
+        return _mm512_mul_ps (a, b);
+    }
+#endif
+};
+
+struct FmaOp
+{
+    float scalar (float a, float b, float c) const { return fmaf (a, b, c); }
+
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+    IMATH_TARGET_F16C_FMA __m256 f16c (__m256 a, __m256 b, __m256 c) const
+    {
+        return _mm256_fmadd_ps (a, b, c);
+    }
+
+    IMATH_TARGET_AVX512 __m512 avx512 (__m512 a, __m512 b, __m512 c) const
+    {
+        return _mm512_fmadd_ps (a, b, c);
+    }
+#endif
+};
+
+//
+// a + t * (b - a)
+//
+
+struct LerpOp
+{
+    float scalar (float a, float b, float t) const
+    {
+        return fmaf (t, b - a, a);
+    }
+
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+    IMATH_TARGET_F16C_FMA __m256 f16c (__m256 a, __m256 b, __m256 t) const
+    {
+        return _mm256_fmadd_ps (t, _mm256_sub_ps (b, a), a);
+    }
+
+    IMATH_TARGET_AVX512 __m512 avx512 (__m512 a, __m512 b, __m512 t) const
+    {
+        return _mm512_fmadd_ps (t, _mm512_sub_ps (b, a), a);
+    }
+#endif
+};
+
+//
+// The SSE min and max instructions return their second operand
+// unless the first compares less (or greater), which with the
+// operands swapped is exactly std::min and std::max, including for
+// NANs and signed zeros.
+//
+
+struct MinOp
+{
+    float scalar (float a, float b, float) const { return (b < a) ? b : a; }
+
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+    IMATH_TARGET_F16C_FMA __m256 f16c (__m256 a, __m256 b, __m256) const
+    {
+        return _mm256_min_ps (b, a);
+    }
+
+    IMATH_TARGET_AVX512 __m512 avx512 (__m512 a, __m512 b, __m512) const
+    {
+        return _mm512_min_ps (b, a);
+    }
+#endif
+};
+
+struct MaxOp
+{
+    float scalar (float a, float b, float) const { return (a < b) ? b : a; }
+
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+    IMATH_TARGET_F16C_FMA __m256 f16c (__m256 a, __m256 b, __m256) const
+    {
+        return _mm256_max_ps (b, a);
+    }
+
+    IMATH_TARGET_AVX512 __m512 avx512 (__m512 a, __m512 b, __m512) const
+    {
+        return _mm512_max_ps (b, a);
+    }
+#endif
+};
+
+//
+// min (hi, max (lo, a)), written as the SSE instructions evaluate it,
+// which is Imath::clamp() when lo <= hi
+//
+
+struct ClampOp
+{
+    float lo;
+    float hi;
+
+    float scalar (float a, float, float) const
+    {
+        float t = (lo > a) ? lo : a;
+        return (hi < t) ? hi : t;
+    }
+
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+    IMATH_TARGET_F16C_FMA __m256 f16c (__m256 a, __m256, __m256) const
+    {
+        return _mm256_min_ps (
+            _mm256_set1_ps (hi), _mm256_max_ps (_mm256_set1_ps (lo), a));
+    }
+
+    IMATH_TARGET_AVX512 __m512 avx512 (__m512 a, __m512, __m512) const
+    {
+        return _mm512_min_ps (
+            _mm512_set1_ps (hi), _mm512_max_ps (_mm512_set1_ps (lo), a));
+    }
+#endif
+};
+
+//
+// The loops. Sources that an operation does not use are null, and
+// read as zeros.
+//
+
+template <class Op>
+void
+arithmeticScalar (
+    const Op&                op,
+    const imath_half_bits_t* a,
+    const imath_half_bits_t* b,
+    const imath_half_bits_t* c,
+    imath_half_bits_t*       dst,
+    size_t                   n)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        dst[i] = imath_float_to_half (op.scalar (
+            imath_half_to_float (a[i]),
+            b ? imath_half_to_float (b[i]) : 0.0f,
+            c ? imath_half_to_float (c[i]) : 0.0f));
+    }
+}
+
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+
+IMATH_TARGET_F16C_FMA inline __m256
+loadHalf8 (const imath_half_bits_t* p)
+{
+    return _mm256_cvtph_ps (
+        _mm_loadu_si128 (reinterpret_cast<const __m128i*> (p)));
+}
+
+IMATH_TARGET_F16C_FMA inline void
+storeHalf8 (imath_half_bits_t* p, __m256 f)
+{
+    _mm_storeu_si128 (
+        reinterpret_cast<__m128i*> (p),
+        _mm256_cvtps_ph (f, (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)));
+}
+
+template <class Op>
+IMATH_TARGET_F16C_FMA void
+arithmeticF16C (
+    const Op&                op,
+    const imath_half_bits_t* a,
+    const imath_half_bits_t* b,
+    const imath_half_bits_t* c,
+    imath_half_bits_t*       dst,
+    size_t                   n)
+{
+    const __m256 zero = _mm256_setzero_ps ();
+    size_t       i    = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        storeHalf8 (
+            dst + i,
+            op.f16c (
+                loadHalf8 (a + i),
+                b ? loadHalf8 (b + i) : zero,
+                c ? loadHalf8 (c + i) : zero));
+    }
+
+    if (i < n)
+    {
+        imath_half_bits_t buf[4][8] = {{0}};
+        size_t            m         = (n - i) * sizeof (imath_half_bits_t);
+
+        memcpy (buf[0], a + i, m);
+        if (b) memcpy (buf[1], b + i, m);
+        if (c) memcpy (buf[2], c + i, m);
+
+        storeHalf8 (
+            buf[3],
+            op.f16c (loadHalf8 (buf[0]), loadHalf8 (buf[1]), loadHalf8 (buf[2])));
+
+        memcpy (dst + i, buf[3], m);
+    }
+}
+
+IMATH_AVX512_KERNELS_BEGIN
+
+IMATH_TARGET_AVX512 inline __m512
+loadHalf16 (const imath_half_bits_t* p)
+{
+    return _mm512_cvtph_ps (
+        _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (p)));
+}
+
+IMATH_TARGET_AVX512 inline void
+storeHalf16 (imath_half_bits_t* p, __m512 f)
+{
+    _mm256_storeu_si256 (
+        reinterpret_cast<__m256i*> (p),
+        _mm512_cvtps_ph (f, (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)));
+}
+
+template <class Op>
+IMATH_TARGET_AVX512 void
+arithmeticAVX512 (
+    const Op&                op,
+    const imath_half_bits_t* a,
+    const imath_half_bits_t* b,
+    const imath_half_bits_t* c,
+    imath_half_bits_t*       dst,
+    size_t                   n)
+{
+    const __m512 zero = _mm512_setzero_ps ();
+    size_t       i    = 0;
+
+    for (; i + 16 <= n; i += 16)
+    {
+        storeHalf16 (
+            dst + i,
+            op.avx512 (
+                loadHalf16 (a + i),
+                b ? loadHalf16 (b + i) : zero,
+                c ? loadHalf16 (c + i) : zero));
+    }
+
+    if (i < n)
+    {
+        imath_half_bits_t buf[4][16] = {{0}};
+        size_t            m          = (n - i) * sizeof (imath_half_bits_t);
+
+        memcpy (buf[0], a + i, m);
+        if (b) memcpy (buf[1], b + i, m);
+        if (c) memcpy (buf[2], c + i, m);
+
+        storeHalf16 (
+            buf[3],
+            op.avx512 (
+                loadHalf16 (buf[0]), loadHalf16 (buf[1]), loadHalf16 (buf[2])));
+
+        memcpy (dst + i, buf[3], m);
+    }
+}
+
+IMATH_AVX512_KERNELS_END
+
+//
+// The 8-lane kernels use FMA as well as F16C, which a few early F16C
+// processors lack; those get the portable loop.
+//
+
+HalfKernel
+detectHalfArithmeticKernel ()
+{
+    HalfKernel k = detectHalfKernel ();
+
+    if (k == HALF_KERNEL_F16C && !imathCpuFeatures ().fma)
+        return HALF_KERNEL_SCALAR;
+
+    return k;
+}
+
+#endif // IMATH_X86_RUNTIME_DISPATCH
+
+template <class Op>
+void
+arithmetic (
+    const Op&                op,
+    const imath_half_bits_t* a,
+    const imath_half_bits_t* b,
+    const imath_half_bits_t* c,
+    imath_half_bits_t*       dst,
+    size_t                   n)
+{
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+    static const HalfKernel kernel = detectHalfArithmeticKernel ();
+
+    switch (kernel)
+    {
+        case HALF_KERNEL_AVX512:
+            arithmeticAVX512 (op, a, b, c, dst, n);
+            return;
+        case HALF_KERNEL_F16C: arithmeticF16C (op, a, b, c, dst, n); return;
+        default: break;
+    }
+#endif
+    arithmeticScalar (op, a, b, c, dst, n);
+}
+
+} // namespace
+
+extern "C" {
+
+IMATH_EXPORT void
+imath_half_add_array (
+    const imath_half_bits_t* a,
+    const imath_half_bits_t* b,
+    imath_half_bits_t*       dst,
+    size_t                   n)
+{
+    arithmetic (AddOp (), a, b, 0, dst, n);
+}
+
+IMATH_EXPORT void
+imath_half_mul_array (
+    const imath_half_bits_t* a,
+    const imath_half_bits_t* b,
+    imath_half_bits_t*       dst,
+    size_t                   n)
+{
+    arithmetic (MulOp (), a, b, 0, dst, n);
+}
+
+IMATH_EXPORT void
+imath_half_fma_array (
+    const imath_half_bits_t* a,
+    const imath_half_bits_t* b,
+    const imath_half_bits_t* c,
+    imath_half_bits_t*       dst,
+    size_t                   n)
+{
+    arithmetic (FmaOp (), a, b, c, dst, n);
+}
+
+IMATH_EXPORT void
+imath_half_lerp_array (
+    const imath_half_bits_t* a,
+    const imath_half_bits_t* b,
+    const imath_half_bits_t* t,
+    imath_half_bits_t*       dst,
+    size_t                   n)
+{
+    arithmetic (LerpOp (), a, b, t, dst, n);
+}
+
+IMATH_EXPORT void
+imath_half_min_array (
+    const imath_half_bits_t* a,
+    const imath_half_bits_t* b,
+    imath_half_bits_t*       dst,
+    size_t                   n)
+{
+    arithmetic (MinOp (), a, b, 0, dst, n);
+}
+
+IMATH_EXPORT void
+imath_half_max_array (
+    const imath_half_bits_t* a,
+    const imath_half_bits_t* b,
+    imath_half_bits_t*       dst,
+    size_t                   n)
+{
+    arithmetic (MaxOp (), a, b, 0, dst, n);
+}
+
+IMATH_EXPORT void
+imath_half_clamp_array (
+    const imath_half_bits_t* src,
+    imath_half_bits_t        lo,
+    imath_half_bits_t        hi,
+    imath_half_bits_t*       dst,
+    size_t                   n)
+{
+    ClampOp op = {imath_half_to_float (lo), imath_half_to_float (hi)};
+    arithmetic (op, src, 0, 0, dst, n);
+}
+
+} // extern "C"
+
 //---------------------
 // Stream I/O operators
 //---------------------
@@ -138,11 +138,31 @@
 /// may be preferable when memory limits preclude storing of the
 /// 65,536-entry lookup table.
 ///
-/// The lookup table symbol is included in the compilation even if
+/// **Conversion via Compact Lookup Table**
+///
+/// The full table occupies 256 KB, which is a poor trade for
+/// short-lived processes that convert few values: every cache line
+/// of the table they touch is a cold miss. When
+/// ``IMATH_HALF_USE_COMPACT_LOOKUP_TABLE`` is defined, half-to-float
+/// conversion instead uses an 8 KB table, pointed to by
+/// ``imath_half_to_float_compact_table``, that holds the float bits
+/// of the 1024 denormalized and 1024 normalized half significands,
+/// and adds in the sign and exponent arithmetically. The results are
+/// identical to the full table. The arithmetic makes the compact
+/// table slower when both tables are hot in the cache: on an x86-64
+/// test machine it took 1.3 to 2 times as long per value as the full
+/// table, for example 1.0 ns against 0.6 ns (see
+/// ``half_perf_test.cpp``). Its advantage is that it stays
+/// cache-resident where the full table does not, so it is the better
+/// choice only when few values are converted, or when the full table
+/// would be evicted between conversions. This takes precedence over
+/// ``IMATH_HALF_USE_LOOKUP_TABLE`` but not over F16C.
+///
+/// The lookup table symbols are included in the compilation even if
 /// ``IMATH_HALF_USE_LOOKUP_TABLE`` is false, because application code
 /// using the exported ``half.h`` may choose to enable the use of the table.
 ///
-/// An implementation can eliminate the table from compilation by
+/// An implementation can eliminate the tables from compilation by
 /// defining the ``IMATH_HALF_NO_LOOKUP_TABLE`` preprocessor symbol.
 /// Simply add:
 ///
@@ -176,6 +196,28 @@
 /// **Note:** the timing above depends on the distribution of the
 /// floats in question.
 ///
+/// **Bulk Conversion:**
+///
+/// Converting large buffers one value at a time leaves most of the
+/// available throughput unused. The ``imath_half_to_float_array`` and
+/// ``imath_float_to_half_array`` functions convert whole arrays.
+///
+/// Unlike the inline single-value functions, which can only use F16C
+/// when the calling code is compiled for it, the array functions are
+/// dispatched at run time: on x86, the library detects the host CPU's
+/// features on first use and converts 16 values at a time with
+/// AVX-512, 8 at a time with F16C, or otherwise falls back to a loop
+/// over the scalar conversion above. A library built for baseline
+/// x86-64 therefore still takes the fastest path available.
+/// ``imath_half_array_kernel`` reports which path was selected.
+///
+/// The results are identical to converting each element with
+/// ``imath_half_to_float`` / ``imath_float_to_half``, except that,
+/// as with F16C in general, a signalling NAN may come back quiet. A
+/// float NAN with none of its significand bits in the half's
+/// precision then becomes a quiet NAN with a zero payload, where the
+/// bit-shift conversion sets the lowest significand bit instead.
+///
 
 #ifdef __CUDA_ARCH__
 // do not include intrinsics headers on Cuda
@@ -187,6 +229,7 @@
 #    include <immintrin.h>
 #endif
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 
@@ -275,6 +318,32 @@ extern "C"
 extern
 #    endif
     IMATH_EXPORT const imath_half_uif_t* imath_half_to_float_table;
+
+#    if defined(__cplusplus)
+extern "C"
+#    else
+extern
+#    endif
+    IMATH_EXPORT const uint32_t* imath_half_to_float_compact_table;
+
+///
+/// Convert half to float with the compact lookup table, whatever
+/// conversion the build selected for imath_half_to_float()
+///
+
+static inline float
+imath_half_to_float_compact (imath_half_bits_t h)
+{
+    // The table covers the denormalized and normalized significands;
+    // the sign and exponent are added in, with the exponent of
+    // infinities and NANs needing an extra adjustment.
+    imath_half_uif_t v;
+    uint32_t         e = h & 0x7c00;
+    v.i = imath_half_to_float_compact_table[((e != 0) << 10) | (h & 0x3ff)] +
+          ((uint32_t) (h & 0x8000) << 16) + (e << 13) +
+          (e == 0x7c00 ? 0x38000000 : 0);
+    return v.f;
+}
 #endif
 
 ///
@@ -296,6 +365,9 @@ imath_half_to_float (imath_half_bits_t h)
 #    else
     return _cvtsh_ss (h);
 #    endif
+#elif defined(IMATH_HALF_USE_COMPACT_LOOKUP_TABLE) &&                          \
+    !defined(IMATH_HALF_NO_LOOKUP_TABLE)
+    return imath_half_to_float_compact (h);
 #elif defined(IMATH_HALF_USE_LOOKUP_TABLE) &&                                  \
     !defined(IMATH_HALF_NO_LOOKUP_TABLE)
     return imath_half_to_float_table[h].f;
@@ -442,6 +514,107 @@ imath_float_to_half (float f)
 #endif
 }
 
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+///
+/// Convert an array of n half values to float.
+///
+/// ``src`` and ``dst`` may have any alignment, but must not overlap.
+///
+
+IMATH_EXPORT void imath_half_to_float_array (
+    const imath_half_bits_t* src, float* dst, size_t n);
+
+///
+/// Convert an array of n float values to half, rounding to nearest
+/// even like ``imath_float_to_half``.
+///
+/// ``src`` and ``dst`` may have any alignment, but must not overlap.
+///
+
+IMATH_EXPORT void imath_float_to_half_array (
+    const float* src, imath_half_bits_t* dst, size_t n);
+
+///
+/// Return the name of the conversion kernel the array functions use
+/// on this host: "avx512", "f16c" or "scalar".
+///
+
+IMATH_EXPORT const char* imath_half_array_kernel (void);
+
+///
+/// @{
+/// @name Array arithmetic
+///
+/// Element-wise arithmetic on arrays of n half values. Each result
+/// is computed in float and rounded to half as by
+/// ``imath_float_to_half``; multiply-adds are fused, that is, rounded
+/// only once in float. Where more than one operand is a NAN, which
+/// of them the result carries is unspecified. ``dst`` may be the same
+/// array as any of the sources, but must not otherwise overlap them.
+///
+
+/// dst = a + b
+IMATH_EXPORT void imath_half_add_array (
+    const imath_half_bits_t* a,
+    const imath_half_bits_t* b,
+    imath_half_bits_t*       dst,
+    size_t                   n);
+
+/// dst = a * b
+IMATH_EXPORT void imath_half_mul_array (
+    const imath_half_bits_t* a,
+    const imath_half_bits_t* b,
+    imath_half_bits_t*       dst,
+    size_t                   n);
+
+/// dst = a * b + c
+IMATH_EXPORT void imath_half_fma_array (
+    const imath_half_bits_t* a,
+    const imath_half_bits_t* b,
+    const imath_half_bits_t* c,
+    imath_half_bits_t*       dst,
+    size_t                   n);
+
+/// dst = a + t * (b - a)
+IMATH_EXPORT void imath_half_lerp_array (
+    const imath_half_bits_t* a,
+    const imath_half_bits_t* b,
+    const imath_half_bits_t* t,
+    imath_half_bits_t*       dst,
+    size_t                   n);
+
+/// dst = (b < a) ? b : a, like std::min
+IMATH_EXPORT void imath_half_min_array (
+    const imath_half_bits_t* a,
+    const imath_half_bits_t* b,
+    imath_half_bits_t*       dst,
+    size_t                   n);
+
+/// dst = (a < b) ? b : a, like std::max
+IMATH_EXPORT void imath_half_max_array (
+    const imath_half_bits_t* a,
+    const imath_half_bits_t* b,
+    imath_half_bits_t*       dst,
+    size_t                   n);
+
+/// dst = src clamped to [lo, hi]; a NAN stays a NAN. Requires
+/// lo <= hi.
+IMATH_EXPORT void imath_half_clamp_array (
+    const imath_half_bits_t* src,
+    imath_half_bits_t        lo,
+    imath_half_bits_t        hi,
+    imath_half_bits_t*       dst,
+    size_t                   n);
+
+/// @}
+
+#if defined(__cplusplus)
+} // extern "C"
+#endif
+
 ////////////////////////////////////////
 
 #ifdef __cplusplus
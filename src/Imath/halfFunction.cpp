@@ -0,0 +1,179 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+//-----------------------------------------------------------------------------
+//
+//	The registry behind sharedHalfFunction(). It lives in the
+//	library rather than in the header so that every module linked
+//	against Imath sees the same tables.
+//
+//	Also the array lookups of halfFunction<T>::apply(), which select
+//	their AVX2 kernels at run time.
+//
+//-----------------------------------------------------------------------------
+
+#include "halfFunction.h"
+#include "ImathCpuFeatures.h"
+
+#include <map>
+#include <mutex>
+
+namespace
+{
+
+std::mutex&
+registryMutex ()
+{
+    static std::mutex m;
+    return m;
+}
+
+std::map<std::string, std::shared_ptr<const void>>&
+registry ()
+{
+    static std::map<std::string, std::shared_ptr<const void>> r;
+    return r;
+}
+
+} // namespace
+
+std::shared_ptr<const void>
+halfFunctionRegistryFind (const std::string& key)
+{
+    std::lock_guard<std::mutex> lock (registryMutex ());
+
+    auto i = registry ().find (key);
+    return i == registry ().end () ? std::shared_ptr<const void> ()
+                                   : i->second;
+}
+
+std::shared_ptr<const void>
+halfFunctionRegistryInsert (
+    const std::string& key, std::shared_ptr<const void> table)
+{
+    std::lock_guard<std::mutex> lock (registryMutex ());
+
+    return registry ().insert (std::make_pair (key, std::move (table)))
+        .first->second;
+}
+
+void
+halfFunctionRegistryErase (const std::string& key)
+{
+    //
+    // The entries for key are those whose registry key is key, a
+    // '\0' and a type name; see sharedHalfFunction().
+    //
+
+    std::string prefix = key;
+    prefix += '\0';
+
+    std::lock_guard<std::mutex> lock (registryMutex ());
+
+    auto i = registry ().lower_bound (prefix);
+
+    while (i != registry ().end () &&
+           i->first.compare (0, prefix.size (), prefix) == 0)
+        i = registry ().erase (i);
+}
+
+void
+halfFunctionRegistryClear ()
+{
+    std::lock_guard<std::mutex> lock (registryMutex ());
+    registry ().clear ();
+}
+
+namespace
+{
+
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+
+//
+// Look up 8 values at a time with a gather. Return the number of
+// values looked up; the caller does the rest.
+//
+
+IMATH_TARGET_AVX2 size_t
+lookup32AVX2 (const uint32_t* lut, const half* in, uint32_t* out, size_t n)
+{
+    const int* table = reinterpret_cast<const int*> (lut);
+    size_t     i     = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i x = _mm256_cvtepu16_epi32 (
+            _mm_loadu_si128 (reinterpret_cast<const __m128i*> (in + i)));
+        _mm256_storeu_si256 (
+            reinterpret_cast<__m256i*> (out + i),
+            _mm256_i32gather_epi32 (table, x, 4));
+    }
+
+    return i;
+}
+
+//
+// The 16-bit lookup gathers the 32 bits at each table entry and keeps
+// the low half. The gather at the last entry, 0xffff, would read past
+// the end of the table, so that lane is masked off and filled with
+// the entry instead.
+//
+
+IMATH_TARGET_AVX2 size_t
+lookup16AVX2 (const uint16_t* lut, const half* in, uint16_t* out, size_t n)
+{
+    const int*    table = reinterpret_cast<const int*> (lut);
+    const __m256i ffff  = _mm256_set1_epi32 (0xffff);
+    const __m256i fill  = _mm256_set1_epi32 (lut[0xffff]);
+    size_t        i     = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i x = _mm256_cvtepu16_epi32 (
+            _mm_loadu_si128 (reinterpret_cast<const __m128i*> (in + i)));
+        __m256i mask = _mm256_xor_si256 (
+            _mm256_cmpeq_epi32 (x, ffff), _mm256_set1_epi32 (-1));
+        __m256i y = _mm256_and_si256 (
+            _mm256_mask_i32gather_epi32 (fill, table, x, mask, 2), ffff);
+        _mm_storeu_si128 (
+            reinterpret_cast<__m128i*> (out + i),
+            _mm_packus_epi32 (
+                _mm256_castsi256_si128 (y), _mm256_extracti128_si256 (y, 1)));
+    }
+
+    return i;
+}
+
+#endif // IMATH_X86_RUNTIME_DISPATCH
+
+} // namespace
+
+void
+halfFunctionLookup32 (
+    const uint32_t* lut, const half* in, uint32_t* out, size_t n)
+{
+    size_t i = 0;
+
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+    if (imathCpuFeatures ().avx2) i = lookup32AVX2 (lut, in, out, n);
+#endif
+
+    for (; i < n; ++i)
+        out[i] = lut[in[i].bits ()];
+}
+
+void
+halfFunctionLookup16 (
+    const uint16_t* lut, const half* in, uint16_t* out, size_t n)
+{
+    size_t i = 0;
+
+#ifdef IMATH_X86_RUNTIME_DISPATCH
+    if (imathCpuFeatures ().avx2) i = lookup16AVX2 (lut, in, out, n);
+#endif
+
+    for (; i < n; ++i)
+        out[i] = lut[in[i].bits ()];
+}
@@ -44,6 +44,80 @@
 //	    half x = hsin (1);
 //	    half y = hsqrt (3.5);
 //
+//	Whole arrays can be evaluated with apply(), which uses AVX2
+//	gathers for 32-bit and 16-bit results, such as float and half,
+//	on processors that support them:
+//
+//	    hsqrt.apply (pixels, result, numPixels);
+//	    hsqrt.apply (pixels, numPixels);	// in place
+//
+//	Given an executor (see below) after the array, apply() hands
+//	ranges of the array to it, to be evaluated in parallel:
+//
+//	    hsqrt.apply (pixels, result, numPixels, executor);
+//
+//	A halfFunction is immutable after construction, so separate
+//	threads may also call apply() on disjoint parts of an array.
+//
+//	Building the table takes 65,536 evaluations of the function.
+//	To spread them over several threads, pass an executor after the
+//	function:
+//
+//	    halfFunction<float> hpow (gamma, executor, 0, HALF_MAX);
+//
+//	An executor is any callable of the form
+//
+//	    void executor (int begin, int end,
+//			   const std::function<void (int, int)>& body);
+//
+//	that calls body(b, e) for disjoint ranges [b, e) which together
+//	cover [begin, end), possibly concurrently, and returns when all
+//	of them are done. For example, with TBB:
+//
+//	    auto executor = [] (int begin, int end,
+//				const std::function<void (int, int)>& body)
+//	    {
+//		tbb::parallel_for (
+//		    tbb::blocked_range<int> (begin, end),
+//		    [&] (const tbb::blocked_range<int>& r)
+//		    { body (r.begin (), r.end ()); });
+//	    };
+//
+//	The function is then called from several threads at once, so it
+//	must be safe to do so.
+//
+//	halfFunctionCompact<T> has the same interface as halfFunction<T>,
+//	but tabulates only the finite half values in [domainMin,
+//	domainMax]; all other inputs map to one of the stored default,
+//	infinity and NAN values. For a narrow domain such as [0, 1] this
+//	needs a quarter of the memory, at the cost of a range check per
+//	evaluation.
+//
+//	Separate parts of a program, for example plugins, that need the
+//	same table can share a single read-only copy through a registry
+//	in the Imath library:
+//
+//	    std::shared_ptr<const halfFunction<float>> hpow =
+//		sharedHalfFunction<halfFunction<float>> (
+//		    "pow 1/2.2", gamma, 0, HALF_MAX);
+//
+//	The first call with a given key builds the table from the
+//	remaining arguments, exactly as the constructor would; later
+//	calls with the same key and table type return the same table
+//	without calling the function. The key must therefore identify
+//	the function, including any parameters it captures, and the
+//	domain and default values. Tables stay in the registry until
+//	halfFunctionRegistryErase() is called with their key, or
+//	halfFunctionRegistryClear() is called.
+//
+//	A table is built, and will be destroyed, by code in the module
+//	that first registered it, so it must not outlive that module. A
+//	plugin that may be unloaded must erase the keys it registered,
+//	and release its own references to their tables, before it is
+//	unloaded, and other modules must not hold on to those tables:
+//
+//	    halfFunctionRegistryErase ("pow 1/2.2");
+//
 //---------------------------------------------------------------------------
 
 #ifndef _HALF_FUNCTION_H_
@@ -60,6 +134,28 @@
 #endif
 
 #include <float.h>
+#include <limits.h>
+#include <functional>
+#include <memory>
+#include <stddef.h>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+//
+// Look up 32-bit or 16-bit values in a table indexed by half bit
+// patterns: out[i] = lut[in[i].bits ()], for 0 <= i < n. in and out
+// may be the same array. The library selects AVX2 gathers at run
+// time if the processor supports them. These are the array
+// evaluation of halfFunction<T> for 32-bit and 16-bit types T.
+//
+
+IMATH_EXPORT void halfFunctionLookup32 (
+    const uint32_t* lut, const half* in, uint32_t* out, size_t n);
+
+IMATH_EXPORT void halfFunctionLookup16 (
+    const uint16_t* lut, const half* in, uint16_t* out, size_t n);
 
 template <class T> class halfFunction
 {
@@ -78,6 +174,27 @@ public:
         T        negInfValue  = 0,
         T        nanValue     = 0);
 
+    //
+    // Constructor that fills the table through an executor. (The
+    // executor cannot be a number, which keeps this distinct from the
+    // constructor above.)
+    //
+
+    template <
+        class Function,
+        class Executor,
+        class = typename std::enable_if<
+            !std::is_convertible<Executor, half>::value>::type>
+    halfFunction (
+        Function f,
+        Executor executor,
+        half     domainMin    = -HALF_MAX,
+        half     domainMax    = HALF_MAX,
+        T        defaultValue = 0,
+        T        posInfValue  = 0,
+        T        negInfValue  = 0,
+        T        nanValue     = 0);
+
 #ifndef IMATH_HAVE_LARGE_STACK
     ~halfFunction () { delete[] _lut; }
     halfFunction (const halfFunction&) = delete;
@@ -92,7 +209,41 @@ public:
 
     T operator() (half x) const;
 
+    //------------------
+    // Array evaluation
+    //------------------
+
+    void apply (const half* in, T* out, size_t n) const;
+
+    //
+    // In-place evaluation; only for halfFunction<half>.
+    //
+
+    void apply (half* data, size_t n) const;
+
+    //
+    // Array evaluation that hands ranges of the array to an executor.
+    //
+
+    template <class Executor>
+    void apply (const half* in, T* out, size_t n, Executor executor) const;
+
+    template <class Executor>
+    void apply (half* data, size_t n, Executor executor) const;
+
 private:
+    template <class Function>
+    void fill (
+        Function& f,
+        int       begin,
+        int       end,
+        half      domainMin,
+        half      domainMax,
+        T         defaultValue,
+        T         posInfValue,
+        T         negInfValue,
+        T         nanValue);
+
 #ifdef IMATH_HAVE_LARGE_STACK
     T _lut[1 << 16];
 #else
@@ -100,6 +251,147 @@ private:
 #endif
 };
 
+template <class T> class halfFunctionCompact
+{
+public:
+    //------------
+    // Constructor
+    //------------
+
+    template <class Function>
+    halfFunctionCompact (
+        Function f,
+        half     domainMin    = -HALF_MAX,
+        half     domainMax    = HALF_MAX,
+        T        defaultValue = 0,
+        T        posInfValue  = 0,
+        T        negInfValue  = 0,
+        T        nanValue     = 0);
+
+    template <
+        class Function,
+        class Executor,
+        class = typename std::enable_if<
+            !std::is_convertible<Executor, half>::value>::type>
+    halfFunctionCompact (
+        Function f,
+        Executor executor,
+        half     domainMin    = -HALF_MAX,
+        half     domainMax    = HALF_MAX,
+        T        defaultValue = 0,
+        T        posInfValue  = 0,
+        T        negInfValue  = 0,
+        T        nanValue     = 0);
+
+    ~halfFunctionCompact () { delete[] _lut; }
+    halfFunctionCompact (const halfFunctionCompact&) = delete;
+    halfFunctionCompact& operator= (const halfFunctionCompact&) = delete;
+    halfFunctionCompact (halfFunctionCompact&&)                 = delete;
+    halfFunctionCompact& operator= (halfFunctionCompact&&) = delete;
+
+    //-----------
+    // Evaluation
+    //-----------
+
+    T operator() (half x) const;
+
+    void apply (const half* in, T* out, size_t n) const;
+
+    //
+    // Number of tabulated values
+    //
+
+    size_t size () const { return _size[0] + _size[1]; }
+
+private:
+    template <class Function, class Executor>
+    void init (
+        Function& f,
+        Executor& executor,
+        half      domainMin,
+        half      domainMax);
+
+    //
+    // The finite half values in the domain form at most two runs of
+    // bit patterns, one of non-negative and one of negative values.
+    // Run s (the sign bit) starts at bit pattern _start[s], holds
+    // _size[s] values and is stored from _lut[_offset[s]] on.
+    //
+
+    T*       _lut;
+    uint16_t _start[2];
+    uint32_t _size[2];
+    uint32_t _offset[2];
+    T        _defaultValue;
+    T        _posInfValue;
+    T        _negInfValue;
+    T        _nanValue;
+};
+
+//
+// The executor used by the constructors that take none
+//
+
+struct halfFunctionSerialExecutor
+{
+    void operator() (
+        int begin, int end, const std::function<void (int, int)>& body) const
+    {
+        body (begin, end);
+    }
+};
+
+//
+// Registry of shared tables. Entries are keyed by the user's key and
+// the table type; see sharedHalfFunction() below.
+//
+
+IMATH_EXPORT std::shared_ptr<const void>
+             halfFunctionRegistryFind (const std::string& key);
+
+//
+// Adds table under key and returns it, or returns the table already
+// registered under key, if any.
+//
+
+IMATH_EXPORT std::shared_ptr<const void> halfFunctionRegistryInsert (
+    const std::string& key, std::shared_ptr<const void> table);
+
+//
+// Removes the tables of every type registered under key. Tables
+// still referenced elsewhere stay valid until they are released.
+//
+
+IMATH_EXPORT void halfFunctionRegistryErase (const std::string& key);
+
+IMATH_EXPORT void halfFunctionRegistryClear ();
+
+template <class Table, class... Args>
+std::shared_ptr<const Table>
+sharedHalfFunction (const std::string& key, Args&&... args)
+{
+    std::string fullKey = key;
+    fullKey += '\0';
+    fullKey += typeid (Table).name ();
+
+    std::shared_ptr<const void> table = halfFunctionRegistryFind (fullKey);
+
+    if (!table)
+    {
+        //
+        // Build outside the registry's lock. If another thread
+        // registers the same key meanwhile, its table wins and this
+        // one is discarded.
+        //
+
+        table = halfFunctionRegistryInsert (
+            fullKey,
+            std::make_shared<const Table> (std::forward<Args> (args)...));
+    }
+
+    return std::static_pointer_cast<const Table> (table);
+}
+
 //---------------
 // Implementation
 //---------------
@@ -119,7 +411,63 @@ halfFunction<T>::halfFunction (
     _lut = new T[1 << 16];
 #endif
 
-    for (int i = 0; i < (1 << 16); i++)
+    fill (
+        f,
+        0,
+        1 << 16,
+        domainMin,
+        domainMax,
+        defaultValue,
+        posInfValue,
+        negInfValue,
+        nanValue);
+}
+
+template <class T>
+template <class Function, class Executor, class>
+halfFunction<T>::halfFunction (
+    Function f,
+    Executor executor,
+    half     domainMin,
+    half     domainMax,
+    T        defaultValue,
+    T        posInfValue,
+    T        negInfValue,
+    T        nanValue)
+{
+#ifndef IMATH_HAVE_LARGE_STACK
+    _lut = new T[1 << 16];
+#endif
+
+    executor (0, 1 << 16, [&] (int begin, int end) {
+        fill (
+            f,
+            begin,
+            end,
+            domainMin,
+            domainMax,
+            defaultValue,
+            posInfValue,
+            negInfValue,
+            nanValue);
+    });
+}
+
+template <class T>
+template <class Function>
+void
+halfFunction<T>::fill (
+    Function& f,
+    int       begin,
+    int       end,
+    half      domainMin,
+    half      domainMax,
+    T         defaultValue,
+    T         posInfValue,
+    T         negInfValue,
+    T         nanValue)
+{
+    for (int i = begin; i < end; i++)
     {
         half x;
         x.setBits (i);
@@ -142,6 +490,195 @@ halfFunction<T>::operator() (half x) const
     return _lut[x.bits ()];
 }
 
+template <class T>
+inline void
+halfFunction<T>::apply (const half* in, T* out, size_t n) const
+{
+    if (sizeof (T) == 4 && std::is_trivially_copyable<T>::value)
+    {
+        halfFunctionLookup32 (
+            reinterpret_cast<const uint32_t*> (&_lut[0]),
+            in,
+            reinterpret_cast<uint32_t*> (out),
+            n);
+        return;
+    }
+
+    if (sizeof (T) == 2 && std::is_trivially_copyable<T>::value)
+    {
+        halfFunctionLookup16 (
+            reinterpret_cast<const uint16_t*> (&_lut[0]),
+            in,
+            reinterpret_cast<uint16_t*> (out),
+            n);
+        return;
+    }
+
+    for (size_t i = 0; i < n; ++i)
+        out[i] = _lut[in[i].bits ()];
+}
+
+template <class T>
+inline void
+halfFunction<T>::apply (half* data, size_t n) const
+{
+    static_assert (
+        std::is_same<T, half>::value,
+        "in-place evaluation requires a halfFunction<half>");
+
+    apply (data, reinterpret_cast<T*> (data), n);
+}
+
+template <class T>
+template <class Executor>
+inline void
+halfFunction<T>::apply (
+    const half* in, T* out, size_t n, Executor executor) const
+{
+    //
+    // The executor's ranges are ints, so larger arrays are handed to
+    // it in pieces.
+    //
+
+    const size_t piece = size_t (INT_MAX);
+
+    for (size_t first = 0; first < n; first += piece)
+    {
+        const size_t m = n - first < piece ? n - first : piece;
+
+        executor (0, int (m), [&] (int begin, int end) {
+            const size_t i = first + size_t (begin);
+            apply (in + i, out + i, size_t (end - begin));
+        });
+    }
+}
+
+template <class T>
+template <class Executor>
+inline void
+halfFunction<T>::apply (half* data, size_t n, Executor executor) const
+{
+    static_assert (
+        std::is_same<T, half>::value,
+        "in-place evaluation requires a halfFunction<half>");
+
+    apply (data, reinterpret_cast<T*> (data), n, executor);
+}
+
+template <class T>
+template <class Function>
+halfFunctionCompact<T>::halfFunctionCompact (
+    Function f,
+    half     domainMin,
+    half     domainMax,
+    T        defaultValue,
+    T        posInfValue,
+    T        negInfValue,
+    T        nanValue)
+    : _lut (0)
+    , _defaultValue (defaultValue)
+    , _posInfValue (posInfValue)
+    , _negInfValue (negInfValue)
+    , _nanValue (nanValue)
+{
+    halfFunctionSerialExecutor executor;
+    init (f, executor, domainMin, domainMax);
+}
+
+template <class T>
+template <class Function, class Executor, class>
+halfFunctionCompact<T>::halfFunctionCompact (
+    Function f,
+    Executor executor,
+    half     domainMin,
+    half     domainMax,
+    T        defaultValue,
+    T        posInfValue,
+    T        negInfValue,
+    T        nanValue)
+    : _lut (0)
+    , _defaultValue (defaultValue)
+    , _posInfValue (posInfValue)
+    , _negInfValue (negInfValue)
+    , _nanValue (nanValue)
+{
+    init (f, executor, domainMin, domainMax);
+}
+
+template <class T>
+template <class Function, class Executor>
+void
+halfFunctionCompact<T>::init (
+    Function& f, Executor& executor, half domainMin, half domainMax)
+{
+    //
+    // Find the run of in-domain finite values for each sign. Within
+    // a sign, values are monotonic in their bit patterns, so each run
+    // is contiguous.
+    //
+
+    for (int s = 0; s < 2; ++s)
+    {
+        int first = -1;
+        int last  = -1;
+
+        for (int i = 0; i < 0x7c00; ++i)
+        {
+            half x;
+            x.setBits (uint16_t ((s << 15) | i));
+
+            if (!(x < domainMin || x > domainMax))
+            {
+                if (first < 0) first = i;
+                last = i;
+            }
+        }
+
+        _start[s] = uint16_t ((s << 15) | (first < 0 ? 0 : first));
+        _size[s]  = first < 0 ? 0 : uint32_t (last - first + 1);
+    }
+
+    _offset[0] = 0;
+    _offset[1] = _size[0];
+
+    _lut = new T[size () > 0 ? size () : 1];
+
+    executor (0, int (size ()), [&] (int begin, int end) {
+        for (int i = begin; i < end; i++)
+        {
+            int  s = (uint32_t (i) < _size[0]) ? 0 : 1;
+            half x;
+            x.setBits (uint16_t (_start[s] + (uint32_t (i) - _offset[s])));
+            _lut[i] = f (x);
+        }
+    });
+}
+
+template <class T>
+inline T
+halfFunctionCompact<T>::operator() (half x) const
+{
+    uint16_t b = x.bits ();
+    int      s = b >> 15;
+    uint16_t i = uint16_t (b - _start[s]);
+
+    if (i < _size[s]) return _lut[_offset[s] + i];
+
+    if (x.isNan ()) return _nanValue;
+
+    if (x.isInfinity ()) return x.isNegative () ? _negInfValue : _posInfValue;
+
+    return _defaultValue;
+}
+
+template <class T>
+inline void
+halfFunctionCompact<T>::apply (const half* in, T* out, size_t n) const
+{
+    for (size_t i = 0; i < n; ++i)
+        out[i] = (*this) (in[i]);
+}
+
 /// @endcond
 
 #endif
@@ -12,10 +12,19 @@
 //	The program loops over all 65536 possible half numbers,
 //	converts each of them to a float, and prints the result.
 //
+//	The build runs it to produce toFloat.h and, with --compact,
+//	toFloatCompact.h:
+//
+//	    toFloat [--compact] [output-file]
+//
+//	If no output file is given, the table is printed to stdout.
+//
 //---------------------------------------------------------------------------
 
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <string>
 
 using namespace std;
 
@@ -93,37 +102,129 @@ halfToFloat (unsigned short y)
     return (s << 31) | (e << 23) | m;
 }
 
+//---------------------------------------------------
+// The compact table holds the float bits for the 1024
+// denormalized and, including the exponent bias, the 1024
+// normalized half significands. The sign and exponent are
+// added arithmetically:
+//
+//     e = h & 0x7c00
+//     f = compact[(e != 0) * 1024 + (h & 0x3ff)]
+//         + ((h & 0x8000) << 16) + (e << 13)
+//         + (e == 0x7c00 ? 0x38000000 : 0)
+//---------------------------------------------------
+
+unsigned int
+compactMantissa (int i)
+{
+    if (i < 1024)
+        return halfToFloat ((unsigned short) i); // zero or denormalized
+
+    return 0x38000000 + ((i - 1024) << 13); // normalized
+}
+
 //---------------------------------------------
-// Main - prints the half-to-float lookup table
+// Print the compact table
 //---------------------------------------------
 
-int
-main ()
+void
+printCompactTable (ostream& out)
 {
-    cout.precision (9);
-    cout.setf (ios_base::hex, ios_base::basefield);
+    out << "{\n    ";
+
+    for (int i = 0; i < 2048; i++)
+    {
+        out << "0x" << setfill ('0') << setw (8) << compactMantissa (i)
+            << ", ";
+
+        if (i % 8 == 7)
+        {
+            out << "\n";
+
+            if (i < 2047) out << "    ";
+        }
+    }
+
+    out << "};\n";
+}
 
-    cout << "//\n"
-            "// This is an automatically generated file.\n"
-            "// Do not edit.\n"
-            "//\n\n";
+//---------------------------------------------
+// Print the full table
+//---------------------------------------------
 
-    cout << "{\n    ";
+void
+printTable (ostream& out)
+{
+    out << "{\n    ";
 
     const int iMax = (1 << 16);
 
     for (int i = 0; i < iMax; i++)
     {
-        cout << "{0x" << setfill ('0') << setw (8) << halfToFloat (i) << "}, ";
+        out << "{0x" << setfill ('0') << setw (8) << halfToFloat (i) << "}, ";
 
         if (i % 4 == 3)
         {
-            cout << "\n";
+            out << "\n";
+
+            if (i < iMax - 1) out << "    ";
+        }
+    }
+
+    out << "};\n";
+}
+
+//---------------------------------------------
+// Main - prints the half-to-float lookup table,
+// or with --compact, the compact lookup table
+//---------------------------------------------
+
+int
+main (int argc, char* argv[])
+{
+    bool compact = false;
 
-            if (i < iMax - 1) cout << "    ";
+    if (argc > 1 && string (argv[1]) == "--compact")
+    {
+        compact = true;
+        --argc;
+        ++argv;
+    }
+
+    ofstream file;
+
+    if (argc > 1)
+    {
+        file.open (argv[1]);
+
+        if (!file)
+        {
+            cerr << "toFloat: cannot open " << argv[1] << " for writing\n";
+            return 1;
         }
     }
 
-    cout << "};\n";
-    return 0;
+    ostream& out = file.is_open () ? file : cout;
+
+    out.precision (9);
+    out.setf (ios_base::hex, ios_base::basefield);
+
+    out << "//\n"
+           "// SPDX-License-Identifier: BSD-3-Clause\n"
+           "// Copyright Contributors to the OpenEXR Project.\n"
+           "//\n\n"
+           "//\n"
+           "// This is an automatically generated file.\n"
+           "// Do not edit.\n"
+           "//\n\n"
+           "// clang-format off\n";
+
+    if (compact)
+        printCompactTable (out);
+    else
+        printTable (out);
+
+    out << "// clang-format on\n";
+
+    return out ? 0 : 1;
 }
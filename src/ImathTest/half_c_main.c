@@ -21,7 +21,7 @@ typedef union
 } c_half_uif;
 
 static const c_half_uif half_to_float[1 << 16] =
-#include "../Imath/toFloat.h"
+#include "toFloat.h"
 
     static const unsigned short half_eLut[1 << 9] =
 #include "eLut.h"
@@ -3,399 +3,447 @@
 // Copyright Contributors to the OpenEXR Project.
 //
 
-#ifdef _WIN32
-#    define _CRT_RAND_S
-#endif
+//---------------------------------------------------------------------------
+//
+//	Benchmarks for half <-> float conversion.
+//
+//	Every conversion path is timed on several distributions of
+//	input values. Each benchmark is run a number of times after some
+//	untimed warmup runs, and the per-value times are summarized as
+//	minimum, median, mean, standard deviation and maximum. The
+//	results can also be written as JSON, for comparison between
+//	builds or library versions:
+//
+//	    ImathHalfPerfTest [options] [count]
+//
+//	    --count n       values per run (default 6220800, 1080p RGB)
+//	    --repeats n     timed runs per benchmark (default 10)
+//	    --warmup n      untimed runs per benchmark (default 2)
+//	    --filter str    run only benchmarks whose name contains str
+//	    --json file     write the results to file, or stdout for "-"
+//
+//	The minimum is the most repeatable figure on a busy machine; the
+//	spread between minimum and median shows how noisy the run was.
+//
+//---------------------------------------------------------------------------
 
 #include <ImathConfig.h>
 #include <ImathRandom.h>
 #include <half.h>
 
-#include <limits.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#ifdef _WIN32
-#    include <windows.h>
-#else
-#    include <time.h>
-#endif
+#include <string>
+#include <vector>
 
-#include <memory>
+using namespace IMATH_NAMESPACE;
+using namespace std;
 
-    using namespace IMATH_NAMESPACE;
+namespace
+{
 
-#ifdef IMATH_USE_HALF_LOOKUP_TABLE
+//
+// Input distributions. Each fills the half and float inputs with
+// values of one kind; the float inputs convert to the same kind of
+// half.
+//
 
-static const unsigned short imath_float_half_exp_table[1 << 9] =
-#include "eLut.h"
+struct Distribution
+{
+    const char* name;
+    uint16_t (*next) (Rand48&);
+};
 
-static inline float
-table_half_cast (const half& h)
+uint16_t
+nextNormal (Rand48& r)
 {
-    return imath_half_to_float_table[h.bits ()].f;
+    // exponent 1 to 30
+    return uint16_t (
+        (r.nexti () & 0x8000) | ((1 + r.nexti () % 30) << 10) |
+        (r.nexti () & 0x3ff));
 }
 
-//-----------------------------------------------
-// Overflow handler for float-to-half conversion;
-// generates a hardware floating-point overflow,
-// which may be trapped by the operating system.
-//-----------------------------------------------
+uint16_t
+nextDenormal (Rand48& r)
+{
+    return uint16_t ((r.nexti () & 0x8000) | (1 + r.nexti () % 0x3ff));
+}
 
-static float
-half_overflow ()
+uint16_t
+nextInfinity (Rand48& r)
 {
-    float f = 1e10;
+    return uint16_t ((r.nexti () & 0x8000) | 0x7c00);
+}
 
-    for (int i = 0; i < 10; i++)
-        f *= f; // this will overflow before the for loop terminates
+uint16_t
+nextNan (Rand48& r)
+{
+    return uint16_t ((r.nexti () & 0x8000) | 0x7c00 | (1 + r.nexti () % 0x3ff));
+}
 
-    return f;
+uint16_t
+nextMixed (Rand48& r)
+{
+    return uint16_t (r.nexti ());
 }
 
-//-----------------------------------------------------
-// Float-to-half conversion -- general case, including
-// zeroes, denormalized numbers and exponent overflows.
-//-----------------------------------------------------
+const Distribution distributions[] = {
+    {"normal", nextNormal},
+    {"denormal", nextDenormal},
+    {"inf", nextInfinity},
+    {"nan", nextNan},
+    {"mixed", nextMixed}};
 
-static uint16_t
-long_convert (int i)
+//
+// Conversion paths. Each converts n values from the input buffers
+// to the output buffers.
+//
+
+struct Buffers
 {
-    //
-    // Our floating point number, f, is represented by the bit
-    // pattern in integer i.  Disassemble that bit pattern into
-    // the sign, s, the exponent, e, and the significand, m.
-    // Shift s into the position where it will go in in the
-    // resulting half number.
-    // Adjust e, accounting for the different exponent bias
-    // of float and half (127 versus 15).
-    //
-
-    int s = (i >> 16) & 0x00008000;
-    int e = ((i >> 23) & 0x000000ff) - (127 - 15);
-    int m = i & 0x007fffff;
-
-    //
-    // Now reassemble s, e and m into a half:
-    //
-
-    if (e <= 0)
-    {
-        if (e < -10)
-        {
-            //
-            // E is less than -10.  The absolute value of f is
-            // less than HALF_DENORM_MIN (f may be a small normalized
-            // float, a denormalized float or a zero).
-            //
-            // We convert f to a half zero with the same sign as f.
-            //
+    vector<uint16_t> halfs;
+    vector<float>    floats;
+    vector<uint16_t> halfOut;
+    vector<float>    floatOut;
+};
 
-            return s;
-        }
+void
+halfToFloatScalar (Buffers& b)
+{
+    const uint16_t* src = b.halfs.data ();
+    float*          dst = b.floatOut.data ();
+    size_t          n   = b.halfs.size ();
+
+    for (size_t i = 0; i < n; ++i)
+        dst[i] = imath_half_to_float (src[i]);
+}
 
-        //
-        // E is between -10 and 0.  F is a normalized float
-        // whose magnitude is less than HALF_NRM_MIN.
-        //
-        // We convert f to a denormalized half.
-        //
+#if !defined(IMATH_HALF_NO_LOOKUP_TABLE)
 
-        //
-        // Add an explicit leading 1 to the significand.
-        //
+void
+halfToFloatTable (Buffers& b)
+{
+    const imath_half_uif_t* table = imath_half_to_float_table;
+    const uint16_t*         src   = b.halfs.data ();
+    float*                  dst   = b.floatOut.data ();
+    size_t                  n     = b.halfs.size ();
 
-        m = m | 0x00800000;
+    for (size_t i = 0; i < n; ++i)
+        dst[i] = table[src[i]].f;
+}
 
-        //
-        // Round to m to the nearest (10+e)-bit value (with e between
-        // -10 and 0); in case of a tie, round to the nearest even value.
-        //
-        // Rounding may cause the significand to overflow and make
-        // our number normalized.  Because of the way a half's bits
-        // are laid out, we don't have to treat this case separately;
-        // the code below will handle it correctly.
-        //
+//
+// The compact table, independent of which table the build selected
+//
 
-        int t = 14 - e;
-        int a = (1 << (t - 1)) - 1;
-        int b = (m >> t) & 1;
+void
+halfToFloatCompactTable (Buffers& b)
+{
+    const uint16_t* src = b.halfs.data ();
+    float*          dst = b.floatOut.data ();
+    size_t          n   = b.halfs.size ();
 
-        m = (m + a + b) >> t;
+    for (size_t i = 0; i < n; ++i)
+        dst[i] = imath_half_to_float_compact (src[i]);
+}
 
-        //
-        // Assemble the half from s, e (zero) and m.
-        //
+#endif
 
-        return s | m;
-    }
-    else if (e == 0xff - (127 - 15))
-    {
-        if (m == 0)
-        {
-            //
-            // F is an infinity; convert f to a half
-            // infinity with the same sign as f.
-            //
+void
+halfToFloatBulk (Buffers& b)
+{
+    imath_half_to_float_array (
+        b.halfs.data (), b.floatOut.data (), b.halfs.size ());
+}
 
-            return s | 0x7c00;
-        }
-        else
-        {
-            //
-            // F is a NAN; we produce a half NAN that preserves
-            // the sign bit and the 10 leftmost bits of the
-            // significand of f, with one exception: If the 10
-            // leftmost bits are all zero, the NAN would turn
-            // into an infinity, so we have to set at least one
-            // bit in the significand.
-            //
+void
+floatToHalfScalar (Buffers& b)
+{
+    const float* src = b.floats.data ();
+    uint16_t*    dst = b.halfOut.data ();
+    size_t       n   = b.floats.size ();
 
-            m >>= 13;
-            return s | 0x7c00 | m | (m == 0);
-        }
-    }
-    else
-    {
-        //
-        // E is greater than zero.  F is a normalized float.
-        // We try to convert f to a normalized half.
-        //
+    for (size_t i = 0; i < n; ++i)
+        dst[i] = imath_float_to_half (src[i]);
+}
 
-        //
-        // Round to m to the nearest 10-bit value.  In case of
-        // a tie, round to the nearest even value.
-        //
+void
+floatToHalfBulk (Buffers& b)
+{
+    imath_float_to_half_array (
+        b.floats.data (), b.halfOut.data (), b.floats.size ());
+}
 
-        m = m + 0x00000fff + ((m >> 13) & 1);
+struct Benchmark
+{
+    const char* name;
+    void (*run) (Buffers&);
+};
+
+const Benchmark benchmarks[] = {
+    {"half_to_float/scalar", halfToFloatScalar},
+#if !defined(IMATH_HALF_NO_LOOKUP_TABLE)
+    {"half_to_float/table", halfToFloatTable},
+    {"half_to_float/compact_table", halfToFloatCompactTable},
+#endif
+    {"half_to_float/bulk", halfToFloatBulk},
+    {"float_to_half/scalar", floatToHalfScalar},
+    {"float_to_half/bulk", floatToHalfBulk}};
 
-        if (m & 0x00800000)
-        {
-            m = 0;  // overflow in significand,
-            e += 1; // adjust exponent
-        }
+struct Options
+{
+    size_t count   = 1920 * 1080 * 3;
+    int    repeats = 10;
+    int    warmup  = 2;
+    string filter;
+    string json;
+};
+
+struct Summary
+{
+    string benchmark;
+    string distribution;
+    double min, median, mean, stddev, max; // ns per value
+};
+
+Summary
+summarize (
+    const char* benchmark, const char* distribution, vector<double> samples)
+{
+    Summary s;
+    s.benchmark    = benchmark;
+    s.distribution = distribution;
 
-        //
-        // Handle exponent overflow
-        //
+    sort (samples.begin (), samples.end ());
 
-        if (e > 30)
-        {
-            half_overflow ();  // Cause a hardware floating point overflow;
-            return s | 0x7c00; // if this returns, the half becomes an
-        }                      // infinity with the same sign as f.
+    size_t n = samples.size ();
+    s.min    = samples.front ();
+    s.max    = samples.back ();
+    s.median = (n % 2) ? samples[n / 2]
+                       : (samples[n / 2 - 1] + samples[n / 2]) / 2;
 
-        //
-        // Assemble the half from s, e and m.
-        //
+    double sum = 0;
+    for (double x: samples)
+        sum += x;
+    s.mean = sum / n;
 
-        return s | (e << 10) | (m >> 13);
-    }
+    double var = 0;
+    for (double x: samples)
+        var += (x - s.mean) * (x - s.mean);
+    s.stddev = n > 1 ? sqrt (var / (n - 1)) : 0;
+
+    return s;
 }
 
-static inline half
-exptable_half_constructor (float f)
+Summary
+run (const Benchmark& bm, const Distribution& dist, Buffers& b, const Options& o)
 {
-    half           ret;
-    imath_half_uif x;
+    for (int i = 0; i < o.warmup; ++i)
+        bm.run (b);
 
-    x.f = f;
+    vector<double> samples;
 
-    if (f == 0)
+    for (int i = 0; i < o.repeats; ++i)
     {
-        //
-        // Common special case - zero.
-        // Preserve the zero's sign bit.
-        //
+        auto start = chrono::steady_clock::now ();
+        bm.run (b);
+        auto end = chrono::steady_clock::now ();
 
-        ret.setBits ((x.i >> 16));
+        samples.push_back (
+            chrono::duration<double, nano> (end - start).count () /
+            double (o.count));
     }
-    else
-    {
-        //
-        // We extract the combined sign and exponent, e, from our
-        // floating-point number, f.  Then we convert e to the sign
-        // and exponent of the half number via a table lookup.
-        //
-        // For the most common case, where a normalized half is produced,
-        // the table lookup returns a non-zero value; in this case, all
-        // we have to do is round f's significand to 10 bits and combine
-        // the result with e.
-        //
-        // For all other cases (overflow, zeroes, denormalized numbers
-        // resulting from underflow, infinities and NANs), the table
-        // lookup returns zero, and we call a longer, non-inline function
-        // to do the float-to-half conversion.
-        //
-
-        int e = (x.i >> 23) & 0x000001ff;
-
-        e = imath_float_half_exp_table[e];
-
-        if (e)
-        {
-            //
-            // Simple case - round the significand, m, to 10
-            // bits and combine it with the sign and exponent.
-            //
 
-            int m = x.i & 0x007fffff;
-            ret.setBits (e + ((m + 0x00000fff + ((m >> 13) & 1)) >> 13));
-        }
-        else
-        {
-            //
-            // Difficult case - call a function.
-            //
+    return summarize (bm.name, dist.name, samples);
+}
 
-            ret.setBits (long_convert (x.i));
-        }
+void
+writeJson (ostream& os, const Options& o, const vector<Summary>& results)
+{
+    os << "{\n"
+       << "  \"version\": \"" << IMATH_VERSION_STRING << "\",\n"
+       << "  \"bulk_kernel\": \"" << imath_half_array_kernel () << "\",\n"
+       << "  \"count\": " << o.count << ",\n"
+       << "  \"repeats\": " << o.repeats << ",\n"
+       << "  \"warmup\": " << o.warmup << ",\n"
+       << "  \"unit\": \"ns_per_value\",\n"
+       << "  \"results\": [\n";
+
+    for (size_t i = 0; i < results.size (); ++i)
+    {
+        const Summary& s = results[i];
+        os << "    {\"benchmark\": \"" << s.benchmark << "\", "
+           << "\"distribution\": \"" << s.distribution << "\", "
+           << "\"min\": " << s.min << ", "
+           << "\"median\": " << s.median << ", "
+           << "\"mean\": " << s.mean << ", "
+           << "\"stddev\": " << s.stddev << ", "
+           << "\"max\": " << s.max << "}"
+           << (i + 1 < results.size () ? "," : "") << "\n";
     }
-    return ret;
+
+    os << "  ]\n}\n";
 }
-#else
-// provide a wrapping function for consistency/readability
-static inline float
-table_half_cast (const half& h)
+
+//
+// Parse arg as an integer of at least minimum
+//
+
+bool
+parseInteger (const char* arg, long minimum, long& value)
 {
-    return static_cast<float> (h);
+    char* end;
+    value = strtol (arg, &end, 10);
+    return *arg && !*end && value >= minimum;
 }
 
-static inline half
-exptable_half_constructor (float f)
+int
+usage (const char* program)
 {
-    return half{f};
+    fprintf (
+        stderr,
+        "usage: %s [--count n] [--repeats n] [--warmup n] "
+        "[--filter str] [--json file] [count]\n",
+        program);
+    return 1;
 }
 
-#endif
+} // namespace
 
-int64_t
-get_ticks (void)
+int
+main (int argc, char* argv[])
 {
-#ifdef _WIN32
-    static uint64_t scale = 0;
-    if (scale == 0)
-    {
-        LARGE_INTEGER freq;
-        QueryPerformanceFrequency (&freq);
-        scale = (1000000000 / freq.QuadPart);
-    }
-
-    LARGE_INTEGER ticks;
-    QueryPerformanceCounter (&ticks);
-    return ticks.QuadPart * scale;
-#else
-    struct timespec t;
-    uint64_t        nsecs;
+    Options o;
 
-    static uint64_t start = 0;
-    if (start == 0)
+    for (int i = 1; i < argc; ++i)
     {
-        clock_gettime (CLOCK_MONOTONIC, &t);
-        start = t.tv_sec;
-    }
+        string arg = argv[i];
+        long   value;
 
-    clock_gettime (CLOCK_MONOTONIC, &t);
-    nsecs = (t.tv_sec - start) * 1000000000;
-    nsecs += t.tv_nsec;
-    return nsecs;
-#endif
-}
+        if (arg == "--count" || arg == "--repeats" || arg == "--warmup")
+        {
+            //
+            // Warmup runs are optional; the others need at least one
+            //
 
-void
-perf_test_half_to_float (float* floats, const uint16_t* halfs, int numentries)
-{
-    const half* halfvals = reinterpret_cast<const half*> (halfs);
+            const long minimum = arg == "--warmup" ? 0 : 1;
 
-    int64_t st = get_ticks ();
-    for (int i = 0; i < numentries; ++i)
-        floats[i] = imath_half_to_float (halfs[i]);
-    int64_t et = get_ticks ();
+            if (i + 1 >= argc || !parseInteger (argv[i + 1], minimum, value))
+                return usage (argv[0]);
 
-    int64_t ost = get_ticks ();
-    for (int i = 0; i < numentries; ++i)
-        floats[i] = table_half_cast (halfvals[i]);
-    int64_t oet = get_ticks ();
+            if (arg == "--count")
+                o.count = size_t (value);
+            else if (arg == "--repeats")
+                o.repeats = int (value);
+            else
+                o.warmup = int (value);
+
+            ++i;
+        }
+        else if (arg == "--filter" || arg == "--json")
+        {
+            if (i + 1 >= argc) return usage (argv[0]);
+            (arg == "--filter" ? o.filter : o.json) = argv[++i];
+        }
+        else if (parseInteger (argv[i], 1, value))
+        {
+            o.count = size_t (value);
+        }
+        else
+        {
+            fprintf (stderr, "Bad argument '%s'\n", argv[i]);
+            return usage (argv[0]);
+        }
+    }
 
-    int64_t onanos = (oet - ost);
-    int64_t nnanos = (et - st);
     fprintf (
         stderr,
-        "half -> float Old: %10lld (%g ns) New: %10lld (%g ns) (%10lld)\n",
-        (long long) onanos,
-        (double) onanos / ((double) numentries),
-        (long long) nnanos,
-        (double) nnanos / ((double) numentries),
-        ((long long) (onanos - nnanos)));
-}
+        "Imath %s, bulk kernel %s, %zu values, %d runs after %d warmup\n",
+        IMATH_VERSION_STRING,
+        imath_half_array_kernel (),
+        o.count,
+        o.repeats,
+        o.warmup);
 
-void
-perf_test_float_to_half (uint16_t* halfs, const float* floats, int numentries)
-{
-    half* halfvals = reinterpret_cast<half*> (halfs);
-
-    int64_t st = get_ticks ();
-    for (int i = 0; i < numentries; ++i)
-        halfs[i] = imath_float_to_half (floats[i]);
-    int64_t et = get_ticks ();
-
-    int64_t ost = get_ticks ();
-    for (int i = 0; i < numentries; ++i)
-        halfvals[i] = exptable_half_constructor (floats[i]);
-    int64_t oet = get_ticks ();
-
-    int64_t onanos = (oet - ost);
-    int64_t nnanos = (et - st);
     fprintf (
         stderr,
-        "float -> half Old: %10lld (%g ns) New: %10lld (%g ns) (%10lld)\n",
-        (long long) onanos,
-        (double) onanos / ((double) numentries),
-        (long long) nnanos,
-        (double) nnanos / ((double) numentries),
-        ((long long) (onanos - nnanos)));
-}
-
-int
-main (int argc, char* argv[])
-{
-    int ret        = 0;
-    int numentries = 1920 * 1080 * 3;
-    if (argc > 1)
+        "%-28s %-9s %9s %9s %9s %9s %9s  (ns / value)\n",
+        "benchmark",
+        "input",
+        "min",
+        "median",
+        "mean",
+        "stddev",
+        "max");
+
+    vector<Summary> results;
+    Buffers         b;
+
+    b.halfs.resize (o.count);
+    b.floats.resize (o.count);
+    b.halfOut.resize (o.count);
+    b.floatOut.resize (o.count);
+
+    for (const Distribution& dist: distributions)
     {
-        numentries = atoi (argv[1]);
+        Rand48 r (o.count);
+
+        for (size_t i = 0; i < o.count; ++i)
+        {
+            b.halfs[i] = dist.next (r);
+
+            //
+            // Floats that are not exactly representable as halfs, so
+            // that float-to-half conversion has to round, except for
+            // infinities and NANs, which do not round.
+            //
+
+            float f = imath_half_to_float (dist.next (r));
+            if (isfinite (f)) f *= float (1.0 + r.nextf (0.0, 1.0 / 1024));
+            b.floats[i] = f;
+        }
 
-        if (numentries <= 0)
+        for (const Benchmark& bm: benchmarks)
         {
-            fprintf (stderr, "Bad entry count '%s'\n", argv[1]);
-            ret = 1;
+            string name = string (bm.name) + "/" + dist.name;
+            if (name.find (o.filter) == string::npos) continue;
+
+            Summary s = run (bm, dist, b, o);
+            results.push_back (s);
+
+            fprintf (
+                stderr,
+                "%-28s %-9s %9.3f %9.3f %9.3f %9.3f %9.3f\n",
+                s.benchmark.c_str (),
+                s.distribution.c_str (),
+                s.min,
+                s.median,
+                s.mean,
+                s.stddev,
+                s.max);
         }
     }
 
-    if (numentries > 0)
+    if (o.json == "-")
+        writeJson (cout, o, results);
+    else if (!o.json.empty ())
     {
-        uint16_t* halfs  = new uint16_t[numentries];
-        float*    floats = new float[numentries];
+        ofstream file (o.json.c_str ());
 
-        if (halfs && floats)
+        if (!file)
         {
-            Rand48 r(numentries);
-            for (int i = 0; i < numentries; ++i)
-            {
-                halfs[i]  = (uint16_t) r.nexti();
-                floats[i] = imath_half_to_float (halfs[i]);
-            }
-            perf_test_half_to_float (floats, halfs, numentries);
-
-            // test float -> half with real-world values
-            for (int i = 0; i < numentries; ++i)
-                floats[i] = float(r.nextf(-65504, 65504));
-            perf_test_float_to_half (halfs, floats, numentries);
+            fprintf (stderr, "Cannot write '%s'\n", o.json.c_str ());
+            return 1;
         }
 
-        delete[] halfs;
-        delete[] floats;
+        writeJson (file, o, results);
     }
 
-    return ret;
+    return 0;
 }
@@ -7,12 +7,15 @@
 #    undef NDEBUG
 #endif
 
+#include "testAffine.h"
 #include "testArithmetic.h"
+#include "testBfloat16.h"
 #include "testBitPatterns.h"
 #include "testBox.h"
 #include "testBoxAlgo.h"
 #include "testClassification.h"
 #include "testColor.h"
+#include "testDualQuat.h"
 #include "testError.h"
 #include "testExtractEuler.h"
 #include "testExtractSHRT.h"
@@ -20,6 +23,7 @@
 #include "testFrustumTest.h"
 #include "testFun.h"
 #include "testFunction.h"
+#include "testHalfArray.h"
 #include "testInterop.h"
 #include "testNoInterop.h"
 #include "testInterval.h"
@@ -28,17 +32,20 @@
 #include "testLimits.h"
 #include "testLineAlgo.h"
 #include "testMatrix.h"
+#include "testMatrixExpr.h"
 #include "testMiscMatrixAlgo.h"
 #include "testProcrustes.h"
 #include "testQuat.h"
 #include "testQuatSetRotation.h"
 #include "testQuatSlerp.h"
+#include "testQuatTrack.h"
 #include "testRandom.h"
 #include "testRoots.h"
 #include "testShear.h"
 #include "testSize.h"
 #include "testTinySVD.h"
 #include "testToFloat.h"
+#include "testTransformHierarchy.h"
 #include "testVec.h"
 
 #include <iostream>
@@ -63,10 +70,15 @@ main (int argc, char* argv[])
     TEST (testLimits);
     TEST (testHalfLimits);
     TEST (testFunction);
+    TEST (testHalfArray);
+    TEST (testBfloat16);
     TEST (testVec);
     TEST (testColor);
     TEST (testShear);
     TEST (testMatrix);
+    TEST (testAffine);
+    TEST (testMatrixExpr);
+    TEST (testTransformHierarchy);
     TEST (testMiscMatrixAlgo);
     TEST (testRoots);
     TEST (testFun);
@@ -79,6 +91,8 @@ main (int argc, char* argv[])
     TEST (testQuat);
     TEST (testQuatSetRotation);
     TEST (testQuatSlerp);
+    TEST (testQuatTrack);
+    TEST (testDualQuat);
     TEST (testLineAlgo);
     TEST (testBoxAlgo);
     TEST (testBox);
@@ -0,0 +1,217 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "testAffine.h"
+#include <ImathAffine.h>
+#include <ImathBoxAlgo.h>
+#include <ImathMatrix.h>
+#include <ImathRandom.h>
+#include <ImathVec.h>
+#include <assert.h>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+// Include ImathForward *after* other headers to validate forward declarations
+#include <ImathForward.h>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+template <class T>
+Affine3<T>
+randomAffine (Rand32& rand)
+{
+    Affine3<T> a (UNINITIALIZED);
+
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 3; ++j)
+            a[i][j] = T (rand.nextf (-2, 2));
+
+    return a;
+}
+
+template <class T>
+void
+testConstruction ()
+{
+    Affine3<T> a;
+
+    assert (a.toMatrix44 () == Matrix44<T> ());
+    assert (a.linear () == Matrix33<T> ());
+    assert (a.translation () == Vec3<T> (0));
+
+    Matrix33<T> l (1, 2, 3, 4, 5, 6, 7, 8, 9);
+    Vec3<T>     t (10, 11, 12);
+    Affine3<T>  b (l, t);
+
+    assert (b.linear () == l);
+    assert (b.translation () == t);
+    assert (b.toMatrix44 () == Matrix44<T> (l, t));
+    assert (Affine3<T> (b.toMatrix44 ()) == b);
+    assert (b != a);
+
+    Affine3<T> c;
+    c.setLinear (l);
+    c.setTranslation (t);
+    assert (c == b);
+
+    c.makeIdentity ();
+    assert (c == a);
+
+    assert (Affine3<T> (Affine3<double> (b)) == b);
+    assert (b.getValue ()[3] == 4 && b.getValue ()[11] == 12);
+
+    //
+    // The last column of a Matrix44 is ignored.
+    //
+
+    Matrix44<T> m (l, t);
+    m[0][3] = 5;
+    assert (Affine3<T> (m) == b);
+}
+
+//
+// Every operation must give the same result as the corresponding
+// Matrix44 operation on the equivalent matrix.
+//
+
+template <class T>
+void
+testAgainstMatrix44 (Rand32& rand)
+{
+    for (int i = 0; i < 1000; ++i)
+    {
+        Affine3<T> a = randomAffine<T> (rand);
+        Affine3<T> b = randomAffine<T> (rand);
+
+        Matrix44<T> ma = a.toMatrix44 ();
+        Matrix44<T> mb = b.toMatrix44 ();
+
+        assert ((a * b).toMatrix44 () == ma * mb);
+
+        Affine3<T> c = a;
+        c *= b;
+        assert (c == a * b);
+
+        assert (a.inverse ().toMatrix44 () == ma.inverse ());
+        assert (a.inverse (true).toMatrix44 () == ma.inverse (true));
+
+        c = a;
+        c.invert ();
+        assert (c.toMatrix44 () == ma.inverse ());
+
+        assert (a.determinant () == ma.determinant ());
+
+        Vec3<T> v (rand.nextf (-10, 10), rand.nextf (-10, 10), rand.nextf (-10, 10));
+        Vec3<T> r1, r2;
+
+        a.multVecMatrix (v, r1);
+        ma.multVecMatrix (v, r2);
+        assert (r1 == r2);
+        assert (v * a == r2);
+
+        Vec3<T> w = v;
+        w *= a;
+        assert (w == r2);
+
+        a.multDirMatrix (v, r1);
+        ma.multDirMatrix (v, r2);
+        assert (r1 == r2);
+
+        c = a;
+        c.scale (v);
+        assert (c.toMatrix44 () == Matrix44<T> (ma).scale (v));
+
+        c = a;
+        c.translate (v);
+        assert (c.toMatrix44 () == Matrix44<T> (ma).translate (v));
+    }
+}
+
+template <class T>
+void
+testSingular ()
+{
+    Affine3<T> s (Matrix33<T> (1, 2, 3, 2, 4, 6, 0, 0, 1), Vec3<T> (1, 2, 3));
+
+    assert (s.inverse () == Affine3<T> ());
+
+    try
+    {
+        s.inverse (true);
+        assert (false);
+    }
+    catch (std::invalid_argument&)
+    {}
+}
+
+template <class T>
+void
+testBoxTransform (Rand32& rand)
+{
+    for (int i = 0; i < 100; ++i)
+    {
+        Affine3<T> a = randomAffine<T> (rand);
+
+        Box<Vec3<T>> box (
+            Vec3<T> (rand.nextf (-5, 0), rand.nextf (-5, 0), rand.nextf (-5, 0)),
+            Vec3<T> (rand.nextf (0, 5), rand.nextf (0, 5), rand.nextf (0, 5)));
+
+        Box<Vec3<T>> expected = affineTransform (box, a.toMatrix44 ());
+
+        assert (transform (box, a) == expected);
+
+        Box<Vec3<T>> result;
+        transform (box, a, result);
+        assert (result == expected);
+    }
+
+    Box<Vec3<T>> empty;
+    assert (transform (empty, Affine3<T> ()).isEmpty ());
+
+    Box<Vec3<T>> result;
+    transform (empty, Affine3<T> (), result);
+    assert (result.isEmpty ());
+
+    Box<Vec3<T>> infinite;
+    infinite.makeInfinite ();
+    assert (transform (infinite, Affine3<T> ()).isInfinite ());
+}
+
+} // namespace
+
+void
+testAffine ()
+{
+    cout << "Testing Affine3" << endl;
+
+    assert (sizeof (Affine3f) == 12 * sizeof (float));
+    assert (sizeof (Affine3d) == 12 * sizeof (double));
+
+    Rand32 rand (11);
+
+    testConstruction<float> ();
+    testConstruction<double> ();
+    testAgainstMatrix44<float> (rand);
+    testAgainstMatrix44<double> (rand);
+    testSingular<float> ();
+    testSingular<double> ();
+    testBoxTransform<float> (rand);
+    testBoxTransform<double> (rand);
+
+    ostringstream s;
+    s << Affine3f ();
+    assert (!s.str ().empty ());
+
+    cout << "ok\n" << endl;
+}
@@ -0,0 +1,333 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "testBfloat16.h"
+#include <ImathColor.h>
+#include <ImathRandom.h>
+#include <ImathVec.h>
+#include <assert.h>
+#include <bfloat16.h>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string.h>
+#include <vector>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+uint32_t
+floatBits (float f)
+{
+    uint32_t i;
+    memcpy (&i, &f, sizeof (i));
+    return i;
+}
+
+float
+bitsFloat (uint32_t i)
+{
+    float f;
+    memcpy (&f, &i, sizeof (f));
+    return f;
+}
+
+//
+// Round to nearest even by comparing the distances to the two
+// neighbouring bfloat16 values in double precision.
+//
+
+uint16_t
+referenceRound (float f)
+{
+    uint32_t i = floatBits (f);
+
+    if (isnan (f)) return uint16_t ((i >> 16) | 0x40);
+
+    uint16_t lo = uint16_t (i >> 16);
+    uint16_t hi = uint16_t (lo + 1);
+
+    if ((i & 0xffff) == 0) return lo;
+
+    if ((hi & 0x7fff) == 0x7f80)
+    {
+        // The upper neighbour is infinity: round to it when f is at
+        // least halfway to the next (unrepresentable) value.
+        return (i & 0xffff) >= 0x8000 ? hi : lo;
+    }
+
+    double dlo = fabs (double (f) - double (bitsFloat (uint32_t (lo) << 16)));
+    double dhi = fabs (double (f) - double (bitsFloat (uint32_t (hi) << 16)));
+
+    if (dlo < dhi) return lo;
+    if (dhi < dlo) return hi;
+    return (lo & 1) ? hi : lo;
+}
+
+//
+// The half conversion kernels may return a signalling NAN as a
+// quiet one.
+//
+
+bool
+sameHalf (imath_half_bits_t a, imath_half_bits_t b)
+{
+    if ((a & 0x7c00) == 0x7c00 && (a & 0x3ff) && (b & 0x7c00) == 0x7c00 &&
+        (b & 0x3ff))
+        return (a & 0x8000) == (b & 0x8000);
+
+    return a == b;
+}
+
+void
+testScalar ()
+{
+    cout << "  scalar conversion\n";
+
+    // Every bfloat16 survives a round trip through float
+
+    for (uint32_t b = 0; b < (1 << 16); ++b)
+    {
+        float f = imath_bfloat16_to_float (uint16_t (b));
+        assert (floatBits (f) == b << 16);
+
+        uint16_t r = imath_float_to_bfloat16 (f);
+
+        if (isnan (f))
+            assert (r == (b | 0x40));
+        else
+            assert (r == b);
+    }
+
+    // Rounding of values between bfloat16s
+
+    Rand32 rand (0);
+
+    for (int i = 0; i < 1000000; ++i)
+    {
+        float f = bitsFloat (rand.nexti ());
+        assert (imath_float_to_bfloat16 (f) == referenceRound (f));
+    }
+
+    const float edges[] = {
+        1.0f + 1.0f / 256,            // tie, rounds down to even
+        1.0f + 3.0f / 256,            // tie, rounds up to even
+        bitsFloat (0x3f808001),       // just above a tie
+        bitsFloat (0x7f7f8000),       // tie above BFLOAT16_MAX
+        bitsFloat (0x7f7f7fff),       // just below it
+        numeric_limits<float>::max (),
+        numeric_limits<float>::denorm_min (),
+        -numeric_limits<float>::infinity (),
+        bitsFloat (0x7f800001),       // signalling NAN
+        bitsFloat (0xffc00000)};
+
+    for (float f: edges)
+        assert (imath_float_to_bfloat16 (f) == referenceRound (f));
+
+    assert (imath_float_to_bfloat16 (BFLOAT16_MAX) == 0x7f7f);
+    assert (imath_float_to_bfloat16 (bitsFloat (0x7f7f8000)) == 0x7f80);
+}
+
+void
+testClass ()
+{
+    cout << "  class bfloat16\n";
+
+    bfloat16 a (3.0f);
+    assert (a.bits () == 0x4040);
+    assert (float (a) == 3.0f);
+    assert ((-a).bits () == 0xc040);
+
+    // Like half, bfloat16 is also available in the global namespace
+    ::bfloat16 g (a);
+    assert (g.bits () == a.bits ());
+
+    a += 1.0f;
+    assert (a == 4.0f);
+    a *= bfloat16 (0.5f);
+    assert (a == 2.0f);
+    a /= 4.0f;
+    assert (a == 0.5f);
+    a -= bfloat16 (1.0f);
+    assert (a == -0.5f);
+    assert (a.isNegative () && a.isNormalized ());
+
+    assert (bfloat16 (1.0f + BFLOAT16_EPSILON) != bfloat16 (1.0f));
+    assert (bfloat16 (1.0f + BFLOAT16_EPSILON / 2) == bfloat16 (1.0f));
+
+    bfloat16 d (bfloat16::FromBits, 0x0001);
+    assert (d.isDenormalized () && d.isFinite () && !d.isZero ());
+    assert (float (d) == BFLOAT16_DENORM_MIN);
+
+    assert (bfloat16::posInf ().isInfinity ());
+    assert (!bfloat16::posInf ().isNegative ());
+    assert (bfloat16::negInf ().isInfinity ());
+    assert (bfloat16::negInf ().isNegative ());
+    assert (bfloat16::qNan ().isNan ());
+    assert (bfloat16::sNan ().isNan ());
+    assert (!bfloat16::qNan ().isFinite ());
+    assert (bfloat16 (-0.0f).isZero ());
+
+    // round
+
+    bfloat16 r (bfloat16::FromBits, 0x3fff); // 1.9921875
+    assert (r.round (7).bits () == 0x3fff);
+    assert (r.round (3).bits () == 0x4000);
+    assert (r.round (0).bits () == 0x4000);
+    assert (bfloat16 (bfloat16::FromBits, 0x7f7f).round (0).bits () == 0x7f00);
+
+    // limits
+
+    typedef numeric_limits<bfloat16> limits;
+    assert (limits::is_specialized);
+    assert (float (limits::max ()) == BFLOAT16_MAX);
+    assert (float (limits::lowest ()) == -BFLOAT16_MAX);
+    assert (float (limits::min ()) == BFLOAT16_MIN);
+    assert (float (limits::min ()) == numeric_limits<float>::min ());
+    assert (float (limits::epsilon ()) == BFLOAT16_EPSILON);
+    assert (float (limits::round_error ()) == 0.5f);
+    assert (float (limits::denorm_min ()) == BFLOAT16_DENORM_MIN);
+    assert (limits::infinity ().bits () == bfloat16::posInf ().bits ());
+    assert (limits::quiet_NaN ().bits () == bfloat16::qNan ().bits ());
+    assert (limits::signaling_NaN ().bits () == bfloat16::sNan ().bits ());
+    assert (limits::digits == 8);
+    assert (limits::max_exponent == numeric_limits<float>::max_exponent);
+
+    // i/o
+
+    stringstream s;
+    s << bfloat16 (-1.5f);
+    bfloat16 in;
+    s >> in;
+    assert (in == -1.5f);
+
+    // vectors and colors
+
+    V3bf v (3, 0, 4);
+    assert (v.length () == 5);
+    v.normalize ();
+    assert (v == V3bf (0.6f, 0, 0.8f));
+
+    V2bf v2 (1, 2);
+    V4bf v4 (1, 2, 3, 4);
+    assert (v2.dot (v2) == 5 && v4.dot (v4) == 30);
+
+    C3bf c (0.5f, 0.25f, 1);
+    C4bf c4 (c.x, c.y, c.z, 1);
+    assert (c * 2.0f == Color3bf (1, 0.5f, 2));
+    assert (c4.a == 1);
+}
+
+void
+testArrays ()
+{
+    cout << "  array conversion\n";
+
+    const size_t n = 1 << 16;
+
+    vector<uint16_t> bits (n + 1);
+    vector<float>    f (n + 1), expected (n + 1);
+    vector<uint16_t> b (n + 1), h (n + 1);
+
+    for (size_t i = 0; i < n; ++i)
+        bits[i] = uint16_t (i);
+
+    // bfloat16 to float, every value, at an odd offset
+
+    f[n] = -1.0f;
+    imath_bfloat16_to_float_array (&bits[0], &f[1], n - 1);
+
+    for (size_t i = 0; i + 1 < n; ++i)
+        assert (floatBits (f[i + 1]) == uint32_t (bits[i]) << 16);
+
+    assert (f[n] == -1.0f);
+
+    // float to bfloat16, random floats and special values
+
+    Rand32 rand (1);
+
+    for (size_t i = 0; i < n; ++i)
+        f[i] = bitsFloat (rand.nexti ());
+
+    f[3]  = bitsFloat (0x7f800001);
+    f[4]  = bitsFloat (0x7f7f8000);
+    f[5]  = -numeric_limits<float>::infinity ();
+    f[6]  = 1.0f + 1.0f / 256;
+    f[7]  = -0.0f;
+    f[10] = bitsFloat (0xffc00000);
+
+    for (size_t len = 0; len < 40; ++len)
+    {
+        for (size_t offset = 0; offset < 3; ++offset)
+        {
+            fill (b.begin (), b.end (), 0xdead);
+            imath_float_to_bfloat16_array (&f[offset], &b[0], len);
+
+            for (size_t i = 0; i < len; ++i)
+                assert (b[i] == imath_float_to_bfloat16 (f[offset + i]));
+
+            assert (b[len] == 0xdead);
+        }
+    }
+
+    imath_float_to_bfloat16_array (&f[0], &b[0], n);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (b[i] == imath_float_to_bfloat16 (f[i]));
+
+    // half to bfloat16 and back, every value, in uneven lengths that
+    // straddle the internal blocks
+
+    const size_t lengths[] = {0, 1, 255, 256, 257, 1000, n};
+
+    for (size_t len: lengths)
+    {
+        fill (b.begin (), b.end (), 0xdead);
+        imath_half_to_bfloat16_array (&bits[0], &b[0], len);
+
+        for (size_t i = 0; i < len; ++i)
+        {
+            uint16_t e = imath_float_to_bfloat16 (imath_half_to_float (bits[i]));
+
+            if ((e & 0x7fff) > 0x7f80)
+                assert ((b[i] & 0x7fff) > 0x7f80 && (b[i] ^ e) < 0x8000);
+            else
+                assert (b[i] == e);
+        }
+
+        assert (b[len] == 0xdead);
+
+        fill (h.begin (), h.end (), 0xdead);
+        imath_bfloat16_to_half_array (&bits[0], &h[0], len);
+
+        for (size_t i = 0; i < len; ++i)
+            assert (sameHalf (
+                h[i], imath_float_to_half (imath_bfloat16_to_float (bits[i]))));
+
+        assert (h[len] == 0xdead);
+    }
+}
+
+} // namespace
+
+void
+testBfloat16 ()
+{
+    cout << "Testing bfloat16\n";
+
+    testScalar ();
+    testClass ();
+    testArrays ();
+
+    cout << "ok\n\n" << flush;
+}
@@ -0,0 +1,358 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "testDualQuat.h"
+#include "testHelpers.h"
+#include <ImathDualQuat.h>
+#include <ImathMatrix.h>
+#include <ImathQuat.h>
+#include <ImathRandom.h>
+#include <assert.h>
+#include <iostream>
+#include <limits>
+
+// Include ImathForward *after* other headers to validate forward declarations
+#include <ImathForward.h>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+template <class T>
+DualQuat<T>
+randomDualQuat (Rand48& rand)
+{
+    Vec3<T> t (rand.nextf (-10, 10), rand.nextf (-10, 10), rand.nextf (-10, 10));
+    return DualQuat<T> (randomQuat<T> (rand), t);
+}
+
+template <class T>
+bool
+equalWithAbsError (const Matrix44<T>& a, const Matrix44<T>& b, T e)
+{
+    return a.equalWithAbsError (b, e);
+}
+
+template <class T>
+bool
+equalWithAbsError (const Quat<T>& a, const Quat<T>& b, T e)
+{
+    return IMATH_INTERNAL_NAMESPACE::equalWithAbsError (a.r, b.r, e) &&
+           a.v.equalWithAbsError (b.v, e);
+}
+
+template <class T>
+bool
+equalWithAbsError (const DualQuat<T>& a, const DualQuat<T>& b, T e)
+{
+    return a.toMatrix44 ().equalWithAbsError (b.toMatrix44 (), e);
+}
+
+template <class T>
+void
+testConstruction (Rand48& rand)
+{
+    const T e = 1000 * numeric_limits<T>::epsilon ();
+
+    DualQuat<T> id;
+    assert (id == DualQuat<T>::identity ());
+    assert (id.toMatrix44 () == Matrix44<T> ());
+    assert (id.translation () == Vec3<T> (0));
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        Quat<T>     r = randomQuat<T> (rand);
+        Vec3<T>     t (
+            rand.nextf (-10, 10), rand.nextf (-10, 10), rand.nextf (-10, 10));
+        DualQuat<T> dq (r, t);
+
+        assert (dq.rotation () == r);
+        assert (dq.translation ().equalWithAbsError (t, e));
+
+        //
+        // The matrix rotates, then translates
+        //
+
+        Matrix44<T> m = r.toMatrix44 ();
+        m[3][0] = t.x;
+        m[3][1] = t.y;
+        m[3][2] = t.z;
+
+        assert (equalWithAbsError (dq.toMatrix44 (), m, e));
+
+        //
+        // Round trip through the matrix, up to the sign
+        //
+
+        DualQuat<T> dq2 (m);
+
+        if ((dq2.real ^ dq.real) < 0) dq2 = -dq2;
+
+        assert (equalWithAbsError (dq2.real, dq.real, e));
+        assert (equalWithAbsError (dq2.dual, dq.dual, e));
+
+        //
+        // Points and directions
+        //
+
+        Vec3<T> p (rand.nextf (-10, 10), rand.nextf (-10, 10), rand.nextf (-10, 10));
+
+        assert (dq.transformPoint (p).equalWithAbsError (p * m, e));
+        assert ((p * dq).equalWithAbsError (p * m, e));
+
+        Vec3<T> d;
+        m.multDirMatrix (p, d);
+        assert (dq.transformDirection (p).equalWithAbsError (d, e));
+    }
+}
+
+template <class T>
+void
+testAlgebra (Rand48& rand)
+{
+    const T e = 1000 * numeric_limits<T>::epsilon ();
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        DualQuat<T> a = randomDualQuat<T> (rand);
+        DualQuat<T> b = randomDualQuat<T> (rand);
+
+        //
+        // a * b applies b first, as with Quat
+        //
+
+        DualQuat<T> ab = a * b;
+        assert (equalWithAbsError (
+            ab.toMatrix44 (), b.toMatrix44 () * a.toMatrix44 (), e));
+
+        DualQuat<T> c = a;
+        c *= b;
+        assert (c == ab);
+
+        //
+        // The product of unit dual quaternions is a unit dual
+        // quaternion
+        //
+
+        assert (equalWithAbsError (ab.normalized (), ab, e));
+
+        //
+        // Inverse and conjugate
+        //
+
+        assert (equalWithAbsError (a * a.inverse (), DualQuat<T> (), e));
+        assert (equalWithAbsError (a.inverse () * a, DualQuat<T> (), e));
+        assert (equalWithAbsError (a.conjugate (), a.inverse (), e));
+        assert (equalWithAbsError (
+            a.inverse ().toMatrix44 (), a.toMatrix44 ().inverse (), e));
+
+        //
+        // Scaling and perturbation are removed by normalize ()
+        //
+
+        DualQuat<T> s = a * T (3);
+        s.dual += T (0.01) * s.real;
+        assert (equalWithAbsError (s.normalized (), a, T (10) * e));
+        assert (abs ((s.normalized ().real ^ s.normalized ().dual)) < e);
+
+        assert (-a + a == DualQuat<T> (Quat<T> (0, 0, 0, 0), Quat<T> (0, 0, 0, 0)));
+        assert (a - a == -a + a);
+        assert (a != b);
+    }
+
+    //
+    // A zero real part is left alone
+    //
+
+    DualQuat<T> z (Quat<T> (0, 0, 0, 0), Quat<T> (1, 2, 3, 4));
+    assert (z.normalized () == z);
+}
+
+template <class T>
+void
+testSclerp (Rand48& rand)
+{
+    const T e = 10000 * numeric_limits<T>::epsilon ();
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        DualQuat<T> a = randomDualQuat<T> (rand);
+        DualQuat<T> b = randomDualQuat<T> (rand);
+
+        //
+        // The end points
+        //
+
+        assert (equalWithAbsError (sclerp (a, b, T (0)), a, e));
+        assert (equalWithAbsError (sclerp (a, b, T (1)), b, e));
+
+        //
+        // The rotation is that of slerpShortestArc (), and the result
+        // is a unit dual quaternion
+        //
+
+        T           t = rand.nextf (0, 1);
+        DualQuat<T> s = sclerp (a, b, t);
+
+        Quat<T> r = slerpShortestArc (a.real, b.real, t);
+        if ((r ^ s.real) < 0) r = -r;
+
+        assert (equalWithAbsError (s.real, r, e));
+        assert (equalWithAbsError (s.normalized (), s, e));
+
+        //
+        // Constant rate: the half-way point of the first half is the
+        // quarter point
+        //
+
+        DualQuat<T> h = sclerp (a, b, T (0.5));
+        assert (equalWithAbsError (
+            sclerp (a, h, T (0.5)), sclerp (a, b, T (0.25)), e));
+
+        //
+        // With the same rotation, the translation is linear
+        //
+
+        DualQuat<T> c (a.real, b.translation ());
+        assert (sclerp (a, c, t).translation ().equalWithAbsError (
+            (1 - t) * a.translation () + t * c.translation (), e));
+
+        //
+        // Also with a rotation by a half turn
+        //
+
+        Quat<T> half;
+        half.setAxisAngle (hollowSphereRand<Vec3<T>> (rand), T (M_PI));
+        DualQuat<T> d (half * a.real, b.translation ());
+        assert (equalWithAbsError (sclerp (a, d, T (1)), d, e));
+    }
+}
+
+template <class T>
+void
+testBlend (Rand48& rand)
+{
+    const T e = 1000 * numeric_limits<T>::epsilon ();
+
+    assert (dlb ((const DualQuat<T>*) 0, (const T*) 0, 0) == DualQuat<T> ());
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        DualQuat<T> dq[4];
+        T           w[4];
+
+        for (int j = 0; j < 4; ++j)
+        {
+            dq[j] = randomDualQuat<T> (rand);
+            w[j]  = rand.nextf (0, 1);
+
+            if (rand.nextf () < 0.5) dq[j] = -dq[j];
+        }
+
+        //
+        // A single transformation, with any sign
+        //
+
+        assert (equalWithAbsError (dlb (dq, w, 1), dq[0], e));
+
+        //
+        // The blend is rigid
+        //
+
+        DualQuat<T> b = dlb (dq, w, 4);
+        assert (abs (b.real.length () - 1) < e);
+        assert (abs (b.real ^ b.dual) < e);
+
+        //
+        // Blending equal transformations, whatever their signs
+        //
+
+        DualQuat<T> same[3] = { dq[0], -dq[0], dq[0] };
+        assert (equalWithAbsError (dlb (same, w, 3), dq[0], e));
+
+        //
+        // Two transformations with equal weights blend to sclerp ()
+        // in rotation, when they are in the same hemisphere
+        //
+
+        DualQuat<T> pair[2] = { dq[0], dq[1] };
+        T           half[2] = { 1, 1 };
+
+        Quat<T> r = dlb (pair, half, 2).real;
+        Quat<T> s = sclerp (pair[0], pair[1], T (0.5)).real;
+        if ((r ^ s) < 0) s = -s;
+
+        assert (equalWithAbsError (r, s, T (10) * e));
+    }
+}
+
+template <class T>
+void
+testTransformPoints (Rand48& rand)
+{
+    const T e = 1000 * numeric_limits<T>::epsilon ();
+
+    const size_t        n = 100;
+    DualQuat<T>         dq[n];
+    Vec3<T>             src[n];
+    Vec3<T>             dst[n];
+    Vec3<T>             inPlace[n];
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        dq[i]  = randomDualQuat<T> (rand);
+        src[i] = Vec3<T> (
+            rand.nextf (-10, 10), rand.nextf (-10, 10), rand.nextf (-10, 10));
+        inPlace[i] = src[i];
+    }
+
+    dq[0].transformPoints (src, dst, n);
+    dq[0].transformPoints (inPlace, inPlace, n);
+
+    Matrix44<T> m = dq[0].toMatrix44 ();
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        assert (dst[i].equalWithAbsError (src[i] * m, e));
+        assert (inPlace[i] == dst[i]);
+    }
+
+    transformPoints (dq, src, dst, n);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (dst[i].equalWithAbsError (src[i] * dq[i].toMatrix44 (), e));
+}
+
+template <class T>
+void
+testDualQuatT ()
+{
+    Rand48 rand (17);
+
+    testConstruction<T> (rand);
+    testAlgebra<T> (rand);
+    testSclerp<T> (rand);
+    testBlend<T> (rand);
+    testTransformPoints<T> (rand);
+}
+
+} // namespace
+
+void
+testDualQuat ()
+{
+    cout << "Testing dual quaternions" << endl;
+
+    testDualQuatT<float> ();
+    testDualQuatT<double> ();
+
+    cout << "ok\n" << endl;
+}
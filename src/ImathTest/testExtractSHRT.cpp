@@ -15,7 +15,10 @@
 #include <assert.h>
 #include <exception>
 #include <iostream>
+#include <limits>
 #include <stdio.h>
+#include <string.h>
+#include <vector>
 
 #if 0
 #    define debug(x) (printf x, fflush (stdout))
@@ -369,6 +372,243 @@ testAngles44 (V3f angles)
     testMatrix (M);
 }
 
+//
+// Compare bit patterns, so that NANs compare equal to themselves
+//
+
+template <class T>
+bool
+identical (const Vec3<T>& a, const Vec3<T>& b)
+{
+    return memcmp (&a, &b, sizeof (a)) == 0;
+}
+
+template <class T>
+Matrix44<T>
+randomSHRT (Rand48& random)
+{
+    Matrix44<T> M;
+
+    M.translate (Vec3<T> (
+        T (random.nextf (-10, 10)),
+        T (random.nextf (-10, 10)),
+        T (random.nextf (-10, 10))));
+
+    M.rotate (Vec3<T> (
+        T (random.nextf (-3, 3)),
+        T (random.nextf (-3, 3)),
+        T (random.nextf (-3, 3))));
+
+    M.shear (Vec3<T> (
+        T (random.nextf (-2, 2)),
+        T (random.nextf (-2, 2)),
+        T (random.nextf (-2, 2))));
+
+    Vec3<T> s (
+        T (random.nextf (0.001, 2.0)),
+        T (random.nextf (0.001, 2.0)),
+        T (random.nextf (0.001, 2.0)));
+
+    for (int j = 0; j < 3; j++)
+        if (random.nextf (0.0, 1.0) >= 0.5) s[j] *= -1;
+
+    M.scale (s);
+
+    return M;
+}
+
+//
+// Matrices that take unusual paths through extractSHRT()
+//
+
+template <class T>
+Matrix44<T>
+specialMatrix (int kind, Rand48& random)
+{
+    Matrix44<T> M = randomSHRT<T> (random);
+
+    switch (kind)
+    {
+        case 0: // all zero
+            for (int i = 0; i < 3; ++i)
+                for (int j = 0; j < 3; ++j)
+                    M[i][j] = 0;
+            break;
+
+        case 1: // a zero row
+            M[1][0] = M[1][1] = M[1][2] = 0;
+            break;
+
+        case 2: // two equal rows
+            M[2][0] = M[0][0];
+            M[2][1] = M[0][1];
+            M[2][2] = M[0][2];
+            break;
+
+        case 3: // tiny scale in one row
+            M[0][0] *= T (1e-30);
+            M[0][1] *= T (1e-30);
+            M[0][2] *= T (1e-30);
+            break;
+
+        case 4: // tiny everywhere
+            for (int i = 0; i < 3; ++i)
+                for (int j = 0; j < 3; ++j)
+                    M[i][j] *= std::numeric_limits<T>::min ();
+            break;
+
+        case 5: // NAN
+            M[1][2] = std::numeric_limits<T>::quiet_NaN ();
+            break;
+
+        case 6: // huge
+            for (int i = 0; i < 3; ++i)
+                for (int j = 0; j < 3; ++j)
+                    M[i][j] *= std::numeric_limits<T>::max () / 4;
+            break;
+
+        default: // a rotation by multiples of 90 degrees
+            M.makeIdentity ();
+            M.rotate (Vec3<T> (
+                T (M_PI / 2) * T (random.nexti () % 4),
+                T (M_PI / 2) * T (random.nexti () % 4),
+                T (M_PI / 2) * T (random.nexti () % 4)));
+            break;
+    }
+
+    return M;
+}
+
+template <class T>
+void
+testArrays ()
+{
+    Rand48 random (17);
+
+    const typename Euler<T>::Order orders[] = {
+        Euler<T>::XYZ, Euler<T>::ZXY, Euler<T>::YXZr};
+
+    for (size_t n = 0; n < 50; ++n)
+    {
+        std::vector<Matrix44<T>> M (n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (random.nextf () < 0.3)
+                M[i] = specialMatrix<T> (int (random.nexti () % 8), random);
+            else
+                M[i] = randomSHRT<T> (random);
+        }
+
+        for (typename Euler<T>::Order order: orders)
+        {
+            std::vector<Vec3<T>> s (n + 1), h (n + 1), r (n + 1), t (n + 1);
+
+            //
+            // The element after the last must be left alone.
+            //
+
+            const Vec3<T> sentinel (T (7), T (8), T (9));
+            s[n] = h[n] = r[n] = t[n] = sentinel;
+
+            bool   flags[64];
+            size_t count = extractSHRTArray (
+                M.data (),
+                s.data (),
+                h.data (),
+                r.data (),
+                t.data (),
+                n,
+                flags,
+                order);
+
+            size_t expected = 0;
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                Vec3<T> s1, h1, r1, t1;
+                bool    ok = extractSHRT (M[i], s1, h1, r1, t1, false, order);
+
+                assert (flags[i] == !ok);
+                expected += !ok;
+
+                assert (identical (
+                    t[i], Vec3<T> (M[i][3][0], M[i][3][1], M[i][3][2])));
+
+                if (ok)
+                {
+                    assert (identical (s[i], s1));
+                    assert (identical (h[i], h1));
+                    assert (identical (r[i], r1));
+                }
+                else
+                {
+                    assert (s[i] == Vec3<T> (0));
+                    assert (h[i] == Vec3<T> (0));
+                    assert (r[i] == Vec3<T> (0));
+                }
+            }
+
+            assert (count == expected);
+            assert (s[n] == sentinel && h[n] == sentinel);
+            assert (r[n] == sentinel && t[n] == sentinel);
+
+            //
+            // Without flags
+            //
+
+            std::vector<Vec3<T>> s2 (n), h2 (n), r2 (n), t2 (n);
+
+            assert (
+                extractSHRTArray (
+                    M.data (),
+                    s2.data (),
+                    h2.data (),
+                    r2.data (),
+                    t2.data (),
+                    n,
+                    0,
+                    order) == count);
+
+            for (size_t i = 0; i < n; ++i)
+                assert (identical (r2[i], r[i]));
+        }
+
+        //
+        // Scale and shear only, and rotation only
+        //
+
+        std::vector<Vec3<T>> s (n), h (n), r (n);
+        bool                 flags[64];
+
+        size_t count = extractScalingAndShearArray (
+            M.data (), s.data (), h.data (), n, flags);
+        size_t expected = 0;
+
+        extractEulerXYZArray (M.data (), r.data (), n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            Vec3<T> s1, h1, r1;
+            bool    ok = extractScalingAndShear (M[i], s1, h1, false);
+
+            assert (flags[i] == !ok);
+            expected += !ok;
+
+            if (ok)
+            {
+                assert (identical (s[i], s1));
+                assert (identical (h[i], h1));
+            }
+
+            extractEulerXYZ (M[i], r1);
+            assert (identical (r[i], r1));
+        }
+
+        assert (count == expected);
+    }
+}
+
 void
 test ()
 {
@@ -391,6 +631,10 @@ test ()
         for (int j = 0; j < 360; j += 90)
             for (int k = 0; k < 360; k += 90)
                 testAngles44 (V3f (float(i), float(j), float(k)));
+
+    cout << "  arrays" << endl;
+    testArrays<float> ();
+    testArrays<double> ();
 }
 
 } // namespace
@@ -8,9 +8,13 @@
 #endif
 
 #include "testFunction.h"
+#include "testHelpers.h"
 #include "halfFunction.h"
 #include <assert.h>
+#include <cmath>
+#include <functional>
 #include <iostream>
+#include <vector>
 
 using namespace std;
 
@@ -30,6 +34,240 @@ struct timesN
     float n;
 };
 
+void
+testApply ()
+{
+    cout << "  apply\n";
+
+    halfFunction<float> d2 (divideByTwo, -HALF_MAX, HALF_MAX, 7, 8, 9, 10);
+    halfFunction<half>  t5 (timesN (5), 0, HALF_MAX / 8, -1, 1, 2, 3);
+
+    const size_t  n = 1 << 16;
+    vector<half>  in (n + 1);
+    vector<float> fout (n + 1, -1.0f);
+    vector<half>  hout (n + 1, half (-1.0f));
+
+    for (size_t i = 0; i < n; ++i)
+        in[i].setBits (static_cast<unsigned short> (i));
+
+    //
+    // Every half value, starting at an odd offset to check unaligned
+    // arrays and a non-multiple-of-8 length.
+    //
+
+    d2.apply (&in[1], &fout[1], n - 1);
+    t5.apply (&in[1], &hout[1], n - 1);
+
+    assert (fout[0] == -1.0f && hout[0] == half (-1.0f));
+
+    for (size_t i = 1; i < n; ++i)
+    {
+        assert (fout[i] == d2 (in[i]) || (isnan (fout[i]) && isnan (d2 (in[i]))));
+        assert (hout[i].bits () == t5 (in[i]).bits ());
+    }
+
+    assert (fout[n] == -1.0f && hout[n] == half (-1.0f));
+
+    // in place
+
+    t5.apply (&in[0], n);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (in[i].bits () == t5 (half (half::FromBits, i)).bits ());
+}
+
+bool
+same (float a, float b)
+{
+    return a == b || (isnan (a) && isnan (b));
+}
+
+void
+testExecutor ()
+{
+    cout << "  executor\n";
+
+    halfFunction<float> a (divideByTwo, -1, 2, 7, 8, 9, 10);
+    halfFunction<float> b (divideByTwo, reverseChunks (4099), -1, 2, 7, 8, 9, 10);
+
+    for (int i = 0; i < (1 << 16); ++i)
+    {
+        half x (half::FromBits, uint16_t (i));
+        assert (same (a (x), b (x)));
+    }
+
+    //
+    // Array evaluation through an executor gives the same results as
+    // without one.
+    //
+
+    halfFunction<half> t5 (timesN (5), 0, HALF_MAX / 8, -1, 1, 2, 3);
+
+    const size_t  n = 1 << 16;
+    vector<half>  in (n);
+    vector<float> fout (n), fref (n);
+    vector<half>  hout (n), href (n);
+
+    for (size_t i = 0; i < n; ++i)
+        in[i].setBits (static_cast<unsigned short> (i));
+
+    a.apply (in.data (), fref.data (), n);
+    a.apply (in.data (), fout.data (), n, reverseChunks (4099));
+    t5.apply (in.data (), href.data (), n);
+    t5.apply (in.data (), hout.data (), n, reverseChunks (4099));
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        assert (same (fout[i], fref[i]));
+        assert (hout[i].bits () == href[i].bits ());
+    }
+
+    t5.apply (in.data (), n, reverseChunks (4099));
+
+    for (size_t i = 0; i < n; ++i)
+        assert (in[i].bits () == href[i].bits ());
+}
+
+void
+testCompact ()
+{
+    cout << "  compact\n";
+
+    const half domains[][2] = {
+        {-HALF_MAX, HALF_MAX},
+        {0, 1},
+        {-1, 2},
+        {half (-0.0f), half (-0.0f)},
+        {-3, -0.5f},
+        {2, 1}};
+
+    for (const auto& d: domains)
+    {
+        halfFunction<float>        full (divideByTwo, d[0], d[1], 7, 8, 9, 10);
+        halfFunctionCompact<float> c1 (divideByTwo, d[0], d[1], 7, 8, 9, 10);
+        halfFunctionCompact<float> c2 (
+            divideByTwo, reverseChunks (4099), d[0], d[1], 7, 8, 9, 10);
+
+        vector<half>  in (1 << 16);
+        vector<float> out (1 << 16);
+
+        size_t inDomain = 0;
+
+        for (int i = 0; i < (1 << 16); ++i)
+        {
+            half x (half::FromBits, uint16_t (i));
+            in[i] = x;
+
+            assert (same (full (x), c1 (x)));
+            assert (same (full (x), c2 (x)));
+
+            if (x.isFinite () && !(x < d[0] || x > d[1])) ++inDomain;
+        }
+
+        assert (c1.size () == inDomain);
+
+        c1.apply (in.data (), out.data (), in.size ());
+
+        for (size_t i = 0; i < in.size (); ++i)
+            assert (same (out[i], full (in[i])));
+    }
+
+    // [0, 1] holds 0x0000 - 0x3c00 and -0
+
+    halfFunctionCompact<float> unit (divideByTwo, 0, 1);
+    assert (unit.size () == 0x3c02);
+}
+
+struct counted
+{
+    counted (int* calls) : calls (calls) {}
+    float operator() (float x)
+    {
+        ++*calls;
+        return x / 2;
+    }
+    int* calls;
+};
+
+void
+testShared ()
+{
+    cout << "  shared\n";
+
+    int calls = 0;
+
+    auto a = sharedHalfFunction<halfFunction<float>> (
+        "testShared divideByTwo", counted (&calls), -1, 2, 7, 8, 9, 10);
+
+    int built = calls;
+    assert (built > 0);
+
+    auto b = sharedHalfFunction<halfFunction<float>> (
+        "testShared divideByTwo", counted (&calls), -1, 2, 7, 8, 9, 10);
+
+    assert (a == b);
+    assert (calls == built);
+
+    halfFunction<float> ref (divideByTwo, -1, 2, 7, 8, 9, 10);
+
+    for (int i = 0; i < (1 << 16); ++i)
+    {
+        half x (half::FromBits, uint16_t (i));
+        assert (same ((*a) (x), ref (x)));
+    }
+
+    // The same key with a different table type is a different entry
+
+    auto c = sharedHalfFunction<halfFunctionCompact<float>> (
+        "testShared divideByTwo", counted (&calls), -1, 2, 7, 8, 9, 10);
+
+    assert (calls > built);
+    assert (c->size () < (1 << 16));
+    assert (same ((*c) (half (1.5f)), 0.75f));
+
+    //
+    // Erasing a key removes its tables of every type, and only those;
+    // the tables stay valid while they are referenced.
+    //
+
+    auto e = sharedHalfFunction<halfFunction<float>> (
+        "testShared divideByTwo other", counted (&calls), -1, 2, 7, 8, 9, 10);
+
+    built = calls;
+
+    halfFunctionRegistryErase ("testShared divideByTwo");
+
+    assert (same ((*a) (half (1.5f)), 0.75f));
+    assert (same ((*c) (half (1.5f)), 0.75f));
+
+    auto f = sharedHalfFunction<halfFunction<float>> (
+        "testShared divideByTwo", counted (&calls), -1, 2, 7, 8, 9, 10);
+
+    assert (f != a);
+    assert (calls > built);
+    assert (same ((*f) (half (1.5f)), 0.75f));
+
+    built = calls;
+
+    auto g = sharedHalfFunction<halfFunction<float>> (
+        "testShared divideByTwo other", counted (&calls), -1, 2, 7, 8, 9, 10);
+
+    assert (g == e);
+    assert (calls == built);
+
+    halfFunctionRegistryErase ("testShared no such key");
+
+    halfFunctionRegistryClear ();
+
+    auto d = sharedHalfFunction<halfFunction<float>> (
+        "testShared divideByTwo", counted (&calls), -1, 2, 7, 8, 9, 10);
+
+    assert (d != a && d != f);
+    assert (same ((*d) (half (1.5f)), 0.75f));
+
+    halfFunctionRegistryClear ();
+}
+
 } // namespace
 
 void
@@ -71,5 +309,10 @@ testFunction ()
 
     assert (t5 (half::qNan ()).isNan ());
 
+    testApply ();
+    testExecutor ();
+    testCompact ();
+    testShared ();
+
     cout << "ok\n\n" << flush;
 }
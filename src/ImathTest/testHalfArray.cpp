@@ -0,0 +1,339 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "testHalfArray.h"
+#include <ImathRandom.h>
+#include <algorithm>
+#include <assert.h>
+#include <half.h>
+#include <cmath>
+#include <iostream>
+#include <string.h>
+#include <vector>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+uint32_t
+floatBits (float f)
+{
+    uint32_t i;
+    memcpy (&i, &f, sizeof (i));
+    return i;
+}
+
+float
+bitsFloat (uint32_t i)
+{
+    float f;
+    memcpy (&f, &i, sizeof (f));
+    return f;
+}
+
+//
+// The SIMD kernels may return a signalling NAN as a quiet one, so
+// NANs only need to agree in sign and significand, ignoring the
+// quiet bit. A float NAN whose significand has no bits that survive
+// in a half is the one exception: the bit-shift conversion sets the
+// lowest bit of the half to keep it a NAN, where the hardware sets
+// the quiet bit alone.
+//
+
+bool
+sameFloat (float a, float b)
+{
+    uint32_t ia = floatBits (a);
+    uint32_t ib = floatBits (b);
+
+    if (isnan (a) && isnan (b))
+        return (ia | 0x00400000) == (ib | 0x00400000);
+
+    return ia == ib;
+}
+
+bool
+sameHalf (imath_half_bits_t a, imath_half_bits_t b)
+{
+    half ha (half::FromBits, a);
+    half hb (half::FromBits, b);
+
+    if (ha.isNan () && hb.isNan ())
+    {
+        if ((a | 0x0200) == (b | 0x0200)) return true;
+
+        imath_half_bits_t q = (a & 0x03ff) == 0x0200 ? a : b;
+        imath_half_bits_t l = q == a ? b : a;
+
+        return (q & 0x83ff) == ((l & 0x8000) | 0x0200) &&
+               (l & 0x03ff) == 0x0001;
+    }
+
+    return a == b;
+}
+
+void
+testHalfToFloatArray ()
+{
+    cout << "  half -> float" << endl;
+
+    //
+    // Every half bit pattern, converted in runs of various lengths
+    // and offsets so that both the vector body and the scalar tail
+    // of each kernel are exercised.
+    //
+
+    vector<imath_half_bits_t> h (1 << 16);
+    for (size_t i = 0; i < h.size (); ++i)
+        h[i] = static_cast<imath_half_bits_t> (i);
+
+    vector<float> f (h.size ());
+
+    const size_t lengths[] = {0, 1, 7, 8, 9, 15, 16, 17, 31, 33, 1 << 16};
+
+    for (size_t offset = 0; offset < 3; ++offset)
+    {
+        for (size_t len: lengths)
+        {
+            size_t n = len - (len > offset ? offset : len);
+            fill (f.begin (), f.end (), -1.0f);
+
+            imath_half_to_float_array (&h[offset], &f[offset], n);
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                float e = imath_half_to_float (h[offset + i]);
+                assert (sameFloat (f[offset + i], e));
+            }
+
+            if (offset + n < f.size ()) assert (f[offset + n] == -1.0f);
+        }
+    }
+}
+
+void
+testFloatToHalfArray ()
+{
+    cout << "  float -> half" << endl;
+
+    vector<float> f;
+
+    //
+    // Every half value, and the floats on either side of it, which
+    // covers the round-to-nearest-even ties and the overflow and
+    // underflow boundaries.
+    //
+
+    for (uint32_t i = 0; i < (1 << 16); ++i)
+    {
+        uint32_t b = floatBits (imath_half_to_float (uint16_t (i)));
+        f.push_back (bitsFloat (b));
+        f.push_back (bitsFloat (b + 1));
+        f.push_back (bitsFloat (b - 1));
+        f.push_back (bitsFloat (b + 0x1000));
+    }
+
+    //
+    // Random bit patterns, including float denormals, infinities
+    // and NANs.
+    //
+
+    Rand32 r (17);
+    for (int i = 0; i < 1 << 18; ++i)
+        f.push_back (bitsFloat (uint32_t (r.nexti ())));
+
+    vector<imath_half_bits_t> h (f.size ());
+
+    for (size_t offset = 0; offset < 3; ++offset)
+    {
+        size_t n = f.size () - offset;
+        imath_float_to_half_array (&f[offset], &h[offset], n);
+
+        for (size_t i = 0; i < n; ++i)
+            assert (sameHalf (
+                h[offset + i], imath_float_to_half (f[offset + i])));
+    }
+}
+
+//
+// The expected result of each arithmetic kernel, computed one
+// element at a time.
+//
+
+enum ArithmeticOp
+{
+    ADD,
+    MUL,
+    FMA,
+    LERP,
+    MIN,
+    MAX,
+    CLAMP
+};
+
+imath_half_bits_t
+expected (ArithmeticOp op, imath_half_bits_t ha, imath_half_bits_t hb, imath_half_bits_t hc)
+{
+    float a = imath_half_to_float (ha);
+    float b = imath_half_to_float (hb);
+    float c = imath_half_to_float (hc);
+    float r = 0;
+
+    switch (op)
+    {
+        case ADD: r = a + b; break;
+        case MUL: r = a * b; break;
+        case FMA: r = fmaf (a, b, c); break;
+        case LERP: r = fmaf (c, b - a, a); break;
+        case MIN: r = std::min (a, b); break;
+        case MAX: r = std::max (a, b); break;
+        case CLAMP: r = (a < -0.5f) ? -0.5f : ((a > 1.0f) ? 1.0f : a); break;
+    }
+
+    return imath_float_to_half (r);
+}
+
+//
+// When both operands are NANs, either may be returned.
+//
+
+bool
+sameResult (imath_half_bits_t a, imath_half_bits_t b)
+{
+    if (half (half::FromBits, a).isNan () && half (half::FromBits, b).isNan ())
+        return true;
+
+    return a == b;
+}
+
+void
+apply (
+    ArithmeticOp             op,
+    const imath_half_bits_t* a,
+    const imath_half_bits_t* b,
+    const imath_half_bits_t* c,
+    imath_half_bits_t*       dst,
+    size_t                   n)
+{
+    switch (op)
+    {
+        case ADD: imath_half_add_array (a, b, dst, n); break;
+        case MUL: imath_half_mul_array (a, b, dst, n); break;
+        case FMA: imath_half_fma_array (a, b, c, dst, n); break;
+        case LERP: imath_half_lerp_array (a, b, c, dst, n); break;
+        case MIN: imath_half_min_array (a, b, dst, n); break;
+        case MAX: imath_half_max_array (a, b, dst, n); break;
+        case CLAMP:
+            imath_half_clamp_array (
+                a,
+                imath_float_to_half (-0.5f),
+                imath_float_to_half (1.0f),
+                dst,
+                n);
+            break;
+    }
+}
+
+void
+testArithmeticArrays ()
+{
+    cout << "  arithmetic" << endl;
+
+    //
+    // Random operands over all bit patterns, plus runs of
+    // interesting values, including signed zeros, infinities, NANs
+    // and results that overflow or underflow half.
+    //
+
+    const size_t              n = 1 << 16;
+    vector<imath_half_bits_t> a (n), b (n), c (n), dst (n), in (n);
+
+    Rand32 r (5);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        a[i] = uint16_t (r.nexti ());
+        b[i] = uint16_t (r.nexti ());
+        c[i] = uint16_t (r.nexti ());
+    }
+
+    const float special[] = {
+        0.0f, -0.0f, 1.0f, -1.0f, 0.5f, 65504.0f, -65504.0f, 6.0e-8f,
+        INFINITY, -INFINITY, NAN, 300.0f, 1.0e-4f, 2.0f, -0.25f, 1000.0f};
+
+    for (size_t i = 0; i < 16; ++i)
+        for (size_t j = 0; j < 16; ++j)
+        {
+            a[i * 16 + j] = imath_float_to_half (special[i]);
+            b[i * 16 + j] = imath_float_to_half (special[j]);
+            c[i * 16 + j] = imath_float_to_half (special[(i + j) % 16]);
+        }
+
+    const ArithmeticOp ops[]     = {ADD, MUL, FMA, LERP, MIN, MAX, CLAMP};
+    const size_t       lengths[] = {0, 1, 7, 8, 9, 15, 16, 17, 33, n - 3};
+
+    for (ArithmeticOp op: ops)
+    {
+        for (size_t len: lengths)
+        {
+            for (size_t offset = 0; offset < 3; ++offset)
+            {
+                fill (dst.begin (), dst.end (), 0xdead);
+
+                apply (op, &a[offset], &b[offset], &c[offset], &dst[0], len);
+
+                for (size_t i = 0; i < len; ++i)
+                {
+                    imath_half_bits_t e = expected (
+                        op, a[offset + i], b[offset + i], c[offset + i]);
+                    assert (sameResult (dst[i], e));
+                }
+
+                assert (dst[len] == 0xdead);
+            }
+        }
+
+        // in place
+
+        in = a;
+        apply (op, &in[0], &b[0], &c[0], &in[0], n);
+
+        for (size_t i = 0; i < n; ++i)
+            assert (sameResult (in[i], expected (op, a[i], b[i], c[i])));
+    }
+
+    //
+    // min and max follow std::min and std::max for signed zeros:
+    // they return the first operand when the two compare equal.
+    //
+
+    imath_half_bits_t pz = 0x0000, nz = 0x8000, out;
+
+    imath_half_min_array (&pz, &nz, &out, 1);
+    assert (out == pz);
+    imath_half_max_array (&nz, &pz, &out, 1);
+    assert (out == nz);
+}
+
+} // namespace
+
+void
+testHalfArray ()
+{
+    cout << "Testing half array conversion (" << imath_half_array_kernel ()
+         << ")" << endl;
+
+    testHalfToFloatArray ();
+    testFloatToHalfArray ();
+    testArithmeticArrays ();
+
+    cout << "ok\n" << endl;
+}
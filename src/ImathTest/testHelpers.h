@@ -0,0 +1,91 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+//
+// Helpers shared by the tests of the array and parallel functions
+//
+
+#ifndef INCLUDED_IMATH_TEST_HELPERS_H
+#define INCLUDED_IMATH_TEST_HELPERS_H
+
+#include <ImathMatrix.h>
+#include <ImathPlatform.h>
+#include <ImathQuat.h>
+#include <ImathRandom.h>
+#include <cstddef>
+#include <functional>
+
+//
+// An executor that calls the body on chunks of the range, last chunk
+// first, to check that the result does not depend on how the work is
+// split or in which order the chunks run.
+//
+
+struct reverseChunks
+{
+    explicit reverseChunks (int c) : chunk (c) {}
+
+    void operator() (
+        int begin, int end, const std::function<void (int, int)>& body) const
+    {
+        for (int e = end; e > begin; e -= chunk)
+            body (e - chunk > begin ? e - chunk : begin, e);
+    }
+
+    int chunk;
+};
+
+//
+// The array sizes to test: every size up to 40, which covers whole
+// and partial groups of the widest SIMD registers, and then 1000.
+// Iterate with
+//
+//     for (size_t n = 0; n <= maxArraySize; n = nextArraySize (n))
+//
+
+const size_t maxArraySize = 1000;
+
+inline size_t
+nextArraySize (size_t n)
+{
+    return n < 40 || n >= maxArraySize ? n + 1 : maxArraySize;
+}
+
+//
+// A rotation about a random axis by a random angle in [-pi, pi]
+//
+
+template <class T>
+IMATH_INTERNAL_NAMESPACE::Quat<T>
+randomQuat (IMATH_INTERNAL_NAMESPACE::Rand48& rand)
+{
+    using namespace IMATH_INTERNAL_NAMESPACE;
+
+    Vec3<T> axis  = hollowSphereRand<Vec3<T>> (rand);
+    T       angle = T (rand.nextf (-M_PI, M_PI));
+
+    Quat<T> q;
+    q.setAxisAngle (axis, angle);
+    return q;
+}
+
+//
+// A matrix with elements in [-2, 2]
+//
+
+template <class T>
+IMATH_INTERNAL_NAMESPACE::Matrix44<T>
+randomMatrix (IMATH_INTERNAL_NAMESPACE::Rand32& rand)
+{
+    IMATH_INTERNAL_NAMESPACE::Matrix44<T> m;
+
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j)
+            m[i][j] = T (rand.nextf (-2, 2));
+
+    return m;
+}
+
+#endif
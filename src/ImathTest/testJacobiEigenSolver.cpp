@@ -7,8 +7,10 @@
 #    undef NDEBUG
 #endif
 
+#include "testHelpers.h"
 #include <ImathMatrix.h>
 #include <ImathMatrixAlgo.h>
+#include <ImathRandom.h>
 #include <algorithm>
 #include <cassert>
 #include <cmath>
@@ -16,6 +18,7 @@
 #include <iostream>
 #include <limits>
 #include <math.h>
+#include <vector>
 
 using namespace std;
 using namespace IMATH_INTERNAL_NAMESPACE;
@@ -258,6 +261,179 @@ testMinMaxEigenValueImp ()
     testMinMaxEigenValue (Matrix44<T> (A44_8));
 }
 
+template <class T>
+void
+verifyEigenArray (
+    const vector<Matrix33<T>>& A,
+    const vector<T>&           S,
+    const vector<T>&           V,
+    size_t                     stride,
+    T                          tolerance)
+{
+    for (size_t i = 0; i < A.size (); ++i)
+    {
+        Matrix33<T> MV, MS (T (0));
+
+        for (int j = 0; j < 3; ++j)
+        {
+            MS[j][j] = S[j * stride + i];
+
+            for (int k = 0; k < 3; ++k)
+                MV[j][k] = V[(3 * j + k) * stride + i];
+        }
+
+        const T threshold =
+            computeThreshold (Matrix33<T> (A[i])) * tolerance / 100;
+
+        verifyOrthonormal (MV, std::numeric_limits<T>::epsilon () * 100);
+        assert (MV.determinant () > 0);
+        assert (MS[0][0] >= MS[1][1] && MS[1][1] >= MS[2][2]);
+
+        const Matrix33<T> MA = MV * MS * MV.transposed ();
+
+        for (int j = 0; j < 3; ++j)
+            for (int k = 0; k < 3; ++k)
+                assert (std::abs (A[i][j][k] - MA[j][k]) < threshold);
+    }
+
+    //
+    // Entries past the end of the planes are untouched.
+    //
+
+    for (size_t k = 3 * stride; k < S.size (); ++k)
+        assert (S[k] == -1);
+
+    for (size_t k = 9 * stride; k < V.size (); ++k)
+        assert (V[k] == -1);
+}
+
+template <class T>
+void
+testEigenSolverArrays ()
+{
+    Rand48              rand (17);
+    vector<Matrix33<T>> matrices;
+
+    const Matrix33<double> special[] = {
+        A33_1, A33_2, A33_3, A33_4, A33_5, A33_6, A33_7, A33_8};
+
+    for (const Matrix33<double>& m: special)
+        matrices.push_back (Matrix33<T> (m));
+
+    //
+    // Repeated eigenvalues, in random orientations
+    //
+
+    for (int i = 0; i < 20; ++i)
+    {
+        const Vec3<T> axis =
+            Vec3<T> (rand.nextf (-1, 1), rand.nextf (-1, 1), 1).normalized ();
+        Matrix44<T> R44;
+        R44.setAxisAngle (axis, T (rand.nextf (-3, 3)));
+
+        Matrix33<T> R;
+
+        for (int j = 0; j < 3; ++j)
+            for (int k = 0; k < 3; ++k)
+                R[j][k] = R44[j][k];
+
+        const T     a = T (rand.nextf (-2, 2));
+        const T     b = i % 4 ? T (rand.nextf (-2, 2)) : a;
+        Matrix33<T> D (T (0));
+        D[0][0] = a;
+        D[1][1] = i % 2 ? a : b;
+        D[2][2] = i % 2 ? b : a;
+
+        Matrix33<T> m = R.transposed () * D * R;
+
+        for (int j = 0; j < 3; ++j)
+            for (int k = 0; k < j; ++k)
+                m[j][k] = m[k][j];
+
+        matrices.push_back (m);
+    }
+
+    //
+    // Random matrices, up to the largest array size
+    //
+
+    while (matrices.size () < maxArraySize)
+    {
+        Matrix33<T> m;
+
+        for (int j = 0; j < 3; ++j)
+            for (int k = j; k < 3; ++k)
+                m[j][k] = m[k][j] = T (rand.nextf (-1, 1));
+
+        matrices.push_back (m);
+    }
+
+    for (size_t n = 0; n <= maxArraySize; n = nextArraySize (n))
+    {
+        vector<Matrix33<T>> A (matrices.begin (), matrices.begin () + n);
+
+        const size_t stride = n + 3;
+
+        vector<T> S (3 * stride + 4, T (-1));
+        vector<T> V (9 * stride + 4, T (-1));
+
+        jacobiEigenSolverArray (A.data (), S.data (), V.data (), n, stride);
+        verifyEigenArray (A, S, V, stride, T (100));
+
+        vector<T> S1 (3 * stride + 4, T (-1));
+        vector<T> V1 (9 * stride + 4, T (-1));
+
+        analyticEigenSolverArray (
+            A.data (), S1.data (), V1.data (), n, stride);
+        verifyEigenArray (A, S1, V1, stride, T (100));
+
+        //
+        // The eigenvalues of both solvers agree.
+        //
+
+        for (size_t i = 0; i < n; ++i)
+            for (int k = 0; k < 3; ++k)
+                assert (
+                    std::abs (S[k * stride + i] - S1[k * stride + i]) <=
+                    computeThreshold (A[i]) * 10);
+
+        //
+        // With an executor, the planes have a stride of n.
+        //
+
+        vector<T> S2 (3 * n + 4, T (-1));
+        vector<T> V2 (9 * n + 4, T (-1));
+
+        jacobiEigenSolverArray (
+            A.data (), S2.data (), V2.data (), n, reverseChunks (5));
+        verifyEigenArray (A, S2, V2, n, T (100));
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            for (int k = 0; k < 3; ++k)
+                assert (S2[k * n + i] == S[k * stride + i]);
+
+            for (int k = 0; k < 9; ++k)
+                assert (V2[k * n + i] == V[k * stride + i]);
+        }
+
+        vector<T> S3 (3 * n + 4, T (-1));
+        vector<T> V3 (9 * n + 4, T (-1));
+
+        analyticEigenSolverArray (
+            A.data (), S3.data (), V3.data (), n, reverseChunks (5));
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            for (int k = 0; k < 3; ++k)
+                assert (S3[k * n + i] == S1[k * stride + i]);
+
+            for (int k = 0; k < 9; ++k)
+                assert (V3[k * n + i] == V1[k * stride + i]);
+        }
+    }
+}
+
 void
 testJacobiEigenSolver ()
 {
@@ -282,6 +458,14 @@ testJacobiEigenSolver ()
     testMinMaxEigenValueImp<double> ();
     cout << "PASS" << endl;
 
+    cout << "EigenSolver arrays in single precision...";
+    testEigenSolverArrays<float> ();
+    cout << "PASS" << endl;
+
+    cout << "EigenSolver arrays in double precision...";
+    testEigenSolverArrays<double> ();
+    cout << "PASS" << endl;
+
     cout << "Timing Jacobi EigenSolver in single precision...\n";
     testJacobiTiming<float> ();
 
@@ -7,6 +7,7 @@
 #    undef NDEBUG
 #endif
 
+#include "testHelpers.h"
 #include "testMatrix.h"
 #include <ImathInt64.h>
 #include <ImathMath.h>
@@ -14,9 +15,13 @@
 #include <ImathMatrixAlgo.h>
 #include <ImathRandom.h>
 #include <ImathVec.h>
+#include <algorithm>
 #include <assert.h>
+#include <cmath>
 #include <iostream>
+#include <limits>
 #include <sstream>
+#include <vector>
 
 // Include ImathForward *after* other headers to validate forward declarations
 #include <ImathForward.h>
@@ -56,6 +61,295 @@ testMatrix44ArrayConstructor(const float a[4][4])
 }
 
 
+//
+// The array forms of multVecMatrix() and multDirMatrix() must give
+// exactly the results of the single-vector forms.
+//
+
+template <class M, class V>
+void
+testTransformArray (const M& m, IMATH_INTERNAL_NAMESPACE::Rand32& rand)
+{
+    typedef typename V::BaseType S;
+
+    const size_t lengths[] = {0, 1, 2, 3, 4, 5, 7, 8, 9, 17, 100};
+
+    for (size_t n: lengths)
+    {
+        vector<V> src (n + 1), dst (n + 1), ref (n);
+
+        for (size_t i = 0; i < n + 1; ++i)
+            for (unsigned j = 0; j < V::dimensions (); ++j)
+                src[i][j] = S (rand.nextf (-100, 100));
+
+        // vectors
+
+        dst[n] = V (S (-7));
+        m.multVecMatrix (src.data (), dst.data (), n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            m.multVecMatrix (src[i], ref[i]);
+            assert (dst[i] == ref[i]);
+        }
+
+        assert (dst[n] == V (S (-7)));
+
+        // in place
+
+        dst = src;
+        m.multVecMatrix (dst.data (), dst.data (), n);
+
+        for (size_t i = 0; i < n; ++i)
+            assert (dst[i] == ref[i]);
+
+        // directions
+
+        dst[n] = V (S (-7));
+        m.multDirMatrix (src.data (), dst.data (), n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            m.multDirMatrix (src[i], ref[i]);
+            assert (dst[i] == ref[i]);
+        }
+
+        assert (dst[n] == V (S (-7)));
+    }
+}
+
+void
+testTransformArrays ()
+{
+    cout << "array multVecMatrix and multDirMatrix" << endl;
+
+    using namespace IMATH_INTERNAL_NAMESPACE;
+
+    Rand32 rand (3);
+
+    M44d projective (
+        0.9, 0.2, -0.1, 0.01,
+        -0.3, 1.1, 0.4, -0.02,
+        0.2, -0.5, 0.8, 0.03,
+        12, -7, 3, 1.5);
+
+    M44d affine = projective;
+    affine[0][3] = affine[1][3] = affine[2][3] = 0;
+    affine[3][3] = 1;
+
+    testTransformArray<M44f, V3f> (M44f (projective), rand);
+    testTransformArray<M44f, V3f> (M44f (affine), rand);
+    testTransformArray<M44d, V3d> (projective, rand);
+    testTransformArray<M44d, V3d> (affine, rand);
+    testTransformArray<M44d, V3f> (projective, rand);
+    testTransformArray<M44d, V3f> (affine, rand);
+
+    M33d projective33 (0.9, 0.2, 0.01, -0.3, 1.1, -0.02, 12, -7, 1.5);
+
+    M33d affine33 = projective33;
+    affine33[0][2] = affine33[1][2] = 0;
+    affine33[2][2] = 1;
+
+    testTransformArray<M33f, V2f> (M33f (projective33), rand);
+    testTransformArray<M33f, V2f> (M33f (affine33), rand);
+    testTransformArray<M33d, V2d> (projective33, rand);
+    testTransformArray<M33d, V2d> (affine33, rand);
+}
+
+//
+// multiplyMatrixArray() must give exactly the results of operator*,
+// and inverseMatrixArray() nearly those of inverse(), and find the
+// matrices that cannot be inverted.
+//
+
+template <class T>
+void
+testMatrixArray (IMATH_INTERNAL_NAMESPACE::Rand32& rand)
+{
+    using namespace IMATH_INTERNAL_NAMESPACE;
+
+    const size_t n = 100;
+
+    vector<Matrix44<T>> a (n + 1), b (n + 1), c (n + 1);
+
+    for (size_t i = 0; i < n + 1; ++i)
+    {
+        a[i] = randomMatrix<T> (rand);
+        b[i] = randomMatrix<T> (rand);
+
+        //
+        // Make some of the matrices affine, to exercise both paths
+        // of inverse().
+        //
+
+        if (i % 3 == 0)
+        {
+            a[i][0][3] = a[i][1][3] = a[i][2][3] = 0;
+            a[i][3][3]                           = 1;
+        }
+    }
+
+    // multiplication
+
+    c[n] = Matrix44<T> (T (-7));
+    multiplyMatrixArray (a.data (), b.data (), c.data (), n);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (c[i] == a[i] * b[i]);
+
+    assert (c[n] == Matrix44<T> (T (-7)));
+
+    c = a;
+    multiplyMatrixArray (c.data (), b.data (), c.data (), n);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (c[i] == a[i] * b[i]);
+
+    // inversion
+
+    const T e = std::numeric_limits<T>::epsilon () * 1000;
+
+    c[n] = Matrix44<T> (T (-7));
+    inverseMatrixArray (a.data (), c.data (), n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Matrix44<T> ref = a[i].inverse ();
+        T           s   = 1;
+
+        for (int j = 0; j < 4; ++j)
+            for (int k = 0; k < 4; ++k)
+                s = std::max (s, std::abs (ref[j][k]));
+
+        assert (c[i].equalWithAbsError (ref, e * s));
+        assert ((a[i] * c[i]).equalWithAbsError (Matrix44<T> (), e * s));
+    }
+
+    assert (c[n] == Matrix44<T> (T (-7)));
+
+    vector<Matrix44<T>> inverses = c;
+
+    c = a;
+    inverseMatrixArray (c.data (), c.data (), n);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (c[i] == inverses[i]);
+
+    // singular matrices give the identity
+
+    Matrix44<T> singular[3] = {
+        Matrix44<T> (T (0)),
+        Matrix44<T> (1, 2, 3, 4, 2, 4, 6, 8, 0, 1, 0, 1, 1, 0, 0, 1),
+        Matrix44<T> (1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 5, 6, 7, 1)};
+
+    inverseMatrixArray (singular, singular, 3);
+
+    for (int i = 0; i < 3; ++i)
+        assert (singular[i] == Matrix44<T> ());
+
+    //
+    // The status of every matrix is reported, whatever its position
+    // in the array, and singular matrices are still replaced by the
+    // identity.
+    //
+
+    for (size_t m = 0; m < 40; ++m)
+    {
+        vector<Matrix44<T>> src (m), dst (m + 1);
+        vector<char>        expected (m);
+        bool                status[40];
+        size_t              count = 0;
+
+        for (size_t i = 0; i < m; ++i)
+        {
+            src[i]      = a[i];
+            expected[i] = (i * 7 + m) % 5 == 0;
+
+            if (expected[i])
+            {
+                src[i][2][0] = src[i][2][1] = src[i][2][2] = src[i][2][3] = 0;
+                count++;
+            }
+        }
+
+        dst[m] = Matrix44<T> (T (-7));
+
+        assert (inverseMatrixArray (src.data (), dst.data (), m, status) == count);
+
+        for (size_t i = 0; i < m; ++i)
+        {
+            assert (status[i] == bool (expected[i]));
+
+            if (expected[i])
+                assert (dst[i] == Matrix44<T> ());
+            else
+                assert (dst[i] == inverses[i]);
+        }
+
+        assert (dst[m] == Matrix44<T> (T (-7)));
+
+        assert (inverseMatrixArray (src.data (), src.data (), m, 0) == count);
+    }
+
+    Matrix44<T> nan;
+    nan[1][2] = std::numeric_limits<T>::quiet_NaN ();
+    bool status;
+
+    inverseMatrixArray (&nan, &nan, 1, &status);
+    assert (status && nan == Matrix44<T> ());
+
+    //
+    // Whether a matrix can be inverted depends on its cofactors
+    // relative to its determinant, not on the size of the
+    // determinant alone: a matrix with a determinant too small to
+    // have a finite reciprocal can be inverted, and a matrix whose
+    // inverse overflows cannot.
+    //
+
+    const T tiny = T (sizeof (T) == sizeof (float) ? 1e-20 : 1e-160);
+    const T huge = T (sizeof (T) == sizeof (float) ? 1e20 : 1e200);
+
+    Matrix44<T> small[2] = {
+        Matrix44<T> (tiny, 0, 0, 0, 0, tiny, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1),
+        Matrix44<T> (tiny, 0, 0, 0, 0, tiny, 0, 0, 0, 0, 1, 0, 0, 0, 1, 2)};
+    Matrix44<T> large (
+        huge, 0, 0, 0, 0, huge, 0, 0, 0, 0, huge, 0, 0, 0, 0, 1);
+    Matrix44<T> result[2];
+    bool        flags[2];
+
+    //
+    // The determinant, tiny * tiny, is subnormal, and is rounded to a
+    // multiple of the smallest subnormal number.
+    //
+
+    const T subnormalError =
+        std::numeric_limits<T>::denorm_min () / (tiny * tiny) * 4;
+
+    assert (inverseMatrixArray (small, result, 2, flags) == 0);
+
+    for (int i = 0; i < 2; ++i)
+    {
+        Matrix44<T> ref = small[i].inverse (true);
+
+        assert (!flags[i]);
+        assert (result[i].equalWithRelError (ref, std::max (e, subnormalError)));
+    }
+
+    assert (inverseMatrixArray (&large, result, 1, flags) == 1);
+    assert (flags[0] && result[0] == Matrix44<T> ());
+}
+
+void
+testMatrixArrays ()
+{
+    cout << "array multiplication and inversion" << endl;
+
+    IMATH_INTERNAL_NAMESPACE::Rand32 rand (5);
+
+    testMatrixArray<float> (rand);
+    testMatrixArray<double> (rand);
+}
+
 void
 testMatrix ()
 {
@@ -990,5 +1284,8 @@ testMatrix ()
         }
     }
 
+    testTransformArrays ();
+    testMatrixArrays ();
+
     cout << "ok\n" << endl;
 }
@@ -0,0 +1,262 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "testHelpers.h"
+#include "testMatrixExpr.h"
+#include <ImathMatrix.h>
+#include <ImathMatrixExpr.h>
+#include <ImathRandom.h>
+#include <ImathVec.h>
+#include <assert.h>
+#include <iostream>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+template <class T, class S>
+bool
+close (const Vec3<S>& a, const Vec3<S>& b, T scale)
+{
+    T e = T (1000) * numeric_limits<S>::epsilon () * scale;
+    return (a - b).length () <= e;
+}
+
+//
+// lazy() accepts M unless it is deleted for M.
+//
+
+template <class M, class = void> struct LazyAccepts : false_type
+{};
+
+template <class M>
+struct LazyAccepts<M, decltype ((void) lazy (declval<M> ()))> : true_type
+{};
+
+static_assert (LazyAccepts<M44f&>::value, "lazy of an lvalue");
+static_assert (!LazyAccepts<M44f>::value, "lazy of a temporary");
+
+//
+// A * B is valid unless operator* is deleted for A and B.
+//
+
+template <class A, class B, class = void> struct Multiplies : false_type
+{};
+
+template <class A, class B>
+struct Multiplies<A, B, decltype ((void) (declval<A> () * declval<B> ()))>
+    : true_type
+{};
+
+typedef MatrixChain44<float, 1> ChainF;
+
+static_assert (Multiplies<ChainF, M44f&>::value, "append an lvalue");
+static_assert (!Multiplies<ChainF, M44f>::value, "append a temporary");
+static_assert (Multiplies<M44f&, ChainF>::value, "prepend an lvalue");
+static_assert (!Multiplies<M44f, ChainF>::value, "prepend a temporary");
+static_assert (Multiplies<ChainF, ChainF>::value, "concatenate chains");
+
+template <class T>
+void
+testChains (Rand32& rand)
+{
+    Matrix44<T> a = randomMatrix<T> (rand);
+    Matrix44<T> b = randomMatrix<T> (rand);
+    Matrix44<T> c = randomMatrix<T> (rand);
+    Matrix44<T> d = randomMatrix<T> (rand);
+
+    //
+    // Folding a chain gives exactly the result of operator*,
+    // however the chain was put together.
+    //
+
+    Matrix44<T> ab   = a * b;
+    Matrix44<T> abcd = a * b * c * d;
+
+    assert (Matrix44<T> (lazy (a)) == a);
+    assert (lazy (a).evaluate () == a);
+    assert (Matrix44<T> (lazy (a) * b) == ab);
+    assert (Matrix44<T> (a * lazy (b)) == ab);
+    assert (Matrix44<T> (lazy (a) * b * c * d) == abcd);
+    assert (Matrix44<T> (a * lazy (b) * c * d) == abcd);
+    assert (Matrix44<T> ((lazy (a) * b) * (lazy (c) * d)) == abcd);
+
+    static_assert (
+        decltype (lazy (a) * b * c * d)::length () == 4, "chain length");
+
+    //
+    // The same operand may appear more than once.
+    //
+
+    assert (Matrix44<T> (lazy (a) * a * a) == a * a * a);
+
+    Matrix44<T> e = lazy (a) * b * c * d;
+    assert (e == abcd);
+
+    //
+    // Vectors are passed through the operands, which matches the
+    // folded product up to rounding.
+    //
+
+    T scale = 0;
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j)
+            scale = std::max (scale, T (std::abs (abcd[i][j])));
+
+    for (int i = 0; i < 100; ++i)
+    {
+        Vec3<T> v (
+            T (rand.nextf (-1, 1)),
+            T (rand.nextf (-1, 1)),
+            T (rand.nextf (-1, 1)));
+
+        Vec3<T> p, q;
+        abcd.multVecMatrix (v, p);
+        q = v * (lazy (a) * b * c * d);
+
+        //
+        // Points whose homogeneous coordinate is near zero are too
+        // sensitive to rounding to compare.
+        //
+
+        Vec4<T> h = Vec4<T> (v.x, v.y, v.z, 1) * abcd;
+        if (std::abs (h.w) > T (0.1) * scale)
+            assert (close (p, q, scale / std::abs (h.w) * scale));
+
+        Vec3<T> r = v;
+        r *= lazy (a) * b * c * d;
+        assert (r == q);
+
+        abcd.multDirMatrix (v, p);
+        (lazy (a) * b * c * d).multDirMatrix (v, q);
+        assert (close (p, q, scale));
+
+        Vec4<T> w (v.x, v.y, v.z, T (rand.nextf (-1, 1)));
+        Vec4<T> x = w * abcd;
+        Vec4<T> y = w * (lazy (a) * b * c * d);
+        assert ((x - y).length () <= T (1000) * numeric_limits<T>::epsilon () *
+                                         scale);
+
+        Vec4<T> z = w;
+        z *= lazy (a) * b * c * d;
+        assert (z == y);
+    }
+
+    //
+    // A single operand transforms exactly as the matrix does.
+    //
+
+    Vec3<T> v (T (0.25), T (-0.5), T (0.75)), p;
+    a.multVecMatrix (v, p);
+    assert (v * lazy (a) == p);
+}
+
+template <class T>
+void
+testArrays (Rand32& rand)
+{
+    Matrix44<T> a = randomMatrix<T> (rand);
+    Matrix44<T> b = randomMatrix<T> (rand);
+    Matrix44<T> c = randomMatrix<T> (rand);
+
+    //
+    // Make the product nearly affine, so that no point has a
+    // homogeneous coordinate near zero.
+    //
+
+    for (int i = 0; i < 3; ++i)
+    {
+        a[i][3] *= T (0.01);
+        b[i][3] *= T (0.01);
+        c[i][3] *= T (0.01);
+    }
+
+    a[3][3] = b[3][3] = c[3][3] = 1;
+
+    Matrix44<T> abc = a * b * c;
+
+    T scale = 0;
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j)
+            scale = std::max (scale, T (std::abs (abc[i][j])));
+
+    for (size_t n = 0; n < 12; ++n)
+    {
+        vector<Vec3<T>> src (n + 1), dst (n + 1), ref (n);
+
+        for (size_t i = 0; i < n; ++i)
+            src[i] = Vec3<T> (
+                T (rand.nextf (-1, 1)),
+                T (rand.nextf (-1, 1)),
+                T (rand.nextf (-1, 1)));
+
+        //
+        // The element after the last must be left alone.
+        //
+
+        const Vec3<T> sentinel (T (7), T (8), T (9));
+        dst[n] = sentinel;
+
+        (lazy (a) * b * c).multVecMatrix (src.data (), dst.data (), n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            abc.multVecMatrix (src[i], ref[i]);
+            assert (close (dst[i], ref[i], scale * scale));
+        }
+
+        assert (dst[n] == sentinel);
+
+        (lazy (a) * b * c).multDirMatrix (src.data (), dst.data (), n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            abc.multDirMatrix (src[i], ref[i]);
+            assert (close (dst[i], ref[i], scale));
+        }
+
+        assert (dst[n] == sentinel);
+
+        //
+        // In place
+        //
+
+        vector<Vec3<T>> tmp (src);
+        (lazy (a) * b * c).multVecMatrix (tmp.data (), tmp.data (), n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            abc.multVecMatrix (src[i], ref[i]);
+            assert (close (tmp[i], ref[i], scale * scale));
+        }
+    }
+}
+
+} // namespace
+
+void
+testMatrixExpr ()
+{
+    cout << "Testing lazy matrix chains" << endl;
+
+    Rand32 rand (17);
+
+    testChains<float> (rand);
+    testChains<double> (rand);
+    testArrays<float> (rand);
+    testArrays<double> (rand);
+
+    cout << "ok\n" << endl;
+}
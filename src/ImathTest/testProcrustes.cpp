@@ -10,6 +10,7 @@
 #include <ImathEuler.h>
 #include <ImathMatrixAlgo.h>
 #include <ImathRandom.h>
+#include <algorithm>
 #include <assert.h>
 #include <cmath>
 #include <iostream>
@@ -286,6 +287,187 @@ testProcrustesWithMatrix (const IMATH_INTERNAL_NAMESPACE::M44d& m)
     std::cout << "OK\n";
 }
 
+// Verify that accumulating the points in chunks, and merging
+// accumulators, gives the same transformation as computing it from all
+// the points at once:
+template <typename T>
+void
+testProcrustesAccumulator ()
+{
+    std::cout << "Testing Procrustes accumulator" << std::endl;
+    typedef IMATH_INTERNAL_NAMESPACE::Vec3<T> Vec;
+
+    IMATH_INTERNAL_NAMESPACE::ProcrustesAccumulator empty;
+    assert (empty.numPoints () == 0);
+    assert (empty.result () == IMATH_INTERNAL_NAMESPACE::M44d ());
+    assert (empty.result (true) == IMATH_INTERNAL_NAMESPACE::M44d ());
+
+    IMATH_INTERNAL_NAMESPACE::Rand48 random (5);
+    IMATH_INTERNAL_NAMESPACE::M44d   m;
+    m.translate (IMATH_INTERNAL_NAMESPACE::V3d (1000.0, -2000.0, 500.0));
+    m.rotate (IMATH_INTERNAL_NAMESPACE::V3d (0.3, -1.2, 2.0));
+    m.scale (IMATH_INTERNAL_NAMESPACE::V3d (1.5, 1.5, 1.5));
+
+    const size_t     numPoints = 1000;
+    std::vector<Vec> from, to;
+    std::vector<T>   weights;
+
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+        // Points far from the origin, as in a scan:
+        const IMATH_INTERNAL_NAMESPACE::V3d a (
+            random.nextf (1e4, 1e4 + 10),
+            random.nextf (-10, 10),
+            random.nextf (-10, 10));
+
+        from.push_back (Vec (a));
+        to.push_back (Vec (
+            a * m + IMATH_INTERNAL_NAMESPACE::V3d (
+                        random.nextf (-0.01, 0.01),
+                        random.nextf (-0.01, 0.01),
+                        random.nextf (-0.01, 0.01))));
+        weights.push_back (T (random.nextf (0.5, 2)));
+    }
+
+    for (int weighted = 0; weighted < 2; ++weighted)
+    {
+        const T* w = weighted ? &weights[0] : 0;
+
+        for (int doScale = 0; doScale < 2; ++doScale)
+        {
+            const IMATH_INTERNAL_NAMESPACE::M44d expected =
+                procrustesRotationAndTranslation (
+                    &from[0], &to[0], w, numPoints, doScale != 0);
+
+            // All the points at once:
+            IMATH_INTERNAL_NAMESPACE::ProcrustesAccumulator all;
+            all.add (&from[0], &to[0], w, numPoints);
+            assert (all.result (doScale != 0) == expected);
+            assert (all.numPoints () == numPoints);
+
+            // Empty accumulators merged on either side:
+            IMATH_INTERNAL_NAMESPACE::ProcrustesAccumulator merged;
+            merged.merge (all);
+            merged.merge (empty);
+            assert (merged.result (doScale != 0) == expected);
+
+            // In chunks, into two accumulators that are merged, as
+            // two threads would:
+            const size_t chunkSizes[] = {1, 7, 64, 333};
+
+            for (size_t chunkSize: chunkSizes)
+            {
+                IMATH_INTERNAL_NAMESPACE::ProcrustesAccumulator a, b;
+
+                for (size_t i = 0; i < numPoints; i += chunkSize)
+                {
+                    const size_t n = std::min (chunkSize, numPoints - i);
+
+                    IMATH_INTERNAL_NAMESPACE::ProcrustesAccumulator& acc =
+                        (i / chunkSize) % 2 ? b : a;
+
+                    if (w)
+                        acc.add (&from[i], &to[i], w + i, n);
+                    else
+                        acc.add (&from[i], &to[i], n);
+                }
+
+                a.merge (b);
+                assert (a.numPoints () == numPoints);
+                assert (
+                    std::abs (a.weightsSum () - all.weightsSum ()) <=
+                    1e-12 * all.weightsSum ());
+
+                const IMATH_INTERNAL_NAMESPACE::M44d result =
+                    a.result (doScale != 0);
+
+                for (int j = 0; j < 4; ++j)
+                    for (int k = 0; k < 4; ++k)
+                        assert (
+                            std::abs (result[j][k] - expected[j][k]) <=
+                            1e-9 * (j == 3 ? 1e4 : 1));
+            }
+
+            all.clear ();
+            assert (all.numPoints () == 0);
+            assert (all.result () == IMATH_INTERNAL_NAMESPACE::M44d ());
+        }
+    }
+
+    // Chunks whose weights cancel keep their moments, so they combine
+    // with the points added after them as in a single add():
+    {
+        const size_t   n = 10;
+        std::vector<T> cancelling (3 * n, T (1));
+        for (size_t i = n; i < 2 * n; ++i)
+            cancelling[i] = T (-1);
+
+        for (int doScale = 0; doScale < 2; ++doScale)
+        {
+            IMATH_INTERNAL_NAMESPACE::ProcrustesAccumulator a, b;
+            a.add (&from[0], &to[0], &cancelling[0], n);
+            b.add (&from[n], &to[n], &cancelling[n], n);
+            a.merge (b);
+
+            assert (a.numPoints () == 2 * n);
+            assert (a.weightsSum () == 0);
+            assert (
+                a.result (doScale != 0) == IMATH_INTERNAL_NAMESPACE::M44d ());
+
+            a.add (&from[2 * n], &to[2 * n], &cancelling[2 * n], n);
+            assert (a.numPoints () == 3 * n);
+
+            const IMATH_INTERNAL_NAMESPACE::M44d expected =
+                procrustesRotationAndTranslation (
+                    &from[0], &to[0], &cancelling[0], 3 * n, doScale != 0);
+            const IMATH_INTERNAL_NAMESPACE::M44d result =
+                a.result (doScale != 0);
+
+            for (int j = 0; j < 4; ++j)
+                for (int k = 0; k < 4; ++k)
+                    assert (
+                        std::abs (result[j][k] - expected[j][k]) <=
+                        1e-9 * (j == 3 ? 1e4 : 1));
+        }
+    }
+
+    // A chunk whose weights sum to zero, then one whose weights do
+    // not: x, y, z rotated to y, -x, z with weights 1, -1, 1.
+    {
+        const Vec A[] = {Vec (1, 0, 0), Vec (0, 1, 0), Vec (0, 0, 1)};
+        const Vec B[] = {Vec (0, 1, 0), Vec (-1, 0, 0), Vec (0, 0, 1)};
+        const T   w[] = {T (1), T (-1), T (1)};
+
+        const IMATH_INTERNAL_NAMESPACE::M44d expected =
+            procrustesRotationAndTranslation (A, B, w, 3);
+        assert (expected != IMATH_INTERNAL_NAMESPACE::M44d ());
+
+        IMATH_INTERNAL_NAMESPACE::ProcrustesAccumulator a, b, c;
+        a.add (A, B, w, 2);
+        a.add (A + 2, B + 2, w + 2, 1);
+
+        b.add (A, B, w, 1);
+        c.add (A + 1, B + 1, w + 1, 1);
+        b.merge (c);
+        assert (b.weightsSum () == 0);
+        c.clear ();
+        c.add (A + 2, B + 2, w + 2, 1);
+        b.merge (c);
+
+        const IMATH_INTERNAL_NAMESPACE::M44d ra = a.result ();
+        const IMATH_INTERNAL_NAMESPACE::M44d rb = b.result ();
+
+        for (int j = 0; j < 4; ++j)
+            for (int k = 0; k < 4; ++k)
+            {
+                assert (std::abs (ra[j][k] - expected[j][k]) <= 1e-12);
+                assert (std::abs (rb[j][k] - expected[j][k]) <= 1e-12);
+            }
+    }
+
+    std::cout << "  OK\n";
+}
+
 template <typename T>
 void
 testProcrustesImp ()
@@ -407,6 +589,7 @@ testProcrustesImp ()
 
     m.scale (IMATH_INTERNAL_NAMESPACE::Vec3<T> (1, 1, 0));
     testProcrustesWithMatrix<T> (m);
+    testProcrustesAccumulator<T> ();
 }
 
 void
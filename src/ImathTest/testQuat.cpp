@@ -7,14 +7,17 @@
 #    undef NDEBUG
 #endif
 
+#include "testHelpers.h"
 #include "testQuat.h"
 #include <ImathFun.h>
 #include <ImathMatrixAlgo.h>
 #include <ImathPlatform.h>
 #include <ImathQuat.h>
+#include <ImathRandom.h>
 #include <cassert>
 #include <cmath>
 #include <iostream>
+#include <vector>
 
 // Include ImathForward *after* other headers to validate forward declarations
 #include <ImathForward.h>
@@ -268,6 +271,237 @@ testQuatConversions ()
     }
 }
 
+//
+// rotateArray() and multiplyArray() against the scalar operators, for
+// array sizes that cover whole and partial groups of SIMD lanes, and
+// in place
+//
+
+template <class T>
+void
+testQuatArraysT ()
+{
+    const T e = 4 * std::numeric_limits<T>::epsilon ();
+
+    Rand48 rand (7);
+
+    for (size_t n = 0; n <= maxArraySize; n = nextArraySize (n))
+    {
+        vector<Quat<T>> q1 (n + 1), q2 (n + 1), qd (n + 1);
+        vector<Vec3<T>> src (n + 1), vd (n + 1), inPlace (n + 1);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            q1[i] = randomQuat<T> (rand);
+            q2[i] = Quat<T> (
+                T (rand.nextf (-1, 1)),
+                T (rand.nextf (-1, 1)),
+                T (rand.nextf (-1, 1)),
+                T (rand.nextf (-1, 1)));
+            src[i] = Vec3<T> (
+                T (rand.nextf (-10, 10)),
+                T (rand.nextf (-10, 10)),
+                T (rand.nextf (-10, 10)));
+        }
+
+        //
+        // The element after the last is a sentinel, which must not be
+        // written
+        //
+
+        const Vec3<T> vSentinel (17, 18, 19);
+        const Quat<T> qSentinel (17, 18, 19, 20);
+
+        vd[n] = inPlace[n] = vSentinel;
+        qd[n]              = qSentinel;
+
+        //
+        // One quaternion
+        //
+
+        const Quat<T> q = n ? q1[0] : Quat<T> ();
+        const Matrix33<T> m = q.toMatrix33 ();
+
+        rotateArray (q, src.data (), vd.data (), n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            assert (vd[i].equalWithAbsError (src[i] * q, 10 * e));
+            assert (vd[i].equalWithAbsError (src[i] * m, 100 * e));
+            assert (vd[i].equalWithAbsError (q.rotateVector (src[i]), 100 * e));
+        }
+
+        inPlace = src;
+        inPlace[n] = vSentinel;
+        rotateArray (q, inPlace.data (), inPlace.data (), n);
+
+        for (size_t i = 0; i < n; ++i)
+            assert (inPlace[i] == vd[i]);
+
+        assert (vd[n] == vSentinel && inPlace[n] == vSentinel);
+
+        //
+        // One quaternion per vector
+        //
+
+        rotateArray (q1.data (), src.data (), vd.data (), n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            assert (vd[i].equalWithAbsError (src[i] * q1[i], 10 * e));
+            assert (vd[i].equalWithAbsError (src[i] * q1[i].toMatrix33 (), 100 * e));
+        }
+
+        inPlace = src;
+        inPlace[n] = vSentinel;
+        rotateArray (q1.data (), inPlace.data (), inPlace.data (), n);
+
+        for (size_t i = 0; i < n; ++i)
+            assert (inPlace[i] == vd[i]);
+
+        assert (vd[n] == vSentinel && inPlace[n] == vSentinel);
+
+        //
+        // Products, which need not be of unit quaternions
+        //
+
+        multiplyArray (q1.data (), q2.data (), qd.data (), n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            const Quat<T> p = q1[i] * q2[i];
+            assert (equalWithAbsError (qd[i].r, p.r, e));
+            assert (qd[i].v.equalWithAbsError (p.v, e));
+        }
+
+        assert (qd[n] == qSentinel);
+
+        multiplyArray (q1.data (), q2.data (), q2.data (), n);
+
+        for (size_t i = 0; i < n; ++i)
+            assert (q2[i] == qd[i]);
+    }
+}
+
+template <class T>
+bool
+sameQuat (const Quat<T>& a, const Quat<T>& b)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        if (!(a[i] == b[i] || (std::isnan (a[i]) && std::isnan (b[i]))))
+            return false;
+    }
+
+    return true;
+}
+
+//
+// toMatrix33Array(), toMatrix44Array() and extractQuatArray() against
+// the functions for single objects. extractQuatArray() must select
+// the same one of extractQuat()'s four cases, so the matrices include
+// rotations by nearly a half turn about each axis, where the trace is
+// negative, and matrices that are not rotations at all.
+//
+
+template <class T>
+void
+testQuatMatrixArraysT ()
+{
+    Rand48 rand (11);
+
+    for (size_t n = 0; n <= maxArraySize; n = nextArraySize (n))
+    {
+        vector<Quat<T>>     q (n + 1), qd (n + 1);
+        vector<Matrix33<T>> m33 (n + 1);
+        vector<Matrix44<T>> m44 (n + 1);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            Vec3<T> axis = hollowSphereRand<Vec3<T>> (rand);
+            T       angle = T (rand.nextf (-M_PI, M_PI));
+
+            if (i % 8 < 3)
+            {
+                axis[i % 8] += 10;
+                angle = T (M_PI) - T (0.01) * angle;
+            }
+
+            q[i].setAxisAngle (axis.normalized (), angle);
+
+            if (i % 4 == 0) q[i] = -q[i];
+        }
+
+        const Matrix33<T> m33Sentinel (T (17));
+        const Matrix44<T> m44Sentinel (T (17));
+        const Quat<T>     qSentinel (17, 18, 19, 20);
+
+        m33[n] = m33Sentinel;
+        m44[n] = m44Sentinel;
+        qd[n]  = qSentinel;
+
+        toMatrix33Array (q.data (), m33.data (), n);
+        toMatrix44Array (q.data (), m44.data (), n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            assert (m33[i] == q[i].toMatrix33 ());
+            assert (m44[i] == q[i].toMatrix44 ());
+        }
+
+        assert (m33[n] == m33Sentinel && m44[n] == m44Sentinel);
+
+        //
+        // Some matrices that are not rotations, among them the zero
+        // matrix and one with a NaN
+        //
+
+        for (size_t i = 5; i < n; i += 7)
+        {
+            for (int a = 0; a < 3; ++a)
+            {
+                for (int b = 0; b < 3; ++b)
+                    m44[i][a][b] = m33[i][a][b] = T (rand.nextf (-2, 2));
+            }
+        }
+
+        if (n > 6)
+        {
+            m33[6] = Matrix33<T> (T (0));
+            m44[6] = Matrix44<T> (m33[6], Vec3<T> (0));
+        }
+
+        if (n > 13)
+        {
+            m44[13][1][1] = m33[13][1][1] =
+                std::numeric_limits<T>::quiet_NaN ();
+        }
+
+        extractQuatArray (m44.data (), qd.data (), n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            assert (sameQuat (qd[i], extractQuat (m44[i])));
+
+            if (i % 7 != 5 && i != 6 && i != 13)
+                assert (qd[i].toMatrix44 ().equalWithAbsError (
+                    m44[i], 10 * std::numeric_limits<T>::epsilon ()));
+        }
+
+        assert (qd[n] == qSentinel);
+
+        extractQuatArray (m33.data (), qd.data (), n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            assert (sameQuat (
+                qd[i], extractQuat (Matrix44<T> (m33[i], Vec3<T> (0)))));
+        }
+
+        assert (qd[n] == qSentinel);
+    }
+}
+
 } // namespace
 
 void
@@ -278,6 +512,10 @@ testQuat ()
     testQuatT<float> ();
     testQuatT<double> ();
     testQuatConversions ();
+    testQuatArraysT<float> ();
+    testQuatArraysT<double> ();
+    testQuatMatrixArraysT<float> ();
+    testQuatMatrixArraysT<double> ();
 
     cout << "ok\n" << endl;
 }
@@ -7,12 +7,14 @@
 #    undef NDEBUG
 #endif
 
+#include "testHelpers.h"
 #include "testQuatSlerp.h"
 #include <ImathQuat.h>
 #include <ImathRandom.h>
 #include <assert.h>
 #include <iostream>
 #include <math.h>
+#include <vector>
 
 using namespace std;
 using namespace IMATH_INTERNAL_NAMESPACE;
@@ -153,6 +155,216 @@ randomRotations ()
     }
 }
 
+template <class T>
+T
+distance (const Quat<T>& q1, const Quat<T>& q2)
+{
+    Quat<T> d = q1 - q2;
+    return std::sqrt (d ^ d);
+}
+
+template <class T>
+void
+testArrays ()
+{
+    cout << "  slerpArray, squadArray and slerpSegmentArray for "
+         << (sizeof (T) == 4 ? "float" : "double") << endl;
+
+    //
+    // The array functions may evaluate the trigonometric functions
+    // differently from slerp(), which is ill-conditioned when q1 and
+    // q2 are nearly opposite; keep the inputs in the same hemisphere,
+    // where the results should agree to a few ulps, times the
+    // amplification of extrapolating beyond [0, 1]. Include lengths
+    // that exercise the partial SIMD groups, and parameters outside
+    // [0, 1], some beyond the range of the approximations.
+    //
+
+    const T e = 16 * std::numeric_limits<T>::epsilon ();
+
+    Rand48 rand (17);
+    T      maxError = 0;
+
+    for (size_t n = 0; n <= maxArraySize; n = nextArraySize (n))
+    {
+        vector<Quat<T>> q1 (n), q2 (n), qa (n), qb (n), dst (n);
+        vector<T>       t (n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            q1[i] = randomQuat<T> (rand);
+            q2[i] = randomQuat<T> (rand);
+            qa[i] = randomQuat<T> (rand);
+            qb[i] = randomQuat<T> (rand);
+            t[i]  = T (rand.nextf (-0.5, 1.5));
+
+            if (i % 17 == 3) t[i] = T (rand.nextf (-200, 200));
+        }
+
+        slerpShortestArcArray (&q1[0], &q2[0], &t[0], &dst[0], n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            T d = distance (dst[i], slerpShortestArc (q1[i], q2[i], t[i]));
+            maxError = std::max (maxError, d);
+            assert (d <= e * (1 + std::abs (t[i])));
+        }
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            if ((q1[i] ^ q2[i]) < 0) q2[i] = -q2[i];
+            if ((q1[i] ^ qa[i]) < 0) qa[i] = -qa[i];
+            if ((q1[i] ^ qb[i]) < 0) qb[i] = -qb[i];
+        }
+
+        slerpArray (&q1[0], &q2[0], &t[0], &dst[0], n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            T d = distance (dst[i], slerp (q1[i], q2[i], t[i]));
+            maxError = std::max (maxError, d);
+            assert (d <= e * (1 + std::abs (t[i])));
+        }
+
+        //
+        // squad() is likewise ill-conditioned where qa and qb, or the
+        // results of the inner slerps, are nearly opposite, and
+        // extrapolating amplifies the errors of the inner slerps.
+        //
+
+        squadArray (&q1[0], &qa[0], &qb[0], &q2[0], &t[0], &dst[0], n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            Quat<T> r1 = slerp (q1[i], q2[i], t[i]);
+            Quat<T> r2 = slerp (qa[i], qb[i], t[i]);
+
+            if ((qa[i] ^ qb[i]) < T (0.1) || (r1 ^ r2) < T (0.1)) continue;
+
+            T d = distance (dst[i], squad (q1[i], qa[i], qb[i], q2[i], t[i]));
+            maxError = std::max (maxError, d);
+            T w = 2 * t[i] * (1 - t[i]);
+            assert (d <= e * (1 + std::abs (t[i])) * (1 + std::abs (w)));
+        }
+
+        vector<SlerpSegment<T>> segments (n + 1);
+        vector<int>             index (n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            segments[i + 1] = SlerpSegment<T> (q1[i], q2[i]);
+            index[i]        = int (rand.nexti () % (n + 1));
+        }
+
+        slerpSegmentArray (&segments[0], &index[0], &t[0], &dst[0], n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            T d = distance (dst[i], segments[index[i]](t[i]));
+            maxError = std::max (maxError, d);
+            assert (d <= e * (1 + std::abs (t[i])));
+        }
+
+        //
+        // dst may be one of the inputs
+        //
+
+        vector<Quat<T>> r (q1);
+        slerpArray (&q1[0], &q2[0], &t[0], &dst[0], n);
+        slerpArray (&r[0], &q2[0], &t[0], &r[0], n);
+
+        for (size_t i = 0; i < n; ++i)
+            assert (distance (r[i], dst[i]) == 0);
+    }
+
+    cout << "    max error " << maxError << endl;
+
+    //
+    // A segment from a quaternion to itself, and the default segment
+    //
+
+    Quat<T>         q = randomQuat<T> (rand);
+    SlerpSegment<T> s (q, q);
+
+    assert (s.angle == 0 && s.invSinc == 1);
+    assert (distance (s (T (0.3)), q) <= e);
+    assert (SlerpSegment<T> () (T (0.7)) == Quat<T> ());
+}
+
+//
+// The angle of the rotation between two unit quaternions
+//
+
+template <class T>
+long double
+rotationAngle (const Quat<T>& q1, const Quat<long double>& q2)
+{
+    Quat<long double> q (q1.r, q1.v.x, q1.v.y, q1.v.z);
+    q.normalize ();
+
+    if ((q ^ q2) < 0) q = -q;
+
+    return 4 * std::atan2 (distance (q, q2), distance (q, -q2));
+}
+
+template <class T>
+void
+testFast ()
+{
+    cout << "  slerpShortestArcFast for "
+         << (sizeof (T) == 4 ? "float" : "double") << endl;
+
+    //
+    // Measure the rotation between slerpShortestArcFast() and an
+    // accurate slerp, for angles between the quaternions over the full
+    // range, up to a half turn, at each end of which the correction
+    // is largest.
+    //
+
+    Rand48      rand (41);
+    long double maxError      = 0;
+    long double maxNlerpError = 0;
+
+    for (int i = 0; i <= 400; ++i)
+    {
+        T angle = T (i < 400 ? M_PI * i / 400 : M_PI);
+
+        Quat<T> q1 = randomQuat<T> (rand);
+        Quat<T> r;
+        r.setAxisAngle (hollowSphereRand<Vec3<T>> (rand), angle);
+
+        Quat<T> q2 = rand.nextf () < 0.5 ? q1 * r : -(q1 * r);
+
+        Quat<long double> p1 (q1.r, q1.v.x, q1.v.y, q1.v.z);
+        Quat<long double> p2 (q2.r, q2.v.x, q2.v.y, q2.v.z);
+
+        for (int j = 0; j <= 100; ++j)
+        {
+            T t = T (j) / 100;
+
+            Quat<long double> s = slerpShortestArc (p1, p2, (long double) t);
+            Quat<T>           q = slerpShortestArcFast (q1, q2, t);
+
+            maxError = std::max (maxError, rotationAngle (q, s));
+
+            Quat<T> n = (q1 ^ q2) < 0 ? nlerp (q1, -q2, t) : nlerp (q1, q2, t);
+            maxNlerpError = std::max (maxNlerpError, rotationAngle (n, s));
+        }
+
+        assert (slerpShortestArcFast (q1, q2, T (0)) == q1.normalized ());
+    }
+
+    cout << "    max error " << maxError << " radians, nlerp "
+         << maxNlerpError << endl;
+
+    //
+    // The documented bound, and the rounding of float
+    //
+
+    assert (maxError < (sizeof (T) == 4 ? 6.2e-5 : 6.1e-5));
+    assert (maxNlerpError > 0.14 && maxNlerpError < 0.143);
+}
+
 } // namespace
 
 void
@@ -162,6 +374,10 @@ testQuatSlerp ()
 
     specificRotations ();
     randomRotations ();
+    testArrays<float> ();
+    testArrays<double> ();
+    testFast<float> ();
+    testFast<double> ();
 
     cout << "ok\n" << endl;
 }
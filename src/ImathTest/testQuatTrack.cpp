@@ -0,0 +1,246 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "testQuatTrack.h"
+#include <ImathQuat.h>
+#include <ImathQuatTrack.h>
+#include <ImathRandom.h>
+#include <assert.h>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+// Include ImathForward *after* other headers to validate forward declarations
+#include <ImathForward.h>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+template <class T>
+T
+distance (const Quat<T>& q1, const Quat<T>& q2)
+{
+    Quat<T> d = q1 - q2;
+    return std::sqrt (d ^ d);
+}
+
+//
+// A random animation curve: keys at irregular times, each a moderate
+// rotation away from the one before it, with random signs
+//
+
+template <class T>
+void
+randomKeys (Rand48& rand, int n, vector<T>& times, vector<Quat<T>>& keys)
+{
+    times.resize (n);
+    keys.resize (n);
+
+    Quat<T> q;
+    T       time = T (rand.nextf (-10, 10));
+
+    for (int i = 0; i < n; ++i)
+    {
+        Quat<T> step;
+        step.setAxisAngle (
+            hollowSphereRand<Vec3<T>> (rand), T (rand.nextf (0, 2)));
+
+        q        = (q * step).normalized ();
+        keys[i]  = rand.nextf () < 0.5 ? q : -q;
+        times[i] = time;
+        time += T (rand.nextf (0.1, 3));
+    }
+}
+
+//
+// The reference value of a track, from the functions in ImathQuat.h
+//
+
+template <class T>
+Quat<T>
+reference (const QuatTrack<T>& track, T time)
+{
+    const int n = track.size ();
+
+    if (n == 0) return Quat<T> ();
+    if (!(time > track.time (0))) return track.key (0);
+    if (time >= track.time (n - 1)) return track.key (n - 1);
+
+    int k = 0;
+
+    while (time >= track.time (k + 1))
+        ++k;
+
+    T u = (time - track.time (k)) / (track.time (k + 1) - track.time (k));
+
+    if (track.interpolation () == QuatTrack<T>::LINEAR)
+        return slerp (track.key (k), track.key (k + 1), u);
+
+    return spline (
+        track.key (std::max (k - 1, 0)),
+        track.key (k),
+        track.key (k + 1),
+        track.key (std::min (k + 2, n - 1)),
+        u);
+}
+
+template <class T>
+void
+testSampling (Rand48& rand, typename QuatTrack<T>::Interpolation interpolation)
+{
+    const T e = 64 * std::numeric_limits<T>::epsilon ();
+
+    for (int n = 0; n < 40; n += n < 5 ? 1 : 11)
+    {
+        vector<T>       times;
+        vector<Quat<T>> keys;
+        randomKeys (rand, n, times, keys);
+
+        QuatTrack<T> track (times.data (), keys.data (), n, interpolation);
+
+        assert (track.size () == n);
+        assert (track.interpolation () == interpolation);
+
+        //
+        // The keys are moved into the hemisphere of their predecessors
+        //
+
+        for (int i = 0; i < n; ++i)
+        {
+            assert (track.time (i) == times[i]);
+            assert (track.key (i) == keys[i] || track.key (i) == -keys[i]);
+            assert (i == 0 || (track.key (i - 1) ^ track.key (i)) >= 0);
+        }
+
+        //
+        // Single samples, at the keys and between them
+        //
+
+        T start = n ? times[0] - 2 : -2;
+        T end   = n ? times[n - 1] + 2 : 2;
+
+        for (int i = 0; i < n; ++i)
+            assert (distance (track.sample (times[i]), track.key (i)) <= e);
+
+        for (int i = 0; i < 200; ++i)
+        {
+            T time = T (rand.nextf (start, end));
+            Quat<T> q = reference (track, time);
+            assert (distance (track.sample (time), q) <= e);
+        }
+
+        //
+        // Arrays of samples, unsorted, and at regular intervals
+        //
+
+        const size_t    m = 1000;
+        vector<T>       sampleTimes (m);
+        vector<Quat<T>> samples (m);
+
+        for (size_t i = 0; i < m; ++i)
+            sampleTimes[i] = T (rand.nextf (start, end));
+
+        track.sample (&sampleTimes[0], &samples[0], m);
+
+        for (size_t i = 0; i < m; ++i)
+        {
+            Quat<T> q = track.sample (sampleTimes[i]);
+            assert (distance (samples[i], q) <= e);
+        }
+
+        T step = (end - start) / T (m - 1);
+        track.resample (start, step, &samples[0], m);
+
+        for (size_t i = 0; i < m; ++i)
+        {
+            Quat<T> q = track.sample (start + T (i) * step);
+            assert (distance (samples[i], q) <= e);
+        }
+    }
+}
+
+template <class T>
+void
+testKeys ()
+{
+    Quat<T> q1 (T (0.5), T (0.5), T (0.5), T (0.5));
+    Quat<T> q2 (0, 1, 0, 0);
+    Quat<T> keys[] = {q1, -q2, q1};
+    T       times[] = {0, 1, 2};
+
+    //
+    // Without shortestArc, the keys are kept as they are
+    //
+
+    QuatTrack<T> shortest (times, keys, 3);
+    QuatTrack<T> direct (times, keys, 3, QuatTrack<T>::LINEAR, false);
+
+    assert (shortest.key (1) == q2 && shortest.key (2) == q1);
+    assert (direct.key (1) == -q2 && direct.key (2) == q1);
+
+    const T e = 4 * std::numeric_limits<T>::epsilon ();
+
+    assert (distance (shortest.sample (T (0.5)), slerp (q1, q2, T (0.5))) <= e);
+    assert (distance (direct.sample (T (0.5)), slerp (q1, -q2, T (0.5))) <= e);
+
+    //
+    // Empty and constant tracks, and a NaN time
+    //
+
+    QuatTrack<T> empty;
+    QuatTrack<T> constant (times, keys, 1, QuatTrack<T>::SPLINE);
+    Quat<T>      q[3];
+
+    assert (empty.size () == 0 && empty.sample (1) == Quat<T> ());
+    assert (constant.sample (-1) == q1 && constant.sample (5) == q1);
+
+    constant.resample (0, 1, q, 3);
+    assert (q[0] == q1 && q[1] == q1 && q[2] == q1);
+
+    empty.sample (times, q, 3);
+    assert (q[0] == Quat<T> () && q[2] == Quat<T> ());
+
+    assert (shortest.sample (std::numeric_limits<T>::quiet_NaN ()) == q1);
+
+    //
+    // The times must be increasing
+    //
+
+    T badTimes[] = {0, 1, 1};
+
+    try
+    {
+        QuatTrack<T> track (badTimes, keys, 3);
+        assert (false);
+    }
+    catch (const std::invalid_argument&)
+    {}
+}
+
+} // namespace
+
+void
+testQuatTrack ()
+{
+    cout << "Testing QuatTrack" << endl;
+
+    Rand48 rand (29);
+
+    testSampling<float> (rand, QuatTrackf::LINEAR);
+    testSampling<float> (rand, QuatTrackf::SPLINE);
+    testSampling<double> (rand, QuatTrackd::LINEAR);
+    testSampling<double> (rand, QuatTrackd::SPLINE);
+    testKeys<float> ();
+    testKeys<double> ();
+
+    cout << "ok\n" << endl;
+}
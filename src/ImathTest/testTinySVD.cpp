@@ -8,11 +8,14 @@
 #endif
 
 #include <ImathMatrixAlgo.h>
+#include <ImathRandom.h>
 #include <algorithm>
 #include <assert.h>
 #include <cmath>
+#include <ctime>
 #include <iostream>
 #include <limits>
+#include <vector>
 
 template <typename T>
 void
@@ -52,10 +55,84 @@ verifyOrthonormal (const IMATH_INTERNAL_NAMESPACE::Matrix44<T>& A)
     }
 }
 
+// fastSVD() and polarDecomposition() are only available in single
+// precision:
+template <typename T>
+void
+verifyFastSVD (const IMATH_INTERNAL_NAMESPACE::Matrix33<T>&)
+{}
+
+void
+verifyFastSVD (const IMATH_INTERNAL_NAMESPACE::M33f& A)
+{
+    float maxEntry = 0;
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            maxEntry = std::max (maxEntry, std::abs (A[i][j]));
+
+    const float eps      = std::numeric_limits<float>::epsilon ();
+    const float valueEps = maxEntry * 30 * eps;
+
+    IMATH_INTERNAL_NAMESPACE::M33f U, V;
+    IMATH_INTERNAL_NAMESPACE::V3f  S;
+    IMATH_INTERNAL_NAMESPACE::fastSVD (A, U, S, V);
+
+    // Verify that the product of the matrices is A:
+    IMATH_INTERNAL_NAMESPACE::M33f MS (0.0f);
+    for (int i = 0; i < 3; ++i)
+        MS[i][i] = S[i];
+
+    const IMATH_INTERNAL_NAMESPACE::M33f product = U * MS * V.transposed ();
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            assert (std::abs (product[i][j] - A[i][j]) <= valueEps);
+
+    // Verify that U and V are rotations:
+    verifyOrthonormal (U);
+    verifyOrthonormal (V);
+    assert (U.determinant () > 0.9f);
+    assert (V.determinant () > 0.9f);
+
+    // Verify that only the last singular value is negative:
+    assert (S[0] >= 0 && S[1] >= 0);
+
+    // Verify that the singular values agree with jacobiSVD():
+    IMATH_INTERNAL_NAMESPACE::M33f U1, V1;
+    IMATH_INTERNAL_NAMESPACE::V3f  S1;
+    IMATH_INTERNAL_NAMESPACE::jacobiSVD (A, U1, S1, V1, eps, true);
+
+    for (int i = 0; i < 3; ++i)
+        assert (std::abs (S[i] - S1[i]) <= valueEps);
+
+    // Verify the polar decomposition:
+    IMATH_INTERNAL_NAMESPACE::M33f R, P;
+    IMATH_INTERNAL_NAMESPACE::polarDecomposition (A, R, P);
+
+    verifyOrthonormal (R);
+    assert (R.determinant () > 0.9f);
+    assert (P == P.transposed ());
+
+    const IMATH_INTERNAL_NAMESPACE::M33f RP = R * P;
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            assert (std::abs (RP[i][j] - A[i][j]) <= valueEps);
+
+    // Verify that the array versions give identical results:
+    IMATH_INTERNAL_NAMESPACE::M33f U2, V2, R2, P2;
+    IMATH_INTERNAL_NAMESPACE::V3f  S2;
+    IMATH_INTERNAL_NAMESPACE::fastSVDArray (&A, &U2, &S2, &V2, 1);
+    IMATH_INTERNAL_NAMESPACE::polarDecompositionArray (&A, &R2, &P2, 1);
+
+    assert (U2 == U && S2 == S && V2 == V);
+    assert (R2 == R && P2 == P);
+}
+
 template <typename T>
 void
 verifyTinySVD_3x3 (const IMATH_INTERNAL_NAMESPACE::Matrix33<T>& A)
 {
+    verifyFastSVD (A);
+
     T maxEntry = 0;
     for (int i = 0; i < 3; ++i)
         for (int j = 0; j < 3; ++j)
@@ -346,6 +423,9 @@ testTinySVDImp ()
     testTinySVD_3x3<T> (0, T(-1.00000003e-22), 0, T(1.00000001e-07), 0, 0, 0, 0, 0);
     // problematic 2x2 one for lapack on suse (see below), padded with 0's and 1
     testTinySVD_3x3<T> (0, T(-1.00000003e-22), 0, T(1.00000001e-07), 0, 0, 0, 0, 1);
+    // rank 1, with the other singular values too small to rotate out
+    testTinySVD_3x3<T> (1, 0, 0, 0, T(-1e-25), 0, 0, 0, 0);
+    testTinySVD_3x3<T> (2, 0, 0, 0, T(-1e-25), 0, 0, 0, T(-1e-26));
 
     // Now, 4x4 matrices:
     testTinySVD_4x4<T> (1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1);
@@ -387,12 +467,106 @@ testTinySVDImp ()
             IMATH_INTERNAL_NAMESPACE::Vec4<T> (1, 2, 3, 3)));
 }
 
+// Compare the array versions of fastSVD() and polarDecomposition()
+// with the single versions on random matrices, and the speed of
+// fastSVD() with jacobiSVD():
+void
+testFastSVDArrays ()
+{
+    std::cout << "Testing fastSVD arrays" << std::endl;
+
+    IMATH_INTERNAL_NAMESPACE::Rand48            rand (7);
+    std::vector<IMATH_INTERNAL_NAMESPACE::M33f> A;
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        IMATH_INTERNAL_NAMESPACE::M33f m;
+        for (int j = 0; j < 3; ++j)
+            for (int k = 0; k < 3; ++k)
+                m[j][k] = float (rand.nextf (-1, 1));
+
+        // Rank-deficient matrices:
+        if (i % 5 == 0)
+            for (int k = 0; k < 3; ++k)
+                m[2][k] = m[0][k] * 0.5f - m[1][k] * 0.25f;
+
+        A.push_back (m);
+    }
+
+    for (size_t n = 0; n < 40; ++n)
+    {
+        const IMATH_INTERNAL_NAMESPACE::M33f sentinel (-1.0f);
+
+        std::vector<IMATH_INTERNAL_NAMESPACE::M33f> U (n + 1, sentinel);
+        std::vector<IMATH_INTERNAL_NAMESPACE::M33f> V (n + 1, sentinel);
+        std::vector<IMATH_INTERNAL_NAMESPACE::M33f> R (n + 1, sentinel);
+        std::vector<IMATH_INTERNAL_NAMESPACE::M33f> P (n + 1, sentinel);
+        std::vector<IMATH_INTERNAL_NAMESPACE::V3f>  S (
+            n + 1, IMATH_INTERNAL_NAMESPACE::V3f (-1.0f));
+
+        fastSVDArray (&A[0], &U[0], &S[0], &V[0], n);
+        polarDecompositionArray (&A[0], &R[0], &P[0], n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            IMATH_INTERNAL_NAMESPACE::M33f u, v, r, p;
+            IMATH_INTERNAL_NAMESPACE::V3f  s;
+            fastSVD (A[i], u, s, v);
+            polarDecomposition (A[i], r, p);
+
+            assert (U[i] == u && S[i] == s && V[i] == v);
+            assert (R[i] == r && P[i] == p);
+        }
+
+        assert (U[n] == sentinel && V[n] == sentinel);
+        assert (R[n] == sentinel && P[n] == sentinel);
+        assert (S[n] == IMATH_INTERNAL_NAMESPACE::V3f (-1.0f));
+    }
+
+    for (size_t i = 0; i < A.size (); ++i)
+        verifyFastSVD (A[i]);
+
+    const size_t n = A.size ();
+    const int    rounds (50);
+    clock_t      t;
+
+    std::vector<IMATH_INTERNAL_NAMESPACE::M33f> U (n), V (n);
+    std::vector<IMATH_INTERNAL_NAMESPACE::V3f>  S (n);
+
+    t = clock ();
+    for (int r = 0; r < rounds; ++r)
+        for (size_t i = 0; i < n; ++i)
+            jacobiSVD (
+                A[i],
+                U[i],
+                S[i],
+                V[i],
+                std::numeric_limits<float>::epsilon (),
+                true);
+    std::cout << "jacobiSVD    of 3x3 matrices took " << clock () - t
+              << " clocks." << std::endl;
+
+    t = clock ();
+    for (int r = 0; r < rounds; ++r)
+        for (size_t i = 0; i < n; ++i)
+            fastSVD (A[i], U[i], S[i], V[i]);
+    std::cout << "fastSVD      of 3x3 matrices took " << clock () - t
+              << " clocks." << std::endl;
+
+    t = clock ();
+    for (int r = 0; r < rounds; ++r)
+        fastSVDArray (&A[0], &U[0], &S[0], &V[0], n);
+    std::cout << "fastSVDArray of 3x3 matrices took " << clock () - t
+              << " clocks." << std::endl;
+}
+
 void
 testTinySVD ()
 {
     std::cout << "Testing TinySVD algorithms in single precision..."
               << std::endl;
     testTinySVDImp<float> ();
+    testFastSVDArrays ();
 
     std::cout << "Testing TinySVD algorithms in double precision..."
               << std::endl;
@@ -153,5 +153,22 @@ testToFloat ()
         }
     }
 
+#if !defined(IMATH_HALF_NO_LOOKUP_TABLE)
+
+    //
+    // The compact table must reproduce the full table exactly,
+    // including the NAN significands.
+    //
+
+    for (unsigned int s = 0; s < iMax; s++)
+    {
+        imath_half_uif_t v;
+        v.f = imath_half_to_float_compact ((imath_half_bits_t) s);
+
+        assert (v.i == imath_half_to_float_table[s].i);
+    }
+
+#endif
+
     std::cout << "ok" << std::endl;
 }
@@ -0,0 +1,337 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "testHelpers.h"
+#include "testTransformHierarchy.h"
+#include <ImathMatrix.h>
+#include <ImathRandom.h>
+#include <ImathTransformHierarchy.h>
+#include <assert.h>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+// Include ImathForward *after* other headers to validate forward declarations
+#include <ImathForward.h>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+template <class T>
+Matrix44<T>
+randomTransform (Rand32& rand)
+{
+    Matrix44<T> m;
+
+    m.rotate (Vec3<T> (
+        T (rand.nextf (-3, 3)), T (rand.nextf (-3, 3)), T (rand.nextf (-3, 3))));
+    m.scale (Vec3<T> (
+        T (rand.nextf (0.5, 2)),
+        T (rand.nextf (0.5, 2)),
+        T (rand.nextf (0.5, 2))));
+    m[3][0] = T (rand.nextf (-10, 10));
+    m[3][1] = T (rand.nextf (-10, 10));
+    m[3][2] = T (rand.nextf (-10, 10));
+
+    return m;
+}
+
+//
+// The world matrices computed directly from the definition
+//
+
+template <class T>
+vector<Matrix44<T>>
+reference (const TransformHierarchy<T>& h)
+{
+    vector<Matrix44<T>> world (h.size ());
+
+    for (int i = 0; i < h.size (); ++i)
+    {
+        if (h.parent (i) == TransformHierarchy<T>::noParent)
+            world[i] = h.local (i);
+        else
+            world[i] = h.local (i) * world[h.parent (i)];
+    }
+
+    return world;
+}
+
+template <class T>
+bool
+matches (const TransformHierarchy<T>& h)
+{
+    vector<Matrix44<T>> world = reference (h);
+
+    for (int i = 0; i < h.size (); ++i)
+        if (h.world (i) != world[i]) return false;
+
+    return true;
+}
+
+template <class T>
+int
+subtreeSize (const TransformHierarchy<T>& h, int root)
+{
+    int n = 0;
+
+    for (int i = 0; i < h.size (); ++i)
+    {
+        int j = i;
+
+        while (j != root && j != TransformHierarchy<T>::noParent)
+            j = h.parent (j);
+
+        if (j == root) ++n;
+    }
+
+    return n;
+}
+
+template <class T>
+void
+buildRandom (TransformHierarchy<T>& h, Rand32& rand, int n)
+{
+    h.reserve (n);
+
+    for (int i = 0; i < n; ++i)
+    {
+        //
+        // A few roots, some long chains and some wide fans
+        //
+
+        int parent;
+
+        if (i == 0 || rand.nextf () < 0.05)
+            parent = TransformHierarchy<T>::noParent;
+        else if (rand.nextf () < 0.5)
+            parent = i - 1;
+        else
+            parent = int (rand.nexti () % i);
+
+        int k = h.addNode (parent, randomTransform<T> (rand));
+        assert (k == i);
+        assert (h.parent (k) == parent);
+        assert (
+            h.depth (k) ==
+            (parent == TransformHierarchy<T>::noParent ? 0
+                                                       : h.depth (parent) + 1));
+    }
+}
+
+template <class T>
+void
+testUpdate (Rand32& rand)
+{
+    const int             n = 300;
+    TransformHierarchy<T> a, b;
+
+    buildRandom (a, rand, n);
+    b = a;
+
+    assert (a.size () == n);
+    assert (a.changed ());
+    assert (a.world (n - 1) == Matrix44<T> ());
+
+    //
+    // The first update computes every node, serially or through an
+    // executor, with identical results.
+    //
+
+    assert (a.update () == n);
+    assert (b.update (reverseChunks (3)) == n);
+    assert (!a.changed () && !b.changed ());
+    assert (matches (a));
+    assert (matches (b));
+
+    assert (a.update () == 0);
+    assert (b.update (reverseChunks (3)) == 0);
+
+    //
+    // Later updates compute only the changed subtrees.
+    //
+
+    for (int iter = 0; iter < 20; ++iter)
+    {
+        int         k = int (rand.nexti () % n);
+        Matrix44<T> m = randomTransform<T> (rand);
+
+        a.setLocal (k, m);
+        b.setLocal (k, m);
+        assert (a.local (k) == m);
+        assert (a.changed ());
+
+        int expected = subtreeSize (a, k);
+
+        assert (a.update () == expected);
+        assert (b.update (reverseChunks (3)) == expected);
+        assert (matches (a));
+        assert (matches (b));
+    }
+
+    //
+    // Changing a node twice, or a node and one of its descendants,
+    // recomputes each node once.
+    //
+
+    int child = n - 1;
+    int root  = child;
+
+    while (a.parent (root) != TransformHierarchy<T>::noParent)
+        root = a.parent (root);
+
+    a.setLocal (child, randomTransform<T> (rand));
+    a.setLocal (root, randomTransform<T> (rand));
+    a.setLocal (root, randomTransform<T> (rand));
+
+    assert (a.update () == subtreeSize (a, root));
+    assert (matches (a));
+
+    //
+    // Nodes added after an update are computed by the next one.
+    //
+
+    int k = a.addNode (child, randomTransform<T> (rand));
+    b.addNode (child, randomTransform<T> (rand));
+    b.setLocal (k, a.local (k));
+
+    assert (a.update () == 1);
+    assert (b.update (reverseChunks (3)) == 1);
+    assert (matches (a));
+    assert (matches (b));
+}
+
+template <class T>
+void
+testInverses (Rand32& rand)
+{
+    const int             n = 100;
+    TransformHierarchy<T> a;
+
+    buildRandom (a, rand, n);
+    a.update ();
+
+    TransformHierarchy<T> b = a;
+
+    for (int i = 0; i < n; ++i)
+    {
+        assert (a.inverse (i) == a.world (i).inverse ());
+        assert (a.inverseTranspose (i) == a.world (i).inverse ().transposed ());
+    }
+
+    b.updateInverses (reverseChunks (3));
+
+    for (int i = 0; i < n; ++i)
+    {
+        assert (b.inverse (i) == a.inverse (i));
+        assert (b.inverseTranspose (i) == a.inverseTranspose (i));
+    }
+
+    //
+    // The cached inverses follow changes to the world matrices.
+    //
+
+    for (int iter = 0; iter < 10; ++iter)
+    {
+        int         k = int (rand.nexti () % n);
+        Matrix44<T> m = randomTransform<T> (rand);
+
+        a.setLocal (k, m);
+        b.setLocal (k, m);
+        a.update ();
+        b.update ();
+        b.updateInverses ();
+
+        for (int i = 0; i < n; ++i)
+        {
+            assert (a.inverseTranspose (i) ==
+                    a.world (i).inverse ().transposed ());
+            assert (a.inverse (i) == a.world (i).inverse ());
+            assert (b.inverse (i) == a.inverse (i));
+            assert (b.inverseTranspose (i) == a.inverseTranspose (i));
+        }
+    }
+
+    //
+    // A singular world matrix has the identity as its inverse.
+    //
+
+    Matrix44<T> zero;
+    zero.makeIdentity ();
+    zero[0][0] = 0;
+
+    a.setLocal (0, zero);
+    a.update ();
+    assert (a.inverse (0) == Matrix44<T> ());
+}
+
+template <class T>
+void
+testErrors ()
+{
+    TransformHierarchy<T> h;
+
+    try
+    {
+        h.addNode (0);
+        assert (false);
+    }
+    catch (const std::invalid_argument&)
+    {}
+
+    int r = h.addNode (TransformHierarchy<T>::noParent);
+    assert (r == 0);
+
+    try
+    {
+        h.addNode (-2);
+        assert (false);
+    }
+    catch (const std::invalid_argument&)
+    {}
+
+    try
+    {
+        h.addNode (1);
+        assert (false);
+    }
+    catch (const std::invalid_argument&)
+    {}
+
+    assert (h.size () == 1);
+
+    h.clear ();
+    assert (h.size () == 0);
+    assert (!h.changed ());
+    assert (h.update () == 0);
+    assert (h.update (reverseChunks (3)) == 0);
+}
+
+} // namespace
+
+void
+testTransformHierarchy ()
+{
+    cout << "Testing TransformHierarchy" << endl;
+
+    Rand32 rand (7);
+
+    testUpdate<float> (rand);
+    testUpdate<double> (rand);
+    testInverses<float> (rand);
+    testInverses<double> (rand);
+    testErrors<float> ();
+    testErrors<double> ();
+
+    cout << "ok\n" << endl;
+}
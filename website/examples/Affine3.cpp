@@ -0,0 +1,24 @@
+#include <Imath/ImathAffine.h>
+#include <Imath/ImathBoxAlgo.h>
+#include <cassert>
+
+void
+affine3_example ()
+{
+    Imath::M44f M;
+    M.rotate (Imath::V3f (0.0f, M_PI / 2, 0.0f));
+    M.translate (Imath::V3f (1.0f, 2.0f, 3.0f));
+
+    Imath::Affine3f A (M);
+    assert (A.toMatrix44 () == M);
+
+    Imath::V3f p = Imath::V3f (1.0f, 0.0f, 0.0f) * A;
+    assert (p == Imath::V3f (1.0f, 0.0f, 0.0f) * M);
+
+    Imath::Affine3f Ainv = A.inverse ();
+    assert ((p * Ainv).equalWithAbsError (Imath::V3f (1.0f, 0.0f, 0.0f), 1e-6f));
+
+    Imath::Box3f b (Imath::V3f (-1.0f), Imath::V3f (1.0f));
+    Imath::Box3f tb = Imath::transform (b, A);
+    assert (tb == Imath::affineTransform (b, M));
+}
@@ -3,6 +3,7 @@
 
 #include <iostream>
 
+void affine3_example ();
 void color3_example ();
 void color4_example ();
 void euler_example ();
@@ -26,6 +27,7 @@ main (int argc, char* argv[])
 {
     std::cout << "imath examples..." << std::endl;
 
+    affine3_example ();
     color3_example ();
     color4_example ();
     euler_example ();